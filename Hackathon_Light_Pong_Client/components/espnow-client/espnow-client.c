@@ -38,7 +38,29 @@ static void add_peer(const uint8_t mac[6]) {
     }
 }
 
+// Answer at once, the server takes half the round trip as the one-way latency
+static void reply_time_sync(const uint8_t* data) {
+    time_sync_t sync;
+    memcpy(&sync, data, sizeof(sync));
+    if (g_player_id == 0) {
+        return;
+    }
+
+    sync.paddle_us = esp_timer_get_time();
+    sync.type = MSG_TIME_SYNC_REPLY;
+    esp_err_t ret = esp_now_send(g_server_mac, (uint8_t*)&sync, sizeof(sync));
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to reply to time sync: %d", ret);
+    }
+}
+
 static void on_data_recv(const esp_now_recv_info_t* recv_info, const uint8_t* data, int data_len) {
+    // Only the type byte tells a time sync from another message of the same size
+    if (data_len == sizeof(time_sync_t) && data[0] == MSG_TIME_SYNC) {
+        reply_time_sync(data);
+        return;
+    }
+
     if (data_len == sizeof(server_assign_t)) {
         if (g_player_id != 0) {
             return;
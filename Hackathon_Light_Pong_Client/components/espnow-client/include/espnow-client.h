@@ -13,6 +13,7 @@
 #include "esp_mac.h"
 #include "esp_now.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "esp_wifi.h"
 #include "nvs_flash.h"
 #include "string.h"
@@ -21,6 +22,10 @@
 #define WIFI_READY_BIT BIT0
 #define SERVER_ASSIGNED_BIT BIT0
 
+// Message types
+#define MSG_TIME_SYNC 4       // Server clock sample
+#define MSG_TIME_SYNC_REPLY 5 // Same message returned with our clock
+
 typedef struct {
     uint8_t score_1;
     uint8_t score_2;
@@ -33,8 +38,17 @@ typedef struct {
     uint8_t btn_left_pressed;
     float ax, ay, az;
     float gx, gy, gz;
+    int64_t swing_us; // esp_timer time of the IMU sample that triggered the send
 } input_event_t;
 
+// Server measures link latency and our clock offset with these
+typedef struct {
+    uint8_t type;      // MSG_TIME_SYNC or MSG_TIME_SYNC_REPLY
+    uint8_t seq;       // Request number, echoed
+    int64_t server_us; // Server time when sent, echoed
+    int64_t paddle_us; // Our esp_timer time when replied
+} time_sync_t;
+
 typedef struct {
     uint8_t type;      // MSG_SERVER_ASSIGN
     uint8_t player_id; // Assigned player ID (1 or 2)
@@ -6,6 +6,7 @@
  */
 #include "button.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "espnow-client.h"
 #include "espnow-discovery.h"
 #include "freertos/FreeRTOS.h"
@@ -47,6 +48,7 @@ static void send_input_event(void) {
 
     input_event_t event;
     icm_read_accel_gyro(&event.ax, &event.ay, &event.az, &event.gx, &event.gy, &event.gz);
+    event.swing_us = esp_timer_get_time(); // the server judges the hit by this, not by arrival
 
     float mag = total_acceleration(event.ax, event.ay, event.az);
 
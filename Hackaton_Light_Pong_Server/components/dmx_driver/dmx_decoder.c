@@ -0,0 +1,77 @@
+/**
+ * @file dmx_decoder.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief DMX512 line decoder implementation
+ */
+
+#include "dmx_decoder.h"
+#include <string.h>
+
+void dmx_decoder_init(dmx_decoder_t *decoder, dmx_decoder_frame_cb_t on_frame, void *arg)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->on_frame = on_frame;
+    decoder->on_frame_arg = arg;
+}
+
+void dmx_decoder_flush(dmx_decoder_t *decoder)
+{
+    // A break with nothing after it is not a frame
+    if (!decoder->in_frame || decoder->received == 0)
+    {
+        decoder->in_frame = false;
+        return;
+    }
+
+    decoder->frame.slots = decoder->received - 1;
+    decoder->frames++;
+    if (decoder->on_frame != NULL)
+    {
+        decoder->on_frame(&decoder->frame, decoder->on_frame_arg);
+    }
+
+    decoder->in_frame = false;
+}
+
+void dmx_decoder_feed_break(dmx_decoder_t *decoder, int64_t timestamp_us, uint32_t break_us)
+{
+    dmx_decoder_flush(decoder);
+
+    decoder->in_frame = true;
+    decoder->received = 0;
+    decoder->frame.timestamp_us = timestamp_us;
+    decoder->frame.break_us = break_us;
+    decoder->frame.slots = 0;
+    decoder->frame.overrun = false;
+}
+
+void dmx_decoder_feed(dmx_decoder_t *decoder, const uint8_t *data, size_t length)
+{
+    if (!decoder->in_frame)
+    {
+        decoder->stray_bytes += length;
+        return;
+    }
+
+    size_t space = sizeof(decoder->frame.data) - decoder->received;
+    if (length > space)
+    {
+        decoder->frame.overrun = true;
+        length = space;
+    }
+
+    memcpy(&decoder->frame.data[decoder->received], data, length);
+    decoder->received += length;
+}
+
+void dmx_decoder_reset(dmx_decoder_t *decoder)
+{
+    if (decoder->in_frame)
+    {
+        decoder->resyncs++;
+    }
+
+    decoder->in_frame = false;
+    decoder->received = 0;
+}
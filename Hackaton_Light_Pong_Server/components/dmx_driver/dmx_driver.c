@@ -6,200 +6,1562 @@
  */
 
 #include "dmx_driver.h"
+#include "dmx_transport.h"
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
-#include "driver/uart.h"
-#include "driver/gpio.h"
 #include "esp_timer.h"
-#include "esp_rom_gpio.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "dmx_transport_uart.h"
+#endif
 
 static const char *TAG = "DMX";
 
-#define DMX_TX_BUFFER_SIZE 1024
-#define DMX_RX_BUFFER_SIZE 256 // Minimum required by UART driver (even in TX-only mode)
-#define DMX_TASK_STACK_SIZE 4096
 #define DMX_TASK_PRIORITY 5
 #define DMX_UPDATE_RATE_HZ 44 // Standard DMX refresh rate
 
+/* Frame hand-off between writers and the TX path (triple buffering) */
+#define DMX_FRAME_BUFFERS 3
+#define DMX_FRAME_INDEX_MASK 0x03
+#define DMX_FRAME_FRESH 0x80 // Ready slot holds a frame the TX path has not sent yet
+
+#define DMX_CPU_WINDOW_US 1000000 // Window for the TX blocked time measurement
+#define DMX_FULL_PERIOD_US (1000000 / DMX_UPDATE_RATE_HZ)
+#define DMX_FRAME_GAP_US 40 // Slack between the end of one frame and the next break
+#define DMX_GROUP_BREAK_SPACING_US (DMX_BREAK_US + DMX_MAB_US) // Minimum offset between frame starts in a group
+
+#define DMX_INPUT_HOLD_US ((int64_t)DMX_INPUT_HOLD_MS * 1000)
+
+struct dmx_group_t;
+
+/**
+ * @brief Upstream input merge state
+ *
+ * Received frames are handed from the receiver to the TX path with the same
+ * triple-buffer exchange as the output frames.
+ */
+typedef struct
+{
+    dmx_merge_mode_t mode;
+    uint8_t frames[DMX_FRAME_BUFFERS][DMX_UNIVERSE_SIZE + 1]; // Received universes
+    uint16_t frame_slots[DMX_FRAME_BUFFERS];
+    uint8_t back_idx;                         // Buffer filled by the receiver
+    uint8_t front_idx;                        // Buffer read by the TX path
+    _Atomic uint8_t ready;                    // Hand-off buffer index | DMX_FRAME_FRESH
+    uint8_t merged[DMX_UNIVERSE_SIZE + 1];    // Frame actually sent (TX path only)
+    uint8_t prev_input[DMX_UNIVERSE_SIZE + 1]; // Input values at the previous merge (LTP)
+    uint8_t prev_game[DMX_UNIVERSE_SIZE + 1];  // Game values at the previous merge (LTP)
+    uint8_t ltp_input[DMX_UNIVERSE_SIZE / 8];  // Channel was last changed by the input (LTP)
+    dmx_input_stats_t stats;                  // Guarded by the context's stats_lock
+} dmx_input_t;
+
 /**
  * @brief DMX driver context structure
  */
 typedef struct
 {
-    uart_port_t uart_num;
-    gpio_num_t tx_pin;
-    gpio_num_t rx_pin;
-    gpio_num_t enable_pin;
+    dmx_transport_t *transport;              // Puts bytes and breaks on the line
+    bool owns_transport;                     // Transport was created by dmx_init()
     uint16_t universe_size;
-    uint8_t *dmx_data;
-    SemaphoreHandle_t mutex;
-    TaskHandle_t tx_task_handle;
+    dmx_tx_mode_t tx_mode;
+    dmx_frame_mode_t frame_mode;
+    uint16_t patched_last;                   // Highest channel declared with dmx_patch()
+    uint8_t patched[DMX_UNIVERSE_SIZE / 8];  // Channels claimed with dmx_patch(), bit per channel
+    dmx_input_t *_Atomic input;              // Upstream merge, NULL when input is off
+    dmx_input_t *_Atomic input_busy;         // Input the TX path is sending from right now, or NULL
+    uint16_t written_last;                   // Highest channel ever written
+    uint16_t frame_slots[DMX_FRAME_BUFFERS]; // Slots to send for each buffer
+    uint16_t last_frame_slots;               // Slots in the most recently sent frame
+    int64_t frame_published_us[DMX_FRAME_BUFFERS]; // When each buffer was published
+    dmx_frame_info_t last_frame;             // Timing of the most recently sent frame
+    dmx_stats_t stats;                       // Output timing statistics
+    int64_t period_ref_us;                   // Previous frame start for period stats, 0 = none
+    portMUX_TYPE stats_lock;                 // Guards last_frame and stats
+    _Atomic bool frame_requested;            // dmx_request_frame() pending
+    int64_t request_us;                      // When the pending request was made
+    bool hw_break_primed;                    // First HW-break frame needs a leading break
+    uint32_t tx_blocked_us;                  // Time in the transport per second, over the last window
+    int64_t next_frame_us;                   // Regular cadence slot of the next frame
+    int64_t window_start_us;                 // Start of the current blocked-time window
+    uint32_t window_frames;                  // Frames sent in the current window
+    uint32_t window_blocked_us;              // Time spent in the transport in the current window
+    dmx_frame_cb_t frame_cb[DMX_FRAME_CALLBACKS_MAX]; // Per-frame callbacks (under stats_lock)
+    void *frame_cb_arg[DMX_FRAME_CALLBACKS_MAX];
+    uint8_t frame_cb_count;
+    uint8_t *frame_pool;                     // Backing storage for all frame buffers
+    uint8_t *frames[DMX_FRAME_BUFFERS];      // Start code + universe, one per buffer
+    uint8_t back_idx;                        // Buffer edited by writers (under mutex)
+    uint8_t front_idx;                       // Buffer owned by the TX path
+    _Atomic uint8_t ready;                   // Hand-off buffer index | DMX_FRAME_FRESH
+    uint16_t dirty_first;                    // First channel changed since last publish
+    uint16_t dirty_last;                     // Last channel changed since last publish (0 = clean)
+    SemaphoreHandle_t mutex;                 // Serialises writers, never held by TX
+    SemaphoreHandle_t tx_exited;             // Given by the TX task once it has left its loop
+    TaskHandle_t txn_owner;                  // Task inside dmx_begin()/dmx_commit(), or NULL
+    uint8_t txn_depth;                       // Nesting level of the open transaction
+    TaskHandle_t tx_task_handle;             // Own TX task, or the group scheduler task
+    esp_timer_handle_t tx_timer;             // Paces the TX task with microsecond resolution
+    struct dmx_group_t *group;               // Group scheduling this universe, or NULL
     bool is_running;
+    bool is_static;                          // Lives in dmx_static_t storage, nothing to free
+    StaticTask_t *task_buffer;               // TX task storage for static contexts, or NULL
+    StackType_t *task_stack;
 } dmx_context_t;
 
-/**
- * @brief Send DMX break signal
- */
-static esp_err_t dmx_send_break(dmx_context_t *ctx)
+/**
+ * @brief Layout of dmx_static_t.context
+ */
+typedef struct
+{
+    dmx_context_t ctx;
+#if !CONFIG_IDF_TARGET_LINUX
+    dmx_uart_transport_t uart; // Built-in transport, used when the config names none
+#endif
+} dmx_static_context_t;
+
+_Static_assert(sizeof(dmx_static_context_t) <= sizeof(((dmx_static_t *)0)->context),
+               "DMX_STATIC_CONTEXT_WORDS too small for the driver context");
+_Static_assert(DMX_FRAME_BUFFERS * (DMX_UNIVERSE_SIZE + 1) == DMX_FRAME_POOL_SIZE,
+               "DMX_FRAME_POOL_SIZE does not match the frame buffer count");
+
+/**
+ * @brief Universe group context
+ */
+struct dmx_group_t
+{
+    dmx_context_t *universes[DMX_GROUP_MAX_UNIVERSES];
+    size_t count;
+    int64_t last_start_us; // Start of the most recent frame on any universe
+    TaskHandle_t task_handle;
+    SemaphoreHandle_t task_exited; // Given by the scheduler task once it has left its loop
+    esp_timer_handle_t timer;
+    bool is_running;
+};
+
+/**
+ * @brief Histogram bucket for a duration: bucket i holds values below 4^(i+1) us
+ */
+static inline uint8_t dmx_stats_bucket(uint32_t us)
+{
+    uint8_t bucket = 0;
+    while (us >= 4 && bucket < DMX_STATS_HIST_BUCKETS - 1)
+    {
+        us >>= 2;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Reset statistics, must be called with stats_lock held or before the TX task runs
+ */
+static void dmx_stats_clear(dmx_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->period_min_us = UINT32_MAX;
+    stats->break_min_us = UINT32_MAX;
+}
+
+/**
+ * @brief Record how long a writer waited for the writer lock
+ */
+static void dmx_stats_mutex_wait(dmx_context_t *ctx, int64_t wait_start)
+{
+    uint32_t wait_us = (uint32_t)(esp_timer_get_time() - wait_start);
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    ctx->stats.mutex_waits++;
+    ctx->stats.mutex_wait_hist[dmx_stats_bucket(wait_us)]++;
+    if (wait_us > ctx->stats.mutex_wait_max_us)
+    {
+        ctx->stats.mutex_wait_max_us = wait_us;
+    }
+    portEXIT_CRITICAL(&ctx->stats_lock);
+}
+
+/**
+ * @brief Record a break length
+ */
+static void dmx_stats_break(dmx_context_t *ctx, uint32_t break_us)
+{
+    portENTER_CRITICAL(&ctx->stats_lock);
+    if (break_us < ctx->stats.break_min_us)
+    {
+        ctx->stats.break_min_us = break_us;
+    }
+    if (break_us > ctx->stats.break_max_us)
+    {
+        ctx->stats.break_max_us = break_us;
+    }
+    portEXIT_CRITICAL(&ctx->stats_lock);
+}
+
+/**
+ * @brief Count a frame that failed before its data was written
+ *
+ * No write took place, so the write time statistics are left alone.
+ */
+static void dmx_stats_frame_failed(dmx_context_t *ctx)
+{
+    portENTER_CRITICAL(&ctx->stats_lock);
+    ctx->stats.write_failed++;
+    portEXIT_CRITICAL(&ctx->stats_lock);
+}
+
+/**
+ * @brief Record the outcome and duration of a UART frame write
+ */
+static void dmx_stats_write(dmx_context_t *ctx, uint32_t write_us, int bytes_written, int frame_len)
+{
+    portENTER_CRITICAL(&ctx->stats_lock);
+    if (bytes_written < 0)
+    {
+        ctx->stats.write_failed++;
+    }
+    else if (bytes_written != frame_len)
+    {
+        ctx->stats.write_incomplete++;
+    }
+    if (write_us > ctx->stats.write_max_us)
+    {
+        ctx->stats.write_max_us = write_us;
+    }
+    ctx->stats.write_hist[dmx_stats_bucket(write_us)]++;
+    portEXIT_CRITICAL(&ctx->stats_lock);
+}
+
+/**
+ * @brief Number of slots the next published frame must carry
+ */
+static uint16_t dmx_frame_slots(const dmx_context_t *ctx)
+{
+    if (ctx->frame_mode == DMX_FRAME_FULL)
+    {
+        return ctx->universe_size;
+    }
+
+    uint16_t slots = (ctx->patched_last > ctx->written_last) ? ctx->patched_last : ctx->written_last;
+    return (slots > 0) ? slots : 1;
+}
+
+/**
+ * @brief Shortest allowed break-to-break time after a frame of the given length
+ */
+static uint32_t dmx_frame_min_spacing_us(uint16_t slots)
+{
+    uint32_t wire_us = DMX_BREAK_US + DMX_MAB_US + (slots + 1) * DMX_SLOT_US + DMX_FRAME_GAP_US;
+    return (wire_us > DMX_MIN_PACKET_US) ? wire_us : DMX_MIN_PACKET_US;
+}
+
+/**
+ * @brief Break-to-break period for a frame of the given length
+ */
+static uint32_t dmx_frame_period_us(const dmx_context_t *ctx, uint16_t slots)
+{
+    if (ctx->frame_mode == DMX_FRAME_FULL)
+    {
+        return DMX_FULL_PERIOD_US;
+    }
+
+    return dmx_frame_min_spacing_us(slots);
+}
+
+/**
+ * @brief Publish the back buffer to the TX path
+ *
+ * Must be called with ctx->mutex held. The back buffer is swapped into the
+ * hand-off slot in one atomic exchange, so the TX path always picks up a
+ * complete frame. The buffer handed back is brought up to date before
+ * writers continue editing it.
+ */
+static void dmx_publish(dmx_context_t *ctx)
+{
+    if (ctx->dirty_last == 0)
+    {
+        return;
+    }
+
+    if (ctx->dirty_last > ctx->written_last)
+    {
+        ctx->written_last = ctx->dirty_last;
+    }
+
+    uint8_t published = ctx->back_idx;
+    uint16_t slots = dmx_frame_slots(ctx);
+    ctx->frame_slots[published] = slots;
+    ctx->frame_published_us[published] = esp_timer_get_time();
+
+    uint8_t previous = atomic_exchange(&ctx->ready, published | DMX_FRAME_FRESH);
+
+    // Channels above the written high-water mark are zero in every buffer
+    ctx->back_idx = previous & DMX_FRAME_INDEX_MASK;
+    memcpy(ctx->frames[ctx->back_idx], ctx->frames[published], (size_t)ctx->written_last + 1);
+
+    ctx->dirty_first = 0;
+    ctx->dirty_last = 0;
+}
+
+/**
+ * @brief Record a changed channel range for the next publish
+ */
+static void dmx_mark_dirty(dmx_context_t *ctx, uint16_t first, uint16_t last)
+{
+    if (ctx->dirty_last == 0 || first < ctx->dirty_first)
+    {
+        ctx->dirty_first = first;
+    }
+    if (last > ctx->dirty_last)
+    {
+        ctx->dirty_last = last;
+    }
+}
+
+/**
+ * @brief Acquire write access to the back buffer
+ *
+ * Inside a transaction the calling task already holds the mutex, so nothing
+ * is taken. txn_owner can only equal the current task if that task set it,
+ * so the unlocked read is safe.
+ *
+ * @param in_txn Set to true when the caller is inside dmx_begin()/dmx_commit()
+ */
+static esp_err_t dmx_writer_lock(dmx_context_t *ctx, bool *in_txn)
+{
+    *in_txn = (ctx->txn_owner == xTaskGetCurrentTaskHandle());
+    if (*in_txn)
+    {
+        return ESP_OK;
+    }
+
+    int64_t wait_start = esp_timer_get_time();
+    if (xSemaphoreTake(ctx->mutex, portMAX_DELAY) != pdTRUE)
+    {
+        return ESP_FAIL;
+    }
+    dmx_stats_mutex_wait(ctx, wait_start);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Release write access, publishing the changes unless inside a transaction
+ */
+static void dmx_writer_unlock(dmx_context_t *ctx, bool in_txn)
+{
+    if (in_txn)
+    {
+        return;
+    }
+
+    dmx_publish(ctx);
+    xSemaphoreGive(ctx->mutex);
+}
+
+/**
+ * @brief Take the most recently published frame for transmission
+ *
+ * Only called from the TX path. Never blocks and never touches the writer mutex.
+ */
+static const uint8_t *dmx_acquire_front(dmx_context_t *ctx, uint16_t *slots)
+{
+    bool fresh = false;
+
+    if (atomic_load(&ctx->ready) & DMX_FRAME_FRESH)
+    {
+        uint8_t previous = atomic_exchange(&ctx->ready, ctx->front_idx);
+        ctx->front_idx = previous & DMX_FRAME_INDEX_MASK;
+        fresh = true;
+    }
+
+    *slots = ctx->frame_slots[ctx->front_idx];
+
+    int64_t now = esp_timer_get_time();
+    bool requested = atomic_exchange(&ctx->frame_requested, false);
+
+    uint32_t nominal_us = dmx_frame_period_us(ctx, ctx->last_frame.slots);
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    int64_t previous_start = ctx->period_ref_us;
+    ctx->period_ref_us = now;
+    ctx->stats.frames_sent++;
+    if (fresh)
+    {
+        ctx->stats.frames_fresh++;
+    }
+    if (requested)
+    {
+        // Early frames are short by design and would swamp the jitter histogram
+        ctx->stats.frames_requested++;
+    }
+    else if (previous_start != 0)
+    {
+        uint32_t period_us = (uint32_t)(now - previous_start);
+        uint32_t jitter_us = (period_us > nominal_us) ? period_us - nominal_us : nominal_us - period_us;
+
+        if (period_us < ctx->stats.period_min_us)
+        {
+            ctx->stats.period_min_us = period_us;
+        }
+        if (period_us > ctx->stats.period_max_us)
+        {
+            ctx->stats.period_max_us = period_us;
+        }
+        if (jitter_us > ctx->stats.jitter_max_us)
+        {
+            ctx->stats.jitter_max_us = jitter_us;
+        }
+        ctx->stats.jitter_hist[dmx_stats_bucket(jitter_us)]++;
+    }
+
+    ctx->last_frame.sequence++;
+    ctx->last_frame.start_us = now;
+    ctx->last_frame.published_us = ctx->frame_published_us[ctx->front_idx];
+    ctx->last_frame.requested_us = requested ? ctx->request_us : 0;
+    ctx->last_frame.slots = *slots;
+    ctx->last_frame.fresh = fresh;
+    portEXIT_CRITICAL(&ctx->stats_lock);
+
+    return ctx->frames[ctx->front_idx];
+}
+
+/**
+ * @brief Merge the most recent upstream frame into the outgoing frame
+ *
+ * Only called from the TX path. Patched channels keep the game value, the
+ * rest follow the merge mode. Returns the game frame unchanged while no
+ * recent input is available.
+ *
+ * @param game Game frame from dmx_acquire_front()
+ * @param slots Slots to send, raised to cover the input in truncated mode
+ */
+static const uint8_t *dmx_input_merge(dmx_context_t *ctx, dmx_input_t *in, const uint8_t *game, uint16_t *slots)
+{
+    if (atomic_load(&in->ready) & DMX_FRAME_FRESH)
+    {
+        uint8_t previous = atomic_exchange(&in->ready, in->front_idx);
+        in->front_idx = previous & DMX_FRAME_INDEX_MASK;
+    }
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    int64_t last_frame_us = in->stats.last_frame_us;
+    portEXIT_CRITICAL(&ctx->stats_lock);
+
+    if (last_frame_us == 0 || esp_timer_get_time() - last_frame_us > DMX_INPUT_HOLD_US)
+    {
+        return game;
+    }
+
+    const uint8_t *input = in->frames[in->front_idx];
+    uint16_t input_slots = in->frame_slots[in->front_idx];
+    uint16_t count = (input_slots > *slots) ? input_slots : *slots;
+
+    in->merged[0] = game[0];
+    for (uint16_t ch = 1; ch <= count; ch++)
+    {
+        uint8_t g = game[ch];
+        uint8_t i = (ch <= input_slots) ? input[ch] : 0;
+        uint8_t bit = (uint8_t)(1 << ((ch - 1) % 8));
+        uint8_t *ltp = &in->ltp_input[(ch - 1) / 8];
+
+        if (ctx->patched[(ch - 1) / 8] & bit)
+        {
+            in->merged[ch] = g;
+        }
+        else if (in->mode == DMX_MERGE_HTP)
+        {
+            in->merged[ch] = (i > g) ? i : g;
+        }
+        else
+        {
+            // A game change in the same frame as an input change wins
+            if (i != in->prev_input[ch])
+            {
+                *ltp |= bit;
+            }
+            if (g != in->prev_game[ch])
+            {
+                *ltp &= (uint8_t)~bit;
+            }
+            in->merged[ch] = (*ltp & bit) ? i : g;
+        }
+
+        in->prev_input[ch] = i;
+        in->prev_game[ch] = g;
+    }
+
+    *slots = count;
+    return in->merged;
+}
+
+/**
+ * @brief Receiver callback, hands a completed input frame to the TX path
+ */
+static void dmx_input_frame_cb(const dmx_decoded_frame_t *frame, void *arg)
+{
+    dmx_context_t *ctx = (dmx_context_t *)arg;
+    dmx_input_t *in = atomic_load(&ctx->input);
+
+    if (in == NULL)
+    {
+        return;
+    }
+
+    // Alternate start codes (RDM, text, SIP) carry no levels
+    if (frame->data[0] != 0x00)
+    {
+        portENTER_CRITICAL(&ctx->stats_lock);
+        in->stats.frames_ignored++;
+        portEXIT_CRITICAL(&ctx->stats_lock);
+        return;
+    }
+
+    uint16_t slots = (frame->slots > ctx->universe_size) ? ctx->universe_size : frame->slots;
+    memcpy(in->frames[in->back_idx], frame->data, slots + 1);
+    in->frame_slots[in->back_idx] = slots;
+
+    uint8_t previous = atomic_exchange(&in->ready, in->back_idx | DMX_FRAME_FRESH);
+    in->back_idx = previous & DMX_FRAME_INDEX_MASK;
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    in->stats.frames++;
+    if (frame->overrun)
+    {
+        in->stats.frames_overrun++;
+    }
+    in->stats.slots = slots;
+    in->stats.last_frame_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&ctx->stats_lock);
+}
+
+/**
+ * @brief Claim the input for one frame
+ *
+ * dmx_input_stop() doesn't free an input while it is claimed. Release it
+ * with dmx_input_release() once the merged frame has been written.
+ */
+static dmx_input_t *dmx_input_claim(dmx_context_t *ctx)
+{
+    dmx_input_t *in = atomic_load(&ctx->input);
+    atomic_store(&ctx->input_busy, in);
+
+    // Stopped between the load and the claim: the stop doesn't wait for this claim
+    if (in != NULL && atomic_load(&ctx->input) != in)
+    {
+        atomic_store(&ctx->input_busy, NULL);
+        return NULL;
+    }
+
+    return in;
+}
+
+static void dmx_input_release(dmx_context_t *ctx)
+{
+    atomic_store(&ctx->input_busy, NULL);
+}
+
+/**
+ * @brief Apply the upstream merge, if any, to a frame about to be sent
+ *
+ * Claims the input; the caller releases it after writing the frame.
+ */
+static const uint8_t *dmx_transmit_merge(dmx_context_t *ctx, const uint8_t *frame, uint16_t *slots)
+{
+    dmx_input_t *in = dmx_input_claim(ctx);
+    if (in == NULL)
+    {
+        return frame;
+    }
+
+    uint16_t game_slots = *slots;
+    frame = dmx_input_merge(ctx, in, frame, slots);
+    if (*slots != game_slots)
+    {
+        portENTER_CRITICAL(&ctx->stats_lock);
+        ctx->last_frame.slots = *slots;
+        portEXIT_CRITICAL(&ctx->stats_lock);
+    }
+
+    return frame;
+}
+
+/**
+ * @brief Send DMX break signal
+ *
+ * Busy-waits for break and MAB. Used by DMX_TX_MODE_BUSY_WAIT for every frame
+ * and once by DMX_TX_MODE_HW_BREAK to open the first frame.
+ *
+ * @param mab_us Mark-after-break length in microseconds
+ */
+static esp_err_t dmx_send_break(dmx_context_t *ctx, uint32_t mab_us)
+{
+    uint32_t break_us = 0;
+
+    int64_t start = esp_timer_get_time();
+    ctx->transport->wait_done(ctx->transport, UINT32_MAX);
+    esp_err_t ret = ctx->transport->send_break(ctx->transport, DMX_BREAK_US, mab_us, &break_us);
+    ctx->window_blocked_us += (uint32_t)(esp_timer_get_time() - start);
+    if (ret == ESP_OK)
+    {
+        dmx_stats_break(ctx, break_us);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief TX pacing timer callback, releases the waiting TX task
+ */
+static void dmx_tx_timer_cb(void *arg)
+{
+    TaskHandle_t *task = (TaskHandle_t *)arg;
+    xTaskNotifyGive(*task);
+}
+
+/**
+ * @brief When the next frame of a universe is due
+ *
+ * The frame is due at the regular cadence slot, or earlier once
+ * dmx_request_frame() asks for one, but never before the minimum spacing
+ * after the previous frame has passed.
+ *
+ * @param early Set if the deadline was brought forward by a frame request
+ */
+static int64_t dmx_tx_deadline(dmx_context_t *ctx, bool *early)
+{
+    int64_t earliest = ctx->last_frame.start_us + dmx_frame_min_spacing_us(ctx->last_frame_slots);
+
+    *early = false;
+    if (atomic_load(&ctx->frame_requested) && earliest < ctx->next_frame_us)
+    {
+        *early = true;
+        return earliest;
+    }
+
+    // A late frame must not pull the next one closer than the minimum spacing
+    return (ctx->next_frame_us > earliest) ? ctx->next_frame_us : earliest;
+}
+
+/**
+ * @brief Block the calling TX task until the deadline or a notification
+ *
+ * Requests notify the task directly, so the caller re-evaluates its
+ * deadlines after every wake-up.
+ */
+static void dmx_tx_sleep(esp_timer_handle_t timer, int64_t deadline, int64_t now)
+{
+    esp_timer_stop(timer);
+    esp_timer_start_once(timer, (uint64_t)(deadline - now));
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+/**
+ * @brief Send one frame and schedule the next
+ *
+ * @param early The frame was brought forward by a request, which restarts
+ *              the regular cadence from this frame
+ */
+static void dmx_tx_frame(dmx_context_t *ctx, bool early)
+{
+    if (dmx_transmit(ctx) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "DMX transmission failed");
+    }
+    ctx->window_frames++;
+
+    int64_t now = esp_timer_get_time();
+    if (now - ctx->window_start_us >= DMX_CPU_WINDOW_US)
+    {
+        ctx->tx_blocked_us = (uint32_t)((uint64_t)ctx->window_blocked_us * DMX_CPU_WINDOW_US /
+                                        (uint64_t)(now - ctx->window_start_us));
+        ESP_LOGD(TAG, "TX %lu frames/s, blocked %lu us/s",
+                 (unsigned long)ctx->window_frames, (unsigned long)ctx->tx_blocked_us);
+
+        ctx->window_start_us = now;
+        ctx->window_frames = 0;
+        ctx->window_blocked_us = 0;
+    }
+
+    // Don't try to catch up after an overrun, just restart the cadence
+    int64_t base = early ? ctx->last_frame.start_us : ctx->next_frame_us;
+    ctx->next_frame_us = base + dmx_frame_period_us(ctx, ctx->last_frame_slots);
+    if (ctx->next_frame_us < now)
+    {
+        ctx->next_frame_us = now;
+    }
+
+    dmx_frame_cb_t frame_cb[DMX_FRAME_CALLBACKS_MAX];
+    void *frame_cb_arg[DMX_FRAME_CALLBACKS_MAX];
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    uint8_t frame_cb_count = ctx->frame_cb_count;
+    memcpy(frame_cb, ctx->frame_cb, frame_cb_count * sizeof(frame_cb[0]));
+    memcpy(frame_cb_arg, ctx->frame_cb_arg, frame_cb_count * sizeof(frame_cb_arg[0]));
+    portEXIT_CRITICAL(&ctx->stats_lock);
+
+    for (int i = 0; i < frame_cb_count; i++)
+    {
+        frame_cb[i]((dmx_handle_t)ctx, ctx->next_frame_us, frame_cb_arg[i]);
+    }
+}
+
+/**
+ * @brief Last call of a TX or group task, which dmx_tx_task_join() deletes
+ */
+static void dmx_tx_task_exit(SemaphoreHandle_t exited)
+{
+    xSemaphoreGive(exited);
+    vTaskSuspend(NULL);
+}
+
+/**
+ * @brief Stop a TX or group task and wait until it is gone
+ *
+ * The task is woken so it sees the stop request, and deleted once it has
+ * signalled that it left its loop. Deleting it from here unlinks it at
+ * once; a task that deletes itself waits for the idle task to clean up,
+ * and restarting on the same static TCB and stack before that would
+ * corrupt the scheduler lists.
+ */
+static void dmx_tx_task_join(TaskHandle_t task, SemaphoreHandle_t exited)
+{
+    xTaskNotifyGive(task);
+    xSemaphoreTake(exited, portMAX_DELAY);
+    vTaskDelete(task);
+}
+
+/**
+ * @brief Reset the cadence of a universe before its TX task starts
+ */
+static void dmx_tx_prepare(dmx_context_t *ctx, int64_t first_frame)
+{
+    ctx->next_frame_us = first_frame;
+    ctx->window_start_us = first_frame;
+    ctx->window_frames = 0;
+    ctx->window_blocked_us = 0;
+}
+
+/**
+ * @brief Continuous transmission task
+ *
+ * Paced by a one-shot esp_timer rather than vTaskDelayUntil(), since the
+ * FreeRTOS tick is too coarse for truncated frame periods.
+ */
+static void dmx_tx_task(void *arg)
+{
+    dmx_context_t *ctx = (dmx_context_t *)arg;
+
+    // Held until dmx_start_transmission() has stored the handle the pacing timer notifies
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    ESP_LOGI(TAG, "DMX transmission task started");
+
+    while (ctx->is_running)
+    {
+        bool early;
+        int64_t deadline = dmx_tx_deadline(ctx, &early);
+        int64_t now = esp_timer_get_time();
+
+        if (now < deadline)
+        {
+            dmx_tx_sleep(ctx->tx_timer, deadline, now);
+            continue;
+        }
+
+        dmx_tx_frame(ctx, early);
+    }
+
+    esp_timer_stop(ctx->tx_timer);
+    esp_timer_delete(ctx->tx_timer);
+    ctx->tx_timer = NULL;
+
+    ESP_LOGI(TAG, "DMX transmission task stopped");
+    dmx_tx_task_exit(ctx->tx_exited);
+}
+
+/**
+ * @brief Group scheduler task
+ *
+ * Serves whichever universe is due first. Frame starts on different
+ * universes are kept at least DMX_GROUP_BREAK_SPACING_US apart so their
+ * breaks never coincide; a universe held back this way shows it as jitter
+ * in its own statistics.
+ */
+static void dmx_group_task(void *arg)
+{
+    struct dmx_group_t *group = (struct dmx_group_t *)arg;
+
+    ESP_LOGI(TAG, "DMX group scheduler started (%u universes)", (unsigned)group->count);
+
+    while (group->is_running)
+    {
+        dmx_context_t *due = NULL;
+        bool due_early = false;
+        int64_t deadline = INT64_MAX;
+
+        for (size_t i = 0; i < group->count; i++)
+        {
+            bool early;
+            int64_t universe_deadline = dmx_tx_deadline(group->universes[i], &early);
+            if (universe_deadline < deadline)
+            {
+                due = group->universes[i];
+                due_early = early;
+                deadline = universe_deadline;
+            }
+        }
+
+        if (group->last_start_us + DMX_GROUP_BREAK_SPACING_US > deadline)
+        {
+            deadline = group->last_start_us + DMX_GROUP_BREAK_SPACING_US;
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now < deadline)
+        {
+            dmx_tx_sleep(group->timer, deadline, now);
+            continue;
+        }
+
+        dmx_tx_frame(due, due_early);
+        group->last_start_us = due->last_frame.start_us;
+    }
+
+    esp_timer_stop(group->timer);
+    esp_timer_delete(group->timer);
+    group->timer = NULL;
+
+    ESP_LOGI(TAG, "DMX group scheduler stopped");
+    dmx_tx_task_exit(group->task_exited);
+}
+
+/**
+ * @brief Check a configuration before anything is allocated
+ */
+static esp_err_t dmx_check_config(const dmx_config_t *config)
+{
+    if (config->universe_size == 0 || config->universe_size > DMX_UNIVERSE_SIZE)
+    {
+        ESP_LOGE(TAG, "Invalid universe size: %d", config->universe_size);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (config->tx_mode != DMX_TX_MODE_BUSY_WAIT && config->tx_mode != DMX_TX_MODE_HW_BREAK)
+    {
+        ESP_LOGE(TAG, "Invalid TX mode: %d", config->tx_mode);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (config->frame_mode != DMX_FRAME_FULL && config->frame_mode != DMX_FRAME_TRUNCATED)
+    {
+        ESP_LOGE(TAG, "Invalid frame mode: %d", config->frame_mode);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Release whatever a (partially) initialized context holds
+ *
+ * Single cleanup path for init failures and dmx_deinit(). Static contexts
+ * only give back the transport and mutex, their memory belongs to the caller.
+ */
+static void dmx_context_release(dmx_context_t *ctx)
+{
+    if (ctx->transport != NULL && ctx->owns_transport)
+    {
+        ctx->transport->del(ctx->transport);
+    }
+
+    if (ctx->mutex != NULL)
+    {
+        vSemaphoreDelete(ctx->mutex);
+    }
+
+    if (ctx->tx_exited != NULL)
+    {
+        vSemaphoreDelete(ctx->tx_exited);
+    }
+
+    if (!ctx->is_static)
+    {
+        free(ctx->frame_pool);
+        free(ctx);
+    }
+}
+
+/**
+ * @brief Initialize context fields once storage and mutex are in place
+ *
+ * @param uart Storage for the built-in transport, or NULL to allocate it
+ */
+static esp_err_t dmx_context_setup(dmx_context_t *ctx, const dmx_config_t *config, void *uart)
+{
+    ctx->universe_size = config->universe_size;
+    ctx->tx_mode = config->tx_mode;
+    ctx->frame_mode = config->frame_mode;
+    ctx->patched_last = 0;
+    ctx->written_last = 0;
+    ctx->hw_break_primed = false;
+    ctx->tx_blocked_us = 0;
+    ctx->is_running = false;
+    ctx->tx_task_handle = NULL;
+    ctx->tx_timer = NULL;
+    ctx->group = NULL;
+    memset(ctx->patched, 0, sizeof(ctx->patched));
+    atomic_init(&ctx->input, NULL);
+    atomic_init(&ctx->input_busy, NULL);
+
+    // Frame pool is zeroed, so every frame starts with the 0x00 start code
+    for (int i = 0; i < DMX_FRAME_BUFFERS; i++)
+    {
+        ctx->frames[i] = ctx->frame_pool + i * (ctx->universe_size + 1);
+    }
+    ctx->back_idx = 0;
+    ctx->front_idx = 1;
+    atomic_init(&ctx->ready, 2);
+    for (int i = 0; i < DMX_FRAME_BUFFERS; i++)
+    {
+        ctx->frame_slots[i] = dmx_frame_slots(ctx);
+    }
+    ctx->last_frame_slots = dmx_frame_slots(ctx);
+    memset(&ctx->last_frame, 0, sizeof(ctx->last_frame));
+    portMUX_INITIALIZE(&ctx->stats_lock);
+    dmx_stats_clear(&ctx->stats);
+    ctx->period_ref_us = 0;
+    atomic_init(&ctx->frame_requested, false);
+    ctx->request_us = 0;
+    ctx->dirty_first = 0;
+    ctx->dirty_last = 0;
+    ctx->txn_owner = NULL;
+    ctx->txn_depth = 0;
+
+    esp_err_t ret = ESP_OK;
+    if (config->transport != NULL)
+    {
+        ctx->transport = config->transport;
+        ctx->owns_transport = false;
+    }
+    else
+    {
+#if CONFIG_IDF_TARGET_LINUX
+        (void)uart;
+        ESP_LOGE(TAG, "No transport given, the UART transport is not available on Linux");
+        ret = ESP_ERR_NOT_SUPPORTED;
+#else
+        if (uart != NULL)
+        {
+            ret = dmx_uart_transport_init((dmx_uart_transport_t *)uart, config, &ctx->transport);
+        }
+        else
+        {
+            ret = dmx_uart_transport_create(config, &ctx->transport);
+        }
+        ctx->owns_transport = (ret == ESP_OK);
+#endif
+    }
+
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create DMX transport");
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "DMX initialized: %s, Channels:%d, Mode:%s/%s%s",
+             ctx->owns_transport ? "UART" : "custom transport", ctx->universe_size,
+             ctx->tx_mode == DMX_TX_MODE_HW_BREAK ? "hw-break" : "busy-wait",
+             ctx->frame_mode == DMX_FRAME_TRUNCATED ? "truncated" : "full",
+             ctx->is_static ? ", static" : "");
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_init(const dmx_config_t *config, dmx_handle_t *out_handle)
+{
+    if (config == NULL || out_handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = dmx_check_config(config);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)calloc(1, sizeof(dmx_context_t));
+    if (ctx == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate DMX context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ctx->frame_pool = (uint8_t *)calloc(DMX_FRAME_BUFFERS * (config->universe_size + 1), sizeof(uint8_t));
+    ctx->mutex = xSemaphoreCreateMutex();
+    ctx->tx_exited = xSemaphoreCreateBinary();
+    if (ctx->frame_pool == NULL || ctx->mutex == NULL || ctx->tx_exited == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate DMX frame buffers or semaphores");
+        dmx_context_release(ctx);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ret = dmx_context_setup(ctx, config, NULL);
+    if (ret != ESP_OK)
+    {
+        dmx_context_release(ctx);
+        return ret;
+    }
+
+    *out_handle = (dmx_handle_t)ctx;
+    return ESP_OK;
+}
+
+esp_err_t dmx_init_static(const dmx_config_t *config, dmx_static_t *storage, dmx_handle_t *out_handle)
+{
+    if (config == NULL || storage == NULL || out_handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = dmx_check_config(config);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    dmx_static_context_t *static_ctx = (dmx_static_context_t *)storage->context;
+    memset(static_ctx, 0, sizeof(*static_ctx));
+    memset(storage->frame_pool, 0, sizeof(storage->frame_pool));
+
+    dmx_context_t *ctx = &static_ctx->ctx;
+    ctx->is_static = true;
+    ctx->frame_pool = storage->frame_pool;
+    ctx->task_buffer = &storage->task;
+    ctx->task_stack = storage->task_stack;
+    ctx->mutex = xSemaphoreCreateMutexStatic(&storage->mutex);
+    ctx->tx_exited = xSemaphoreCreateBinaryStatic(&storage->tx_exited);
+
+#if CONFIG_IDF_TARGET_LINUX
+    ret = dmx_context_setup(ctx, config, NULL);
+#else
+    ret = dmx_context_setup(ctx, config, &static_ctx->uart);
+#endif
+    if (ret != ESP_OK)
+    {
+        dmx_context_release(ctx);
+        return ret;
+    }
+
+    *out_handle = (dmx_handle_t)ctx;
+    return ESP_OK;
+}
+
+esp_err_t dmx_deinit(dmx_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (ctx->group != NULL)
+    {
+        ESP_LOGE(TAG, "Universe is still part of a group");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (ctx->is_running)
+    {
+        dmx_stop_transmission(handle);
+    }
+
+    dmx_input_stop(handle);
+
+    dmx_context_release(ctx);
+
+    ESP_LOGI(TAG, "DMX deinitialized");
+    return ESP_OK;
+}
+
+esp_err_t dmx_set_channel(dmx_handle_t handle, uint16_t channel, uint8_t value)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (channel == 0 || channel > ctx->universe_size)
+    {
+        ESP_LOGE(TAG, "Invalid channel: %d (valid: 1-%d)", channel, ctx->universe_size);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool in_txn;
+    if (dmx_writer_lock(ctx, &in_txn) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+
+    ctx->frames[ctx->back_idx][channel] = value;
+    dmx_mark_dirty(ctx, channel, channel);
+    dmx_writer_unlock(ctx, in_txn);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_set_channels(dmx_handle_t handle, uint16_t start_channel,
+                           const uint8_t *data, uint16_t length)
+{
+    if (handle == NULL || data == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (start_channel == 0 || start_channel > ctx->universe_size ||
+        (start_channel + length - 1) > ctx->universe_size)
+    {
+        ESP_LOGE(TAG, "Invalid channel range: %d-%d", start_channel, start_channel + length - 1);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (length == 0)
+    {
+        return ESP_OK;
+    }
+
+    bool in_txn;
+    if (dmx_writer_lock(ctx, &in_txn) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+
+    memcpy(&ctx->frames[ctx->back_idx][start_channel], data, length);
+    dmx_mark_dirty(ctx, start_channel, start_channel + length - 1);
+    dmx_writer_unlock(ctx, in_txn);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_patch(dmx_handle_t handle, uint16_t start_channel, uint16_t count)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (start_channel == 0 || count == 0 || (start_channel + count - 1) > ctx->universe_size)
+    {
+        ESP_LOGE(TAG, "Invalid patch range: %d-%d", start_channel, start_channel + count - 1);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool in_txn;
+    if (dmx_writer_lock(ctx, &in_txn) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+
+    uint16_t last = start_channel + count - 1;
+    if (last > ctx->patched_last)
+    {
+        ctx->patched_last = last;
+    }
+    for (uint16_t ch = start_channel; ch <= last; ch++)
+    {
+        ctx->patched[(ch - 1) / 8] |= (uint8_t)(1 << ((ch - 1) % 8));
+    }
+    // Republish so the new frame length takes effect even if nothing is written
+    dmx_mark_dirty(ctx, start_channel, last);
+    dmx_writer_unlock(ctx, in_txn);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_get_channel(dmx_handle_t handle, uint16_t channel, uint8_t *value)
+{
+    if (handle == NULL || value == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (channel == 0 || channel > ctx->universe_size)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool in_txn;
+    if (dmx_writer_lock(ctx, &in_txn) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+
+    *value = ctx->frames[ctx->back_idx][channel];
+    dmx_writer_unlock(ctx, in_txn);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_begin(dmx_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (ctx->txn_owner == xTaskGetCurrentTaskHandle())
+    {
+        if (ctx->txn_depth == UINT8_MAX)
+        {
+            ESP_LOGE(TAG, "DMX transaction nested too deep");
+            return ESP_ERR_INVALID_STATE;
+        }
+        ctx->txn_depth++;
+        return ESP_OK;
+    }
+
+    int64_t wait_start = esp_timer_get_time();
+    if (xSemaphoreTake(ctx->mutex, portMAX_DELAY) != pdTRUE)
+    {
+        return ESP_FAIL;
+    }
+    dmx_stats_mutex_wait(ctx, wait_start);
+
+    ctx->txn_owner = xTaskGetCurrentTaskHandle();
+    ctx->txn_depth = 1;
+    return ESP_OK;
+}
+
+esp_err_t dmx_commit(dmx_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (ctx->txn_owner != xTaskGetCurrentTaskHandle())
+    {
+        ESP_LOGE(TAG, "No DMX transaction open");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (--ctx->txn_depth > 0)
+    {
+        return ESP_OK;
+    }
+
+    ctx->txn_owner = NULL;
+    dmx_publish(ctx);
+    xSemaphoreGive(ctx->mutex);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_transmit(dmx_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+    esp_err_t ret;
+    const uint8_t *frame;
+    uint16_t slots;
+    int bytes_written;
+    int64_t write_start;
+
+    if (ctx->tx_mode == DMX_TX_MODE_HW_BREAK)
+    {
+        if (!ctx->hw_break_primed)
+        {
+            // The next break trails the first frame's data, so a short truncated
+            // frame stretches the leading MAB to keep DMX_MIN_PACKET_US. Sized
+            // from the last frame length, which truncated frames only grow from.
+            uint32_t wire_us = DMX_BREAK_US + DMX_MAB_US + (ctx->last_frame_slots + 1) * DMX_SLOT_US;
+            uint32_t mab_us = DMX_MAB_US;
+            if (wire_us < DMX_MIN_PACKET_US)
+            {
+                mab_us += DMX_MIN_PACKET_US - wire_us;
+            }
+
+            ret = dmx_send_break(ctx, mab_us);
+            if (ret != ESP_OK)
+            {
+                dmx_stats_frame_failed(ctx);
+                return ret;
+            }
+            ctx->hw_break_primed = true;
+        }
+
+        // The UART appends break and MAB after the data, opening the next frame.
+        // The call only queues into the TX ring, the ISR handles the rest.
+        frame = dmx_acquire_front(ctx, &slots);
+        frame = dmx_transmit_merge(ctx, frame, &slots);
+        write_start = esp_timer_get_time();
+        bytes_written = ctx->transport->write(ctx->transport, frame, slots + 1, DMX_BREAK_BITS);
+        dmx_stats_break(ctx, DMX_BREAK_BITS * 1000000 / DMX_BAUD_RATE);
+    }
+    else
+    {
+        ret = dmx_send_break(ctx, DMX_MAB_US);
+        if (ret != ESP_OK)
+        {
+            dmx_stats_frame_failed(ctx);
+            return ret;
+        }
+
+        // The front buffer belongs to the TX path, so the UART copy runs without the writer mutex
+        frame = dmx_acquire_front(ctx, &slots);
+        frame = dmx_transmit_merge(ctx, frame, &slots);
+        write_start = esp_timer_get_time();
+        bytes_written = ctx->transport->write(ctx->transport, frame, slots + 1, 0);
+    }
+    dmx_input_release(ctx);
+
+    uint32_t write_us = (uint32_t)(esp_timer_get_time() - write_start);
+    dmx_stats_write(ctx, write_us, bytes_written, slots + 1);
+    ctx->window_blocked_us += write_us;
+    ctx->last_frame_slots = slots;
+
+    if (bytes_written != (slots + 1))
+    {
+        ESP_LOGW(TAG, "DMX write incomplete: %d/%d bytes",
+                 bytes_written, slots + 1);
+        return ESP_FAIL;
+    }
+
+    if (ctx->tx_mode == DMX_TX_MODE_BUSY_WAIT)
+    {
+        int64_t wait_start = esp_timer_get_time();
+        ctx->transport->wait_done(ctx->transport, DMX_PACKET_TIMEOUT_MS);
+        ctx->window_blocked_us += (uint32_t)(esp_timer_get_time() - wait_start);
+    }
+    return ESP_OK;
+}
+
+esp_err_t dmx_request_frame(dmx_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+    TaskHandle_t task = ctx->tx_task_handle;
+
+    if (!ctx->is_running || task == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Keep the oldest pending request time so the reported latency is not understated
+    if (!atomic_load(&ctx->frame_requested))
+    {
+        ctx->request_us = esp_timer_get_time();
+    }
+    atomic_store(&ctx->frame_requested, true);
+    xTaskNotifyGive(task);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_add_frame_callback(dmx_handle_t handle, dmx_frame_cb_t callback, void *arg)
 {
-    uart_wait_tx_done(ctx->uart_num, portMAX_DELAY);
-    uart_set_line_inverse(ctx->uart_num, UART_SIGNAL_TXD_INV);
-    esp_rom_delay_us(DMX_BREAK_US);
+    if (handle == NULL || callback == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    uart_set_line_inverse(ctx->uart_num, UART_SIGNAL_INV_DISABLE);
-    esp_rom_delay_us(DMX_MAB_US);
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+    esp_err_t ret = ESP_OK;
 
-    return ESP_OK;
+    portENTER_CRITICAL(&ctx->stats_lock);
+    if (ctx->frame_cb_count < DMX_FRAME_CALLBACKS_MAX)
+    {
+        ctx->frame_cb[ctx->frame_cb_count] = callback;
+        ctx->frame_cb_arg[ctx->frame_cb_count] = arg;
+        ctx->frame_cb_count++;
+    }
+    else
+    {
+        ret = ESP_ERR_NO_MEM;
+    }
+    portEXIT_CRITICAL(&ctx->stats_lock);
+
+    return ret;
 }
 
-/**
- * @brief Continuous transmission task
- */
-static void dmx_tx_task(void *arg)
+esp_err_t dmx_remove_frame_callback(dmx_handle_t handle, dmx_frame_cb_t callback, void *arg)
 {
-    dmx_context_t *ctx = (dmx_context_t *)arg;
-    TickType_t last_wake_time = xTaskGetTickCount();
-    const TickType_t period = pdMS_TO_TICKS(1000 / DMX_UPDATE_RATE_HZ);
+    if (handle == NULL || callback == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    ESP_LOGI(TAG, "DMX transmission task started");
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
 
-    while (ctx->is_running)
+    portENTER_CRITICAL(&ctx->stats_lock);
+    for (int i = 0; i < ctx->frame_cb_count; i++)
     {
-        if (dmx_transmit(ctx) != ESP_OK)
+        if (ctx->frame_cb[i] == callback && ctx->frame_cb_arg[i] == arg)
         {
-            ESP_LOGW(TAG, "DMX transmission failed");
+            // Keep the remaining callbacks in order
+            for (int j = i + 1; j < ctx->frame_cb_count; j++)
+            {
+                ctx->frame_cb[j - 1] = ctx->frame_cb[j];
+                ctx->frame_cb_arg[j - 1] = ctx->frame_cb_arg[j];
+            }
+            ctx->frame_cb_count--;
+            ret = ESP_OK;
+            break;
         }
-
-        vTaskDelayUntil(&last_wake_time, period);
     }
+    portEXIT_CRITICAL(&ctx->stats_lock);
 
-    ESP_LOGI(TAG, "DMX transmission task stopped");
-    vTaskDelete(NULL);
+    return ret;
 }
 
-esp_err_t dmx_init(const dmx_config_t *config, dmx_handle_t *out_handle)
+esp_err_t dmx_get_last_frame(dmx_handle_t handle, dmx_frame_info_t *info)
 {
-    if (config == NULL || out_handle == NULL)
+    if (handle == NULL || info == NULL)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (config->universe_size == 0 || config->universe_size > DMX_UNIVERSE_SIZE)
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    *info = ctx->last_frame;
+    portEXIT_CRITICAL(&ctx->stats_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_start_transmission(dmx_handle_t handle)
+{
+    if (handle == NULL)
     {
-        ESP_LOGE(TAG, "Invalid universe size: %d", config->universe_size);
         return ESP_ERR_INVALID_ARG;
     }
 
-    dmx_context_t *ctx = (dmx_context_t *)calloc(1, sizeof(dmx_context_t));
-    if (ctx == NULL)
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    if (ctx->is_running || ctx->group != NULL)
     {
-        ESP_LOGE(TAG, "Failed to allocate DMX context");
-        return ESP_ERR_NO_MEM;
+        ESP_LOGW(TAG, "DMX transmission already running");
+        return ESP_ERR_INVALID_STATE;
     }
 
-    ctx->dmx_data = (uint8_t *)calloc(config->universe_size + 1, sizeof(uint8_t));
-    if (ctx->dmx_data == NULL)
+    const esp_timer_create_args_t timer_args = {
+        .callback = dmx_tx_timer_cb,
+        .arg = &ctx->tx_task_handle,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "dmx_tx"};
+    esp_err_t err = esp_timer_create(&timer_args, &ctx->tx_timer);
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to allocate DMX data buffer");
-        free(ctx);
-        return ESP_ERR_NO_MEM;
+        ESP_LOGE(TAG, "Failed to create DMX pacing timer");
+        return err;
     }
 
-    ctx->mutex = xSemaphoreCreateMutex();
-    if (ctx->mutex == NULL)
+    dmx_tx_prepare(ctx, esp_timer_get_time());
+
+    // The task waits for the go below, so requests never see a running
+    // universe without its task handle
+    BaseType_t ret = pdPASS;
+    if (ctx->task_stack != NULL)
     {
-        ESP_LOGE(TAG, "Failed to create mutex");
-        free(ctx->dmx_data);
-        free(ctx);
-        return ESP_ERR_NO_MEM;
+        ctx->tx_task_handle = xTaskCreateStatic(dmx_tx_task, "dmx_tx", DMX_TASK_STACK_SIZE,
+                                                ctx, DMX_TASK_PRIORITY, ctx->task_stack, ctx->task_buffer);
+    }
+    else
+    {
+        ret = xTaskCreate(dmx_tx_task, "dmx_tx", DMX_TASK_STACK_SIZE,
+                          ctx, DMX_TASK_PRIORITY, &ctx->tx_task_handle);
     }
 
-    ctx->uart_num = config->uart_num;
-    ctx->tx_pin = config->tx_pin;
-    ctx->rx_pin = config->rx_pin;
-    ctx->enable_pin = config->enable_pin;
-    ctx->universe_size = config->universe_size;
-    ctx->is_running = false;
-    ctx->tx_task_handle = NULL;
+    if (ret != pdPASS || ctx->tx_task_handle == NULL)
+    {
+        esp_timer_delete(ctx->tx_timer);
+        ctx->tx_timer = NULL;
+        ESP_LOGE(TAG, "Failed to create DMX transmission task");
+        return ESP_FAIL;
+    }
 
-    ctx->dmx_data[0] = 0x00;
+    ctx->is_running = true;
+    xTaskNotifyGive(ctx->tx_task_handle);
 
-    // Configure RS-485 enable pin
-    gpio_config_t io_conf = {
-        .intr_type = GPIO_INTR_DISABLE,
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = (1ULL << ctx->enable_pin),
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .pull_up_en = GPIO_PULLUP_DISABLE};
-    esp_err_t ret = gpio_config(&io_conf);
-    if (ret != ESP_OK)
+    ESP_LOGI(TAG, "DMX continuous transmission started");
+    return ESP_OK;
+}
+
+esp_err_t dmx_stop_transmission(dmx_handle_t handle)
+{
+    if (handle == NULL)
     {
-        ESP_LOGE(TAG, "Failed to configure enable pin");
-        vSemaphoreDelete(ctx->mutex);
-        free(ctx->dmx_data);
-        free(ctx);
-        return ret;
+        return ESP_ERR_INVALID_ARG;
     }
 
-    // Set RS-485 to transmit mode
-    gpio_set_level(ctx->enable_pin, 1);
+    dmx_context_t *ctx = (dmx_context_t *)handle;
 
-    // Configure UART
-    uart_config_t uart_config = {
-        .baud_rate = DMX_BAUD_RATE,
-        .data_bits = DMX_DATA_BITS,
-        .parity = DMX_PARITY,
-        .stop_bits = DMX_STOP_BITS,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
-        .source_clk = UART_SCLK_DEFAULT,
-    };
+    if (ctx->group != NULL)
+    {
+        ESP_LOGW(TAG, "Universe is scheduled by a group, stop the group instead");
+        return ESP_ERR_INVALID_STATE;
+    }
 
-    ret = uart_param_config(ctx->uart_num, &uart_config);
-    if (ret != ESP_OK)
+    if (!ctx->is_running)
     {
-        ESP_LOGE(TAG, "UART param config failed");
-        gpio_reset_pin(ctx->enable_pin);
-        vSemaphoreDelete(ctx->mutex);
-        free(ctx->dmx_data);
-        free(ctx);
-        return ret;
+        return ESP_OK;
     }
 
-    ret = uart_set_pin(ctx->uart_num, ctx->tx_pin, ctx->rx_pin,
-                       UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    if (ret != ESP_OK)
+    ctx->is_running = false;
+
+    if (ctx->tx_task_handle != NULL)
     {
-        ESP_LOGE(TAG, "UART set pin failed");
-        gpio_reset_pin(ctx->enable_pin);
-        vSemaphoreDelete(ctx->mutex);
-        free(ctx->dmx_data);
-        free(ctx);
-        return ret;
+        dmx_tx_task_join(ctx->tx_task_handle, ctx->tx_exited);
+        ctx->tx_task_handle = NULL;
     }
 
-    ret = uart_driver_install(ctx->uart_num, DMX_RX_BUFFER_SIZE,
-                              DMX_TX_BUFFER_SIZE, 0, NULL, 0);
-    if (ret != ESP_OK)
+    ESP_LOGI(TAG, "DMX continuous transmission stopped");
+    return ESP_OK;
+}
+
+esp_err_t dmx_get_stats(dmx_handle_t handle, dmx_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL)
     {
-        ESP_LOGE(TAG, "UART driver install failed");
-        gpio_reset_pin(ctx->enable_pin);
-        vSemaphoreDelete(ctx->mutex);
-        free(ctx->dmx_data);
-        free(ctx);
-        return ret;
+        return ESP_ERR_INVALID_ARG;
     }
 
-    *out_handle = (dmx_handle_t)ctx;
-    ESP_LOGI(TAG, "DMX initialized: UART%d, TX:%d, EN:%d, Channels:%d",
-             ctx->uart_num, ctx->tx_pin, ctx->enable_pin, ctx->universe_size);
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+
+    portENTER_CRITICAL(&ctx->stats_lock);
+    *stats = ctx->stats;
+    portEXIT_CRITICAL(&ctx->stats_lock);
 
     return ESP_OK;
 }
 
-esp_err_t dmx_deinit(dmx_handle_t handle)
+esp_err_t dmx_reset_stats(dmx_handle_t handle)
 {
     if (handle == NULL)
     {
@@ -208,23 +1570,28 @@ esp_err_t dmx_deinit(dmx_handle_t handle)
 
     dmx_context_t *ctx = (dmx_context_t *)handle;
 
-    if (ctx->is_running)
+    portENTER_CRITICAL(&ctx->stats_lock);
+    dmx_stats_clear(&ctx->stats);
+    ctx->period_ref_us = 0; // Don't count the reset gap as a period
+    portEXIT_CRITICAL(&ctx->stats_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_get_tx_blocked(dmx_handle_t handle, uint32_t *us_per_second)
+{
+    if (handle == NULL || us_per_second == NULL)
     {
-        dmx_stop_transmission(handle);
+        return ESP_ERR_INVALID_ARG;
     }
 
-    uart_driver_delete(ctx->uart_num);
-    gpio_reset_pin(ctx->enable_pin);
-
-    vSemaphoreDelete(ctx->mutex);
-    free(ctx->dmx_data);
-    free(ctx);
+    dmx_context_t *ctx = (dmx_context_t *)handle;
+    *us_per_second = ctx->tx_blocked_us;
 
-    ESP_LOGI(TAG, "DMX deinitialized");
     return ESP_OK;
 }
 
-esp_err_t dmx_set_channel(dmx_handle_t handle, uint16_t channel, uint8_t value)
+esp_err_t dmx_clear_all(dmx_handle_t handle)
 {
     if (handle == NULL)
     {
@@ -233,141 +1600,310 @@ esp_err_t dmx_set_channel(dmx_handle_t handle, uint16_t channel, uint8_t value)
 
     dmx_context_t *ctx = (dmx_context_t *)handle;
 
-    if (channel == 0 || channel > ctx->universe_size)
+    bool in_txn;
+    if (dmx_writer_lock(ctx, &in_txn) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Invalid channel: %d (valid: 1-%d)", channel, ctx->universe_size);
-        return ESP_ERR_INVALID_ARG;
+        return ESP_FAIL;
     }
 
-    if (xSemaphoreTake(ctx->mutex, portMAX_DELAY) == pdTRUE)
+    // Channels above every write are zero already; clearing them would
+    // lengthen truncated frames for good
+    uint16_t last = (ctx->patched_last > ctx->written_last) ? ctx->patched_last : ctx->written_last;
+    if (ctx->dirty_last > last)
     {
-        ctx->dmx_data[channel] = value;
-        xSemaphoreGive(ctx->mutex);
-        return ESP_OK;
+        last = ctx->dirty_last;
+    }
+    if (last > 0)
+    {
+        memset(&ctx->frames[ctx->back_idx][1], 0, last);
+        dmx_mark_dirty(ctx, 1, last);
     }
+    dmx_writer_unlock(ctx, in_txn);
 
-    return ESP_FAIL;
+    ESP_LOGI(TAG, "All DMX channels cleared");
+    return ESP_OK;
 }
 
-esp_err_t dmx_set_channels(dmx_handle_t handle, uint16_t start_channel,
-                           const uint8_t *data, uint16_t length)
+esp_err_t dmx_group_create(const dmx_handle_t *universes, size_t count, dmx_group_handle_t *out_group)
 {
-    if (handle == NULL || data == NULL)
+    if (universes == NULL || out_group == NULL || count == 0 || count > DMX_GROUP_MAX_UNIVERSES)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
-    dmx_context_t *ctx = (dmx_context_t *)handle;
+    for (size_t i = 0; i < count; i++)
+    {
+        dmx_context_t *ctx = (dmx_context_t *)universes[i];
+        if (ctx == NULL)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
 
-    if (start_channel == 0 || start_channel > ctx->universe_size ||
-        (start_channel + length - 1) > ctx->universe_size)
+        if (ctx->is_running || ctx->group != NULL)
+        {
+            ESP_LOGE(TAG, "Universe %u is already transmitting or grouped", (unsigned)i);
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        // Busy-wait TX blocks for the whole frame, the shared task can't wait on one universe
+        if (ctx->tx_mode != DMX_TX_MODE_HW_BREAK)
+        {
+            ESP_LOGE(TAG, "Universe %u uses busy-wait TX, groups need DMX_TX_MODE_HW_BREAK", (unsigned)i);
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+
+        for (size_t j = 0; j < i; j++)
+        {
+            if (universes[j] == universes[i])
+            {
+                ESP_LOGE(TAG, "Universe %u listed twice", (unsigned)i);
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+    }
+
+    struct dmx_group_t *group = (struct dmx_group_t *)calloc(1, sizeof(struct dmx_group_t));
+    if (group == NULL)
     {
-        ESP_LOGE(TAG, "Invalid channel range: %d-%d", start_channel, start_channel + length - 1);
-        return ESP_ERR_INVALID_ARG;
+        ESP_LOGE(TAG, "Failed to allocate DMX group");
+        return ESP_ERR_NO_MEM;
     }
 
-    if (xSemaphoreTake(ctx->mutex, portMAX_DELAY) == pdTRUE)
+    group->task_exited = xSemaphoreCreateBinary();
+    if (group->task_exited == NULL)
     {
-        memcpy(&ctx->dmx_data[start_channel], data, length);
-        xSemaphoreGive(ctx->mutex);
-        return ESP_OK;
+        ESP_LOGE(TAG, "Failed to allocate DMX group semaphore");
+        free(group);
+        return ESP_ERR_NO_MEM;
     }
 
-    return ESP_FAIL;
+    group->count = count;
+    for (size_t i = 0; i < count; i++)
+    {
+        group->universes[i] = (dmx_context_t *)universes[i];
+        group->universes[i]->group = group;
+    }
+
+    *out_group = group;
+    ESP_LOGI(TAG, "DMX group created: %u universes", (unsigned)count);
+    return ESP_OK;
 }
 
-esp_err_t dmx_get_channel(dmx_handle_t handle, uint16_t channel, uint8_t *value)
+esp_err_t dmx_group_delete(dmx_group_handle_t group)
 {
-    if (handle == NULL || value == NULL)
+    if (group == NULL)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
-    dmx_context_t *ctx = (dmx_context_t *)handle;
+    if (group->is_running)
+    {
+        dmx_group_stop(group);
+    }
 
-    if (channel == 0 || channel > ctx->universe_size)
+    for (size_t i = 0; i < group->count; i++)
+    {
+        group->universes[i]->group = NULL;
+    }
+
+    vSemaphoreDelete(group->task_exited);
+    free(group);
+    return ESP_OK;
+}
+
+esp_err_t dmx_group_start(dmx_group_handle_t group)
+{
+    if (group == NULL)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (xSemaphoreTake(ctx->mutex, portMAX_DELAY) == pdTRUE)
+    if (group->is_running)
     {
-        *value = ctx->dmx_data[channel];
-        xSemaphoreGive(ctx->mutex);
-        return ESP_OK;
+        ESP_LOGW(TAG, "DMX group already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = dmx_tx_timer_cb,
+        .arg = &group->task_handle,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "dmx_group"};
+    esp_err_t err = esp_timer_create(&timer_args, &group->timer);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create DMX group pacing timer");
+        return err;
+    }
+
+    // Spread the first frames evenly over each universe's period so the
+    // cadences start out of phase
+    int64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < group->count; i++)
+    {
+        dmx_context_t *ctx = group->universes[i];
+        uint32_t period_us = dmx_frame_period_us(ctx, ctx->last_frame_slots);
+        dmx_tx_prepare(ctx, now + (int64_t)(period_us * i / group->count));
+    }
+    group->last_start_us = 0;
+    group->is_running = true;
+
+    BaseType_t ret = xTaskCreate(dmx_group_task, "dmx_group", DMX_TASK_STACK_SIZE,
+                                 group, DMX_TASK_PRIORITY, &group->task_handle);
+
+    if (ret != pdPASS)
+    {
+        group->is_running = false;
+        esp_timer_delete(group->timer);
+        group->timer = NULL;
+        ESP_LOGE(TAG, "Failed to create DMX group scheduler task");
+        return ESP_FAIL;
+    }
+
+    // Frame requests on any universe wake the shared scheduler
+    for (size_t i = 0; i < group->count; i++)
+    {
+        group->universes[i]->tx_task_handle = group->task_handle;
+        group->universes[i]->is_running = true;
     }
 
-    return ESP_FAIL;
+    ESP_LOGI(TAG, "DMX group transmission started");
+    return ESP_OK;
 }
 
-esp_err_t dmx_transmit(dmx_handle_t handle)
+esp_err_t dmx_group_stop(dmx_group_handle_t group)
 {
-    if (handle == NULL)
+    if (group == NULL)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
-    dmx_context_t *ctx = (dmx_context_t *)handle;
-    esp_err_t ret;
+    if (!group->is_running)
+    {
+        return ESP_OK;
+    }
 
-    ret = dmx_send_break(ctx);
-    if (ret != ESP_OK)
+    group->is_running = false;
+    for (size_t i = 0; i < group->count; i++)
     {
-        return ret;
+        group->universes[i]->is_running = false;
+    }
+
+    if (group->task_handle != NULL)
+    {
+        dmx_tx_task_join(group->task_handle, group->task_exited);
+        group->task_handle = NULL;
+    }
+
+    for (size_t i = 0; i < group->count; i++)
+    {
+        group->universes[i]->tx_task_handle = NULL;
     }
 
-    if (xSemaphoreTake(ctx->mutex, portMAX_DELAY) == pdTRUE)
+    ESP_LOGI(TAG, "DMX group transmission stopped");
+    return ESP_OK;
+}
+
+esp_err_t dmx_group_get_stats(dmx_group_handle_t group, dmx_stats_t *stats)
+{
+    if (group == NULL || stats == NULL)
     {
-        int bytes_written = uart_write_bytes(ctx->uart_num, ctx->dmx_data,
-                                             ctx->universe_size + 1);
-        xSemaphoreGive(ctx->mutex);
+        return ESP_ERR_INVALID_ARG;
+    }
 
-        if (bytes_written != (ctx->universe_size + 1))
+    dmx_stats_clear(stats);
+
+    for (size_t i = 0; i < group->count; i++)
+    {
+        dmx_stats_t u;
+        dmx_get_stats(group->universes[i], &u);
+
+        stats->frames_sent += u.frames_sent;
+        stats->frames_fresh += u.frames_fresh;
+        stats->frames_requested += u.frames_requested;
+        stats->write_incomplete += u.write_incomplete;
+        stats->write_failed += u.write_failed;
+        stats->mutex_waits += u.mutex_waits;
+        stats->period_min_us = (u.period_min_us < stats->period_min_us) ? u.period_min_us : stats->period_min_us;
+        stats->period_max_us = (u.period_max_us > stats->period_max_us) ? u.period_max_us : stats->period_max_us;
+        stats->jitter_max_us = (u.jitter_max_us > stats->jitter_max_us) ? u.jitter_max_us : stats->jitter_max_us;
+        stats->break_min_us = (u.break_min_us < stats->break_min_us) ? u.break_min_us : stats->break_min_us;
+        stats->break_max_us = (u.break_max_us > stats->break_max_us) ? u.break_max_us : stats->break_max_us;
+        stats->write_max_us = (u.write_max_us > stats->write_max_us) ? u.write_max_us : stats->write_max_us;
+        stats->mutex_wait_max_us = (u.mutex_wait_max_us > stats->mutex_wait_max_us) ? u.mutex_wait_max_us : stats->mutex_wait_max_us;
+        for (int b = 0; b < DMX_STATS_HIST_BUCKETS; b++)
         {
-            ESP_LOGW(TAG, "DMX write incomplete: %d/%d bytes",
-                     bytes_written, ctx->universe_size + 1);
-            return ESP_FAIL;
+            stats->jitter_hist[b] += u.jitter_hist[b];
+            stats->write_hist[b] += u.write_hist[b];
+            stats->mutex_wait_hist[b] += u.mutex_wait_hist[b];
         }
+    }
 
-        uart_wait_tx_done(ctx->uart_num, pdMS_TO_TICKS(DMX_PACKET_TIMEOUT_MS));
-        return ESP_OK;
+    return ESP_OK;
+}
+
+esp_err_t dmx_group_reset_stats(dmx_group_handle_t group)
+{
+    if (group == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < group->count; i++)
+    {
+        dmx_reset_stats(group->universes[i]);
     }
 
-    return ESP_FAIL;
+    return ESP_OK;
 }
 
-esp_err_t dmx_start_transmission(dmx_handle_t handle)
+esp_err_t dmx_input_start(dmx_handle_t handle, dmx_merge_mode_t mode)
 {
-    if (handle == NULL)
+    if (handle == NULL || (mode != DMX_MERGE_HTP && mode != DMX_MERGE_LTP))
     {
         return ESP_ERR_INVALID_ARG;
     }
 
     dmx_context_t *ctx = (dmx_context_t *)handle;
 
-    if (ctx->is_running)
+    if (atomic_load(&ctx->input) != NULL)
     {
-        ESP_LOGW(TAG, "DMX transmission already running");
         return ESP_ERR_INVALID_STATE;
     }
 
-    ctx->is_running = true;
+    if (ctx->transport->rx_start == NULL)
+    {
+        ESP_LOGE(TAG, "Transport cannot receive DMX");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    dmx_input_t *in = (dmx_input_t *)calloc(1, sizeof(dmx_input_t));
+    if (in == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate DMX input buffers");
+        return ESP_ERR_NO_MEM;
+    }
 
-    BaseType_t ret = xTaskCreate(dmx_tx_task, "dmx_tx", DMX_TASK_STACK_SIZE,
-                                 ctx, DMX_TASK_PRIORITY, &ctx->tx_task_handle);
+    in->mode = mode;
+    in->back_idx = 0;
+    in->front_idx = 1;
+    atomic_init(&in->ready, 2);
+    atomic_store(&ctx->input, in);
 
-    if (ret != pdPASS)
+    esp_err_t ret = ctx->transport->rx_start(ctx->transport, dmx_input_frame_cb, ctx);
+    if (ret != ESP_OK)
     {
-        ctx->is_running = false;
-        ESP_LOGE(TAG, "Failed to create DMX transmission task");
-        return ESP_FAIL;
+        ESP_LOGE(TAG, "Failed to start DMX input");
+        atomic_store(&ctx->input, NULL);
+        free(in);
+        return ret;
     }
 
-    ESP_LOGI(TAG, "DMX continuous transmission started");
+    ESP_LOGI(TAG, "DMX input merge started: %s", mode == DMX_MERGE_HTP ? "HTP" : "LTP");
     return ESP_OK;
 }
 
-esp_err_t dmx_stop_transmission(dmx_handle_t handle)
+esp_err_t dmx_input_stop(dmx_handle_t handle)
 {
     if (handle == NULL)
     {
@@ -375,40 +1911,48 @@ esp_err_t dmx_stop_transmission(dmx_handle_t handle)
     }
 
     dmx_context_t *ctx = (dmx_context_t *)handle;
+    dmx_input_t *in = atomic_load(&ctx->input);
 
-    if (!ctx->is_running)
+    if (in == NULL)
     {
         return ESP_OK;
     }
 
-    ctx->is_running = false;
+    // No receive callbacks once rx_stop returns; stats readers load the input under the lock
+    ctx->transport->rx_stop(ctx->transport);
+    portENTER_CRITICAL(&ctx->stats_lock);
+    atomic_store(&ctx->input, NULL);
+    portEXIT_CRITICAL(&ctx->stats_lock);
 
-    if (ctx->tx_task_handle != NULL)
+    // A frame the TX path claimed the input for is still being merged or written
+    while (atomic_load(&ctx->input_busy) == in)
     {
-        vTaskDelay(pdMS_TO_TICKS(50));
-        ctx->tx_task_handle = NULL;
+        vTaskDelay(1);
     }
+    free(in);
 
-    ESP_LOGI(TAG, "DMX continuous transmission stopped");
+    ESP_LOGI(TAG, "DMX input merge stopped");
     return ESP_OK;
 }
 
-esp_err_t dmx_clear_all(dmx_handle_t handle)
+esp_err_t dmx_input_get_stats(dmx_handle_t handle, dmx_input_stats_t *stats)
 {
-    if (handle == NULL)
+    if (handle == NULL || stats == NULL)
     {
         return ESP_ERR_INVALID_ARG;
     }
 
     dmx_context_t *ctx = (dmx_context_t *)handle;
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
 
-    if (xSemaphoreTake(ctx->mutex, portMAX_DELAY) == pdTRUE)
+    portENTER_CRITICAL(&ctx->stats_lock);
+    dmx_input_t *in = atomic_load(&ctx->input);
+    if (in != NULL)
     {
-        memset(&ctx->dmx_data[1], 0, ctx->universe_size);
-        xSemaphoreGive(ctx->mutex);
-        ESP_LOGI(TAG, "All DMX channels cleared");
-        return ESP_OK;
+        *stats = in->stats;
+        ret = ESP_OK;
     }
+    portEXIT_CRITICAL(&ctx->stats_lock);
 
-    return ESP_FAIL;
+    return ret;
 }
@@ -0,0 +1,262 @@
+/**
+ * @file dmx_transport_linux.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Virtual DMX line for Linux host builds
+ *
+ * The line is modelled as a clock that advances by one slot time per byte.
+ * Writes return immediately like the UART ring buffer does; wait_done sleeps
+ * until the modelled line is idle so the driver's pacing sees real wire time.
+ */
+
+#include "dmx_transport_linux.h"
+#include "dmx_driver.h"
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_log.h"
+
+static const char *TAG = "DMX_LINUX";
+
+/**
+ * @brief Linux transport context
+ */
+typedef struct
+{
+    dmx_transport_t base; // Must stay first
+    dmx_decoder_t decoder;
+    dmx_capture_event_t *capture;
+    size_t capture_capacity;
+    size_t capture_count;
+    size_t capture_dropped;
+    int64_t line_free_us; // When the last queued bit leaves the line
+    dmx_decoder_t rx_decoder; // Frames injected with dmx_linux_transport_receive()
+    bool rx_running;
+} dmx_linux_transport_t;
+
+static int64_t dmx_linux_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void dmx_linux_sleep_until(int64_t deadline_us)
+{
+    int64_t now = dmx_linux_now_us();
+    if (deadline_us > now)
+    {
+        usleep((useconds_t)(deadline_us - now));
+    }
+}
+
+static int64_t dmx_linux_line_start(dmx_linux_transport_t *line)
+{
+    int64_t now = dmx_linux_now_us();
+    return (line->line_free_us > now) ? line->line_free_us : now;
+}
+
+static void dmx_linux_record(dmx_linux_transport_t *line, int64_t timestamp_us, uint16_t value, bool is_break)
+{
+    if (line->capture == NULL)
+    {
+        return;
+    }
+
+    if (line->capture_count >= line->capture_capacity)
+    {
+        line->capture_dropped++;
+        return;
+    }
+
+    dmx_capture_event_t *event = &line->capture[line->capture_count++];
+    event->timestamp_us = timestamp_us;
+    event->value = value;
+    event->is_break = is_break;
+}
+
+static void dmx_linux_break(dmx_linux_transport_t *line, int64_t start_us, uint32_t break_us, uint32_t mab_us)
+{
+    dmx_linux_record(line, start_us, (uint16_t)break_us, true);
+    dmx_decoder_feed_break(&line->decoder, start_us, break_us);
+    line->line_free_us = start_us + break_us + mab_us;
+}
+
+static esp_err_t dmx_linux_send_break(dmx_transport_t *transport, uint32_t break_us, uint32_t mab_us,
+                                      uint32_t *measured_break_us)
+{
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+
+    dmx_linux_break(line, dmx_linux_line_start(line), break_us, mab_us);
+    *measured_break_us = break_us;
+
+    // Software break blocks the caller for break and MAB, as on the target
+    dmx_linux_sleep_until(line->line_free_us);
+
+    return ESP_OK;
+}
+
+static int dmx_linux_write(dmx_transport_t *transport, const uint8_t *data, size_t length, uint32_t break_bits)
+{
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+
+    int64_t t = dmx_linux_line_start(line);
+    for (size_t i = 0; i < length; i++)
+    {
+        dmx_linux_record(line, t, data[i], false);
+        t += DMX_SLOT_US;
+    }
+    dmx_decoder_feed(&line->decoder, data, length);
+    line->line_free_us = t;
+
+    if (break_bits > 0)
+    {
+        uint32_t bit_us = 1000000 / DMX_BAUD_RATE;
+        dmx_linux_break(line, t, break_bits * bit_us, DMX_MAB_BITS * bit_us);
+    }
+
+    return (int)length;
+}
+
+static esp_err_t dmx_linux_wait_done(dmx_transport_t *transport, uint32_t timeout_ms)
+{
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+
+    int64_t deadline = line->line_free_us;
+    if (timeout_ms != UINT32_MAX)
+    {
+        int64_t limit = dmx_linux_now_us() + (int64_t)timeout_ms * 1000;
+        if (limit < deadline)
+        {
+            dmx_linux_sleep_until(limit);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+
+    dmx_linux_sleep_until(deadline);
+    return ESP_OK;
+}
+
+static esp_err_t dmx_linux_rx_start(dmx_transport_t *transport, dmx_decoder_frame_cb_t on_frame, void *arg)
+{
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+
+    if (line->rx_running)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    dmx_decoder_init(&line->rx_decoder, on_frame, arg);
+    line->rx_running = true;
+
+    return ESP_OK;
+}
+
+static esp_err_t dmx_linux_rx_stop(dmx_transport_t *transport)
+{
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+
+    line->rx_running = false;
+    return ESP_OK;
+}
+
+static esp_err_t dmx_linux_del(dmx_transport_t *transport)
+{
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+
+    // Deliver the frame still on the line
+    dmx_decoder_flush(&line->decoder);
+    free(line);
+
+    return ESP_OK;
+}
+
+esp_err_t dmx_linux_transport_create(const dmx_linux_transport_config_t *config,
+                                     dmx_transport_t **out_transport)
+{
+    if (config == NULL || out_transport == NULL ||
+        (config->capture != NULL && config->capture_capacity == 0))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)calloc(1, sizeof(dmx_linux_transport_t));
+    if (line == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate Linux transport");
+        return ESP_ERR_NO_MEM;
+    }
+
+    line->base.send_break = dmx_linux_send_break;
+    line->base.write = dmx_linux_write;
+    line->base.wait_done = dmx_linux_wait_done;
+    line->base.rx_start = dmx_linux_rx_start;
+    line->base.rx_stop = dmx_linux_rx_stop;
+    line->base.del = dmx_linux_del;
+    line->capture = config->capture;
+    line->capture_capacity = config->capture_capacity;
+    dmx_decoder_init(&line->decoder, config->on_frame, config->on_frame_arg);
+
+    *out_transport = &line->base;
+    return ESP_OK;
+}
+
+esp_err_t dmx_linux_transport_get_capture(dmx_transport_t *transport, size_t *count, size_t *dropped)
+{
+    if (transport == NULL || count == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+    *count = line->capture_count;
+    if (dropped != NULL)
+    {
+        *dropped = line->capture_dropped;
+    }
+
+    return ESP_OK;
+}
+
+void dmx_decode_capture(const dmx_capture_event_t *events, size_t count,
+                        dmx_decoder_frame_cb_t on_frame, void *arg)
+{
+    dmx_decoder_t decoder;
+    dmx_decoder_init(&decoder, on_frame, arg);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (events[i].is_break)
+        {
+            dmx_decoder_feed_break(&decoder, events[i].timestamp_us, events[i].value);
+        }
+        else
+        {
+            uint8_t byte = (uint8_t)events[i].value;
+            dmx_decoder_feed(&decoder, &byte, 1);
+        }
+    }
+
+    dmx_decoder_flush(&decoder);
+}
+
+esp_err_t dmx_linux_transport_receive(dmx_transport_t *transport, const uint8_t *data, size_t length)
+{
+    if (transport == NULL || data == NULL || length == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_linux_transport_t *line = (dmx_linux_transport_t *)transport;
+
+    if (!line->rx_running)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    dmx_decoder_feed_break(&line->rx_decoder, dmx_linux_now_us(), DMX_BREAK_US);
+    dmx_decoder_feed(&line->rx_decoder, data, length);
+    dmx_decoder_flush(&line->rx_decoder);
+
+    return ESP_OK;
+}
@@ -0,0 +1,365 @@
+/**
+ * @file dmx_transport_uart.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief DMX transport over UART and an RS-485 transceiver
+ */
+
+#include "dmx_transport_uart.h"
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "driver/uart.h"
+#include "driver/gpio.h"
+#include "soc/uart_reg.h"
+
+static const char *TAG = "DMX_UART";
+
+#define DMX_RX_BUFFER_SIZE 256 // Minimum required by UART driver, ~11 ms of input at line rate
+#define DMX_RX_EVENT_QUEUE_SIZE 16
+#define DMX_RX_FULL_THRESHOLD 64  // FIFO bytes per data event, keeps wake-ups to a few per frame
+#define DMX_RX_TIMEOUT_SYMBOLS 3  // Idle symbols before a partial FIFO is delivered
+#define DMX_RX_CHUNK_SIZE 128
+#define DMX_RX_TASK_STACK_SIZE 3072
+#define DMX_RX_TASK_PRIORITY 5
+#define DMX_TX_RING_OVERHEAD 64 // Ring buffer item headers for one queued frame
+#define DMX_TX_RING_MIN_SIZE (UART_HW_FIFO_LEN(0) * 2)
+
+static esp_err_t dmx_uart_send_break(dmx_transport_t *transport, uint32_t break_us, uint32_t mab_us,
+                                     uint32_t *measured_break_us)
+{
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)transport;
+
+    int64_t break_start = esp_timer_get_time();
+    uart_set_line_inverse(uart->uart_num, UART_SIGNAL_TXD_INV);
+    esp_rom_delay_us(break_us);
+
+    uart_set_line_inverse(uart->uart_num, UART_SIGNAL_INV_DISABLE);
+    *measured_break_us = (uint32_t)(esp_timer_get_time() - break_start);
+    esp_rom_delay_us(mab_us);
+
+    return ESP_OK;
+}
+
+static int dmx_uart_write(dmx_transport_t *transport, const uint8_t *data, size_t length, uint32_t break_bits)
+{
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)transport;
+
+    if (break_bits > 0)
+    {
+        // Only queues into the TX ring; the ISR emits the break and the TX idle time provides MAB
+        return uart_write_bytes_with_break(uart->uart_num, data, length, break_bits);
+    }
+
+    return uart_write_bytes(uart->uart_num, data, length);
+}
+
+static esp_err_t dmx_uart_wait_done(dmx_transport_t *transport, uint32_t timeout_ms)
+{
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)transport;
+
+    TickType_t ticks = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return uart_wait_tx_done(uart->uart_num, ticks);
+}
+
+/**
+ * @brief Move everything the UART driver has buffered into the decoder
+ */
+static void dmx_uart_rx_drain(dmx_uart_transport_t *uart, uint8_t *chunk)
+{
+    size_t available = 0;
+    uart_get_buffered_data_len(uart->uart_num, &available);
+
+    while (available > 0)
+    {
+        size_t want = (available < DMX_RX_CHUNK_SIZE) ? available : DMX_RX_CHUNK_SIZE;
+        int got = uart_read_bytes(uart->uart_num, chunk, want, 0);
+        if (got <= 0)
+        {
+            break;
+        }
+        dmx_decoder_feed(uart->rx_decoder, chunk, (size_t)got);
+        available -= (size_t)got;
+    }
+}
+
+/**
+ * @brief Receive task
+ *
+ * Woken by UART driver events only: data events come per FIFO threshold or
+ * idle timeout rather than per byte, and a break event closes the frame.
+ */
+static void dmx_uart_rx_task(void *arg)
+{
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)arg;
+    uint8_t chunk[DMX_RX_CHUNK_SIZE];
+    uart_event_t event;
+
+    while (uart->rx_running)
+    {
+        if (xQueueReceive(uart->event_queue, &event, portMAX_DELAY) != pdTRUE)
+        {
+            continue;
+        }
+
+        switch (event.type)
+        {
+        case UART_DATA:
+            dmx_uart_rx_drain(uart, chunk);
+            break;
+
+        case UART_BREAK:
+            // Bytes still buffered belong to the frame the break closes. The
+            // break length is not measured by the UART, report it as 0.
+            dmx_uart_rx_drain(uart, chunk);
+            dmx_decoder_feed_break(uart->rx_decoder, esp_timer_get_time(), 0);
+            break;
+
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            uart_flush_input(uart->uart_num);
+            xQueueReset(uart->event_queue);
+            dmx_decoder_reset(uart->rx_decoder);
+            uart->rx_overflows++;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    xSemaphoreGive(uart->rx_exited);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t dmx_uart_rx_start(dmx_transport_t *transport, dmx_decoder_frame_cb_t on_frame, void *arg)
+{
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)transport;
+
+    if (uart->rx_task != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uart->rx_decoder = (dmx_decoder_t *)calloc(1, sizeof(dmx_decoder_t));
+    if (uart->rx_decoder == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate receive decoder");
+        return ESP_ERR_NO_MEM;
+    }
+    dmx_decoder_init(uart->rx_decoder, on_frame, arg);
+
+    uart->rx_exited = xSemaphoreCreateBinary();
+    if (uart->rx_exited == NULL)
+    {
+        free(uart->rx_decoder);
+        uart->rx_decoder = NULL;
+        ESP_LOGE(TAG, "Failed to allocate receive task semaphore");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // A break arrives as a 0x00 with a framing error. Bytes with receive
+    // errors are kept out of the FIFO, so only that byte is dropped and a
+    // final slot of 0x00 reaches the decoder like any other value.
+    SET_PERI_REG_MASK(UART_CONF0_REG(uart->uart_num), UART_ERR_WR_MASK);
+
+    uart_set_rx_full_threshold(uart->uart_num, DMX_RX_FULL_THRESHOLD);
+    uart_set_rx_timeout(uart->uart_num, DMX_RX_TIMEOUT_SYMBOLS);
+    uart_flush_input(uart->uart_num);
+    xQueueReset(uart->event_queue);
+
+    uart->rx_running = true;
+    BaseType_t ret = xTaskCreate(dmx_uart_rx_task, "dmx_rx", DMX_RX_TASK_STACK_SIZE,
+                                 uart, DMX_RX_TASK_PRIORITY, &uart->rx_task);
+    if (ret != pdPASS)
+    {
+        uart->rx_running = false;
+        uart->rx_task = NULL;
+        vSemaphoreDelete(uart->rx_exited);
+        uart->rx_exited = NULL;
+        free(uart->rx_decoder);
+        uart->rx_decoder = NULL;
+        ESP_LOGE(TAG, "Failed to create DMX receive task");
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "DMX input started on UART%d", uart->uart_num);
+    return ESP_OK;
+}
+
+static esp_err_t dmx_uart_rx_stop(dmx_transport_t *transport)
+{
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)transport;
+
+    if (uart->rx_task == NULL)
+    {
+        return ESP_OK;
+    }
+
+    // Wake the task with an event it ignores so it sees the stop request,
+    // then wait until it has left the decoder for good
+    uart->rx_running = false;
+    uart_event_t wake = {.type = UART_EVENT_MAX};
+    xQueueSend(uart->event_queue, &wake, portMAX_DELAY);
+    xSemaphoreTake(uart->rx_exited, portMAX_DELAY);
+    vSemaphoreDelete(uart->rx_exited);
+    uart->rx_exited = NULL;
+    uart->rx_task = NULL;
+
+    free(uart->rx_decoder);
+    uart->rx_decoder = NULL;
+
+    ESP_LOGI(TAG, "DMX input stopped (%lu overflows)", (unsigned long)uart->rx_overflows);
+    return ESP_OK;
+}
+
+static esp_err_t dmx_uart_del(dmx_transport_t *transport)
+{
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)transport;
+
+    dmx_uart_rx_stop(transport);
+
+    uart_driver_delete(uart->uart_num);
+    gpio_reset_pin(uart->enable_pin);
+    if (uart->allocated)
+    {
+        free(uart);
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief UART TX ring size
+ *
+ * Room for one complete frame of the universe in either frame mode. A
+ * truncated frame grows to the whole universe once the input merge carries
+ * more slots, and a frame that doesn't fit would block the TX task in
+ * uart_write_bytes_with_break() while the ISR drains the ring.
+ */
+static int dmx_uart_tx_ring_size(const dmx_config_t *config)
+{
+    int size = config->universe_size + 1 + DMX_TX_RING_OVERHEAD;
+    return (size > DMX_TX_RING_MIN_SIZE) ? size : DMX_TX_RING_MIN_SIZE;
+}
+
+esp_err_t dmx_uart_transport_init(dmx_uart_transport_t *uart, const dmx_config_t *config,
+                                  dmx_transport_t **out_transport)
+{
+    if (uart == NULL || config == NULL || out_transport == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uart->base.send_break = dmx_uart_send_break;
+    uart->base.write = dmx_uart_write;
+    uart->base.wait_done = dmx_uart_wait_done;
+    uart->base.rx_start = dmx_uart_rx_start;
+    uart->base.rx_stop = dmx_uart_rx_stop;
+    uart->base.del = dmx_uart_del;
+    uart->uart_num = config->uart_num;
+    uart->enable_pin = config->enable_pin;
+    uart->allocated = false;
+    uart->event_queue = NULL;
+    uart->rx_task = NULL;
+    uart->rx_exited = NULL;
+    uart->rx_decoder = NULL;
+    uart->rx_running = false;
+    uart->rx_overflows = 0;
+
+    // Configure RS-485 enable pin
+    gpio_config_t io_conf = {
+        .intr_type = GPIO_INTR_DISABLE,
+        .mode = GPIO_MODE_OUTPUT,
+        .pin_bit_mask = (1ULL << uart->enable_pin),
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .pull_up_en = GPIO_PULLUP_DISABLE};
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to configure enable pin");
+        return ret;
+    }
+
+    // Set RS-485 to transmit mode
+    gpio_set_level(uart->enable_pin, 1);
+
+    // Configure UART
+    uart_config_t uart_config = {
+        .baud_rate = DMX_BAUD_RATE,
+        .data_bits = DMX_DATA_BITS,
+        .parity = DMX_PARITY,
+        .stop_bits = DMX_STOP_BITS,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+
+    ret = uart_param_config(uart->uart_num, &uart_config);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "UART param config failed");
+        gpio_reset_pin(uart->enable_pin);
+        return ret;
+    }
+
+    ret = uart_set_pin(uart->uart_num, config->tx_pin, config->rx_pin,
+                       UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "UART set pin failed");
+        gpio_reset_pin(uart->enable_pin);
+        return ret;
+    }
+
+    ret = uart_driver_install(uart->uart_num, DMX_RX_BUFFER_SIZE, dmx_uart_tx_ring_size(config),
+                              DMX_RX_EVENT_QUEUE_SIZE, &uart->event_queue, 0);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "UART driver install failed");
+        gpio_reset_pin(uart->enable_pin);
+        return ret;
+    }
+
+    if (config->tx_mode == DMX_TX_MODE_HW_BREAK)
+    {
+        // The UART idles for MAB between the trailing break and the next frame
+        ret = uart_set_tx_idle_num(uart->uart_num, DMX_MAB_BITS);
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "UART set TX idle failed");
+            uart_driver_delete(uart->uart_num);
+            gpio_reset_pin(uart->enable_pin);
+            return ret;
+        }
+    }
+
+    *out_transport = &uart->base;
+    return ESP_OK;
+}
+
+esp_err_t dmx_uart_transport_create(const dmx_config_t *config, dmx_transport_t **out_transport)
+{
+    if (config == NULL || out_transport == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_uart_transport_t *uart = (dmx_uart_transport_t *)calloc(1, sizeof(dmx_uart_transport_t));
+    if (uart == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate UART transport");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = dmx_uart_transport_init(uart, config, out_transport);
+    if (ret != ESP_OK)
+    {
+        free(uart);
+        return ret;
+    }
+
+    uart->allocated = true;
+    return ESP_OK;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file dmx_transport_uart.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Built-in UART/RS-485 DMX transport (driver internal)
+ */
+
+#ifndef DMX_TRANSPORT_UART_H
+#define DMX_TRANSPORT_UART_H
+
+#include "dmx_driver.h"
+#include "dmx_transport.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief UART transport context
+     */
+    typedef struct
+    {
+        dmx_transport_t base; // Must stay first
+        uart_port_t uart_num;
+        gpio_num_t enable_pin;
+        bool allocated;       // Created by dmx_uart_transport_create(), freed on del
+        QueueHandle_t event_queue; // UART driver events (data, break, overflow)
+        TaskHandle_t rx_task;      // Receive task, NULL when input is off
+        SemaphoreHandle_t rx_exited; // Given by the receive task as it exits
+        dmx_decoder_t *rx_decoder; // Frame assembly for the receive task
+        volatile bool rx_running;
+        uint32_t rx_overflows;     // Receive FIFO or ring overflows, each drops a frame
+    } dmx_uart_transport_t;
+
+    /**
+     * @brief Set up the UART transport in caller-provided storage
+     *
+     * Same as dmx_uart_transport_create() without allocating the context.
+     *
+     * @param uart Storage for the transport, must outlive it
+     * @param config DMX configuration (pins, UART port, TX and frame mode)
+     * @param out_transport Pointer to store the transport
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - Others: UART or GPIO configuration failed
+     */
+    esp_err_t dmx_uart_transport_init(dmx_uart_transport_t *uart, const dmx_config_t *config,
+                                      dmx_transport_t **out_transport);
+
+    /**
+     * @brief Create the UART transport described by a DMX configuration
+     *
+     * Configures the RS-485 enable pin, the UART parameters and pins, and
+     * installs the UART driver.
+     *
+     * @param config DMX configuration (pins, UART port, TX and frame mode)
+     * @param out_transport Pointer to store the transport
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: Out of memory
+     *      - Others: UART or GPIO configuration failed
+     */
+    esp_err_t dmx_uart_transport_create(const dmx_config_t *config, dmx_transport_t **out_transport);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMX_TRANSPORT_UART_H
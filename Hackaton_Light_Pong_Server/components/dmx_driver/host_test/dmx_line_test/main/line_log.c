@@ -0,0 +1,93 @@
+/**
+ * @file line_log.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief DMX universe on the virtual line, with a summary of every decoded frame
+ */
+
+#include <string.h>
+#include "unity.h"
+#include "line_log.h"
+
+static void line_log_frame(const dmx_decoded_frame_t *frame, void *arg)
+{
+    line_log_t *log = (line_log_t *)arg;
+
+    if (log->frames == 0)
+    {
+        log->first = *frame;
+        log->first_us = frame->timestamp_us;
+    }
+    else
+    {
+        uint32_t gap_us = (uint32_t)(frame->timestamp_us - log->last_us);
+        if (gap_us < log->gap_min_us)
+        {
+            log->gap_min_us = gap_us;
+        }
+        if (frame->slots != log->last.slots ||
+            memcmp(frame->data, log->last.data, frame->slots + 1) != 0)
+        {
+            log->changes++;
+        }
+    }
+
+    if (log->check && !log->check(frame, log->check_arg))
+    {
+        log->rejected++;
+    }
+    if (frame->slots < log->slots_min)
+    {
+        log->slots_min = frame->slots;
+    }
+    if (frame->slots > log->slots_max)
+    {
+        log->slots_max = frame->slots;
+    }
+
+    log->last = *frame;
+    log->last_us = frame->timestamp_us;
+    log->frames++;
+}
+
+dmx_handle_t line_log_open(line_log_t *log, dmx_tx_mode_t tx_mode, dmx_frame_mode_t frame_mode,
+                           line_log_check_t check, void *check_arg)
+{
+    memset(log, 0, sizeof(*log));
+    log->slots_min = UINT16_MAX;
+    log->gap_min_us = UINT32_MAX;
+    log->check = check;
+    log->check_arg = check_arg;
+
+    dmx_linux_transport_config_t line_config = {
+        .on_frame = line_log_frame,
+        .on_frame_arg = log,
+    };
+    TEST_ESP_OK(dmx_linux_transport_create(&line_config, &log->line));
+
+    dmx_config_t config = {
+        .universe_size = DMX_UNIVERSE_SIZE,
+        .tx_mode = tx_mode,
+        .frame_mode = frame_mode,
+        .transport = log->line,
+    };
+    dmx_handle_t dmx = NULL;
+    TEST_ESP_OK(dmx_init(&config, &dmx));
+    return dmx;
+}
+
+void line_log_close(line_log_t *log, dmx_handle_t dmx)
+{
+    TEST_ESP_OK(dmx_deinit(dmx));
+    TEST_ESP_OK(log->line->del(log->line));
+    log->line = NULL;
+}
+
+uint32_t line_log_period_us(const line_log_t *log)
+{
+    if (log->frames < 2)
+    {
+        return 0;
+    }
+    return (uint32_t)((log->last_us - log->first_us) / (log->frames - 1));
+}
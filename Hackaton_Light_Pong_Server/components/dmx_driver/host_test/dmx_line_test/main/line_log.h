@@ -0,0 +1,74 @@
+/**
+ * @file line_log.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief DMX universe on the virtual line, with a summary of every decoded frame
+ */
+
+#ifndef LINE_LOG_H
+#define LINE_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dmx_driver.h"
+#include "dmx_transport_linux.h"
+
+#define LINE_FULL_PERIOD_US (1000000 / 44) // DMX_FRAME_FULL refresh, 44Hz
+
+/**
+ * @brief Per-frame check supplied by a test
+ *
+ * @return true if the frame is what the test expects on the line
+ */
+typedef bool (*line_log_check_t)(const dmx_decoded_frame_t *frame, void *arg);
+
+/**
+ * @brief What the decoder saw on the line
+ *
+ * Written from the DMX TX task; read it once the universe is closed.
+ */
+typedef struct
+{
+    dmx_transport_t *line;   // Virtual line the universe transmits on
+    line_log_check_t check;  // Applied to every frame, may be NULL
+    void *check_arg;
+    uint32_t frames;         // Frames decoded
+    uint32_t rejected;       // Frames the check rejected
+    uint32_t changes;        // Frames whose data differs from the frame before
+    int64_t first_us;        // Break that opened the first frame
+    int64_t last_us;         // Break that opened the last frame
+    uint32_t gap_min_us;     // Shortest break-to-break time
+    uint16_t slots_min;
+    uint16_t slots_max;
+    dmx_decoded_frame_t first; // First frame on the line
+    dmx_decoded_frame_t last;  // Last frame on the line
+} line_log_t;
+
+/**
+ * @brief Create a full-size universe on a new virtual line
+ *
+ * @param log Log to reset and fill from the line
+ * @param tx_mode How break and MAB are generated
+ * @param frame_mode Full universe or truncated frames
+ * @param check Per-frame check, NULL for none
+ * @param check_arg Argument passed to check
+ * @return DMX handle, transmission not started
+ */
+dmx_handle_t line_log_open(line_log_t *log, dmx_tx_mode_t tx_mode, dmx_frame_mode_t frame_mode,
+                           line_log_check_t check, void *check_arg);
+
+/**
+ * @brief Delete the universe and its line
+ *
+ * Every frame that reached the line has been logged once this returns.
+ */
+void line_log_close(line_log_t *log, dmx_handle_t dmx);
+
+/**
+ * @brief Mean break-to-break time of the logged frames
+ *
+ * @return Period in microseconds, 0 with fewer than two frames
+ */
+uint32_t line_log_period_us(const line_log_t *log);
+
+#endif // LINE_LOG_H
@@ -0,0 +1,137 @@
+/**
+ * @file test_dmx_handoff.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Frame hand-off between writers and the TX task: setter latency and tearing
+ */
+
+#include <stdio.h>
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "line_log.h"
+
+#define HANDOFF_SEQ_SLOTS 3 // Channels 1-3 carry a 24-bit frame sequence
+
+/**
+ * @brief Sequence checked across frames by frame_is_whole()
+ */
+typedef struct
+{
+    uint32_t last_seq;
+    uint32_t backwards; // Frames older than the one before them
+} handoff_check_t;
+
+static uint8_t handoff_value(uint32_t seq, uint16_t channel)
+{
+    return (uint8_t)(seq * 31 + channel);
+}
+
+static void handoff_fill(uint8_t *frame, uint32_t seq)
+{
+    frame[0] = (uint8_t)(seq >> 16);
+    frame[1] = (uint8_t)(seq >> 8);
+    frame[2] = (uint8_t)seq;
+    for (uint16_t channel = HANDOFF_SEQ_SLOTS + 1; channel <= DMX_UNIVERSE_SIZE; channel++)
+    {
+        frame[channel - 1] = handoff_value(seq, channel);
+    }
+}
+
+static bool frame_is_whole(const dmx_decoded_frame_t *frame, void *arg)
+{
+    handoff_check_t *check = (handoff_check_t *)arg;
+    uint32_t seq = ((uint32_t)frame->data[1] << 16) | ((uint32_t)frame->data[2] << 8) | frame->data[3];
+
+    if (seq < check->last_seq)
+    {
+        check->backwards++;
+    }
+    check->last_seq = seq;
+
+    for (uint16_t channel = HANDOFF_SEQ_SLOTS + 1; channel <= frame->slots; channel++)
+    {
+        if (frame->data[channel] != handoff_value(seq, channel))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("setters don't wait for the TX task", "[dmx_handoff]")
+{
+    line_log_t log;
+    dmx_handle_t dmx = line_log_open(&log, DMX_TX_MODE_HW_BREAK, DMX_FRAME_FULL, NULL, NULL);
+    TEST_ESP_OK(dmx_start_transmission(dmx));
+
+    // Sample across many frames so some setters race the TX task's hand-off
+    const uint32_t samples = 4000;
+    uint32_t min_us = UINT32_MAX;
+    uint32_t max_us = 0;
+    uint64_t total_us = 0;
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        int64_t start = esp_timer_get_time();
+        TEST_ESP_OK(dmx_set_channel(dmx, (uint16_t)(i % DMX_UNIVERSE_SIZE + 1), (uint8_t)i));
+        uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start);
+
+        total_us += elapsed_us;
+        if (elapsed_us < min_us)
+        {
+            min_us = elapsed_us;
+        }
+        if (elapsed_us > max_us)
+        {
+            max_us = elapsed_us;
+        }
+        if (i % 16 == 15)
+        {
+            vTaskDelay(1);
+        }
+    }
+
+    TEST_ESP_OK(dmx_stop_transmission(dmx));
+    line_log_close(&log, dmx);
+
+    printf("dmx_set_channel over %lu frames: min %lu us, avg %lu us, max %lu us\n",
+           (unsigned long)log.frames, (unsigned long)min_us,
+           (unsigned long)(total_us / samples), (unsigned long)max_us);
+    TEST_ASSERT_GREATER_THAN_UINT32(10, log.frames);
+    TEST_ASSERT_LESS_THAN_UINT32(LINE_FULL_PERIOD_US / 4, max_us);
+}
+
+TEST_CASE("published frames never tear", "[dmx_handoff]")
+{
+    handoff_check_t check = {0};
+    line_log_t log;
+    dmx_handle_t dmx = line_log_open(&log, DMX_TX_MODE_HW_BREAK, DMX_FRAME_FULL, frame_is_whole, &check);
+    TEST_ESP_OK(dmx_start_transmission(dmx));
+
+    // Every publish replaces the whole universe, so any mix of two is visible
+    static uint8_t frame[DMX_UNIVERSE_SIZE];
+    uint32_t seq = 0;
+    int64_t end_us = esp_timer_get_time() + 1000000;
+    while (esp_timer_get_time() < end_us)
+    {
+        seq++;
+        handoff_fill(frame, seq);
+        TEST_ESP_OK(dmx_set_channels(dmx, 1, frame, DMX_UNIVERSE_SIZE));
+        if (seq % 16 == 0)
+        {
+            vTaskDelay(1);
+        }
+    }
+
+    TEST_ESP_OK(dmx_stop_transmission(dmx));
+    line_log_close(&log, dmx);
+
+    printf("%lu publishes, %lu frames, %lu changed, %lu torn, %lu out of order\n",
+           (unsigned long)seq, (unsigned long)log.frames, (unsigned long)log.changes,
+           (unsigned long)log.rejected, (unsigned long)check.backwards);
+    TEST_ASSERT_GREATER_THAN_UINT32(10, log.frames);
+    TEST_ASSERT_GREATER_THAN_UINT32(log.frames / 2, log.changes);
+    TEST_ASSERT_EQUAL_UINT32(0, log.rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, check.backwards);
+}
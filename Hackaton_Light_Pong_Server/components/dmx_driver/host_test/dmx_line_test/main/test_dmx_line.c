@@ -0,0 +1,124 @@
+/**
+ * @file test_dmx_line.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Refresh rate, frame atomicity and truncation as decoded from the virtual line
+ */
+
+#include <stdio.h>
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "line_log.h"
+
+static void run_for_ms(dmx_handle_t dmx, uint32_t ms)
+{
+    TEST_ESP_OK(dmx_start_transmission(dmx));
+    vTaskDelay(pdMS_TO_TICKS(ms));
+    TEST_ESP_OK(dmx_stop_transmission(dmx));
+}
+
+static bool frame_is_uniform(const dmx_decoded_frame_t *frame, void *arg)
+{
+    for (uint16_t slot = 2; slot <= frame->slots; slot++)
+    {
+        if (frame->data[slot] != frame->data[1])
+        {
+            return false;
+        }
+    }
+    return frame->data[0] == 0x00;
+}
+
+TEST_CASE("full universe refreshes at 44Hz in both TX modes", "[dmx_line]")
+{
+    const dmx_tx_mode_t modes[] = {DMX_TX_MODE_BUSY_WAIT, DMX_TX_MODE_HW_BREAK};
+
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        line_log_t log;
+        dmx_handle_t dmx = line_log_open(&log, modes[i], DMX_FRAME_FULL, frame_is_uniform, NULL);
+        run_for_ms(dmx, 1000);
+        line_log_close(&log, dmx);
+
+        printf("TX mode %d: %lu frames, %lu us apart\n", (int)modes[i],
+               (unsigned long)log.frames, (unsigned long)line_log_period_us(&log));
+        TEST_ASSERT_INT_WITHIN(4, 44, log.frames);
+        TEST_ASSERT_INT_WITHIN(LINE_FULL_PERIOD_US / 20, LINE_FULL_PERIOD_US, line_log_period_us(&log));
+        TEST_ASSERT_EQUAL_UINT16(DMX_UNIVERSE_SIZE, log.slots_min);
+        TEST_ASSERT_EQUAL_UINT16(DMX_UNIVERSE_SIZE, log.slots_max);
+        TEST_ASSERT_EQUAL_UINT32(0, log.rejected);
+    }
+}
+
+TEST_CASE("transactions reach the line as whole frames", "[dmx_line]")
+{
+    line_log_t log;
+    dmx_handle_t dmx = line_log_open(&log, DMX_TX_MODE_HW_BREAK, DMX_FRAME_FULL, frame_is_uniform, NULL);
+    TEST_ESP_OK(dmx_start_transmission(dmx));
+
+    // Rewrite the universe one channel at a time, far faster than it is sent
+    uint8_t value = 0;
+    int64_t end_us = esp_timer_get_time() + 500000;
+    while (esp_timer_get_time() < end_us)
+    {
+        value++;
+        TEST_ESP_OK(dmx_begin(dmx));
+        for (uint16_t channel = 1; channel <= DMX_UNIVERSE_SIZE; channel++)
+        {
+            TEST_ESP_OK(dmx_set_channel(dmx, channel, value));
+        }
+        TEST_ESP_OK(dmx_commit(dmx));
+        vTaskDelay(1);
+    }
+
+    TEST_ESP_OK(dmx_stop_transmission(dmx));
+    line_log_close(&log, dmx);
+
+    printf("%lu frames, %lu changed, %lu torn\n", (unsigned long)log.frames,
+           (unsigned long)log.changes, (unsigned long)log.rejected);
+    TEST_ASSERT_GREATER_THAN_UINT32(10, log.frames);
+    TEST_ASSERT_GREATER_THAN_UINT32(log.frames / 2, log.changes);
+    TEST_ASSERT_EQUAL_UINT32(0, log.rejected);
+}
+
+TEST_CASE("truncated frames end at the highest patched or written channel", "[dmx_line]")
+{
+    line_log_t log;
+    dmx_handle_t dmx = line_log_open(&log, DMX_TX_MODE_HW_BREAK, DMX_FRAME_TRUNCATED, NULL, NULL);
+
+    // A fixture on 1-12 whose last channel is at 0x00: the frame still ends there
+    uint8_t values[12] = {0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80, 0x90, 0xa0, 0xb0, 0x00};
+    TEST_ESP_OK(dmx_patch(dmx, 1, sizeof(values)));
+    TEST_ESP_OK(dmx_set_channels(dmx, 1, values, sizeof(values)));
+
+    run_for_ms(dmx, 200);
+    uint32_t short_frames = log.frames;
+    uint32_t short_period_us = line_log_period_us(&log);
+
+    // Writing past the patch grows the frame to the written channel
+    TEST_ESP_OK(dmx_set_channel(dmx, 40, 0xff));
+    run_for_ms(dmx, 100);
+
+    // Clearing zeroes the frame without growing it to the universe size
+    TEST_ESP_OK(dmx_clear_all(dmx));
+    run_for_ms(dmx, 100);
+    line_log_close(&log, dmx);
+
+    printf("%lu frames of 12 slots, %lu us apart, at least %lu\n", (unsigned long)short_frames,
+           (unsigned long)short_period_us, (unsigned long)log.gap_min_us);
+    TEST_ASSERT_EQUAL_UINT16(12, log.first.slots);
+    TEST_ASSERT_EQUAL_HEX8(0x00, log.first.data[0]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(values, &log.first.data[1], sizeof(values));
+    TEST_ASSERT_EQUAL_UINT16(12, log.slots_min);
+
+    // Never faster than DMX512 allows, far faster than a full universe
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(DMX_MIN_PACKET_US, log.gap_min_us);
+    TEST_ASSERT_LESS_THAN_UINT32(LINE_FULL_PERIOD_US / 4, short_period_us);
+
+    TEST_ASSERT_EQUAL_UINT16(40, log.last.slots);
+    TEST_ASSERT_EQUAL_UINT16(40, log.slots_max);
+    TEST_ASSERT_EQUAL_HEX8(0x00, log.last.data[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, log.last.data[40]);
+}
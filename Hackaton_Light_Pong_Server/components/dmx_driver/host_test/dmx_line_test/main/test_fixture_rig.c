@@ -0,0 +1,143 @@
+/**
+ * @file test_fixture_rig.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Several MH-X25 heads on one universe through a fixture rig
+ */
+
+#include <stdio.h>
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "fixture.h"
+#include "mh_x25_driver.h"
+#include "line_log.h"
+
+#define RIG_HEAD_A 1   // DMX address of the first head
+#define RIG_HEAD_B 101 // DMX address of the second head
+
+/**
+ * @brief Both heads, moved one step per frame from the frame clock
+ */
+typedef struct
+{
+    fixture_handle_t a;
+    fixture_handle_t b;
+    uint8_t step;
+} rig_steps_t;
+
+/**
+ * @brief Set the same step on both heads, ahead of the rig's own frame callback
+ */
+static void rig_step_frame_cb(dmx_handle_t dmx, int64_t next_frame_us, void *arg)
+{
+    rig_steps_t *steps = (rig_steps_t *)arg;
+    if (steps->step == UINT8_MAX)
+    {
+        return;
+    }
+
+    steps->step++;
+    fixture_set(steps->a, FIXTURE_ATTR_PAN, (uint16_t)(steps->step * 0x101));
+    fixture_set(steps->a, FIXTURE_ATTR_DIMMER, steps->step);
+    fixture_set(steps->b, FIXTURE_ATTR_TILT, (uint16_t)(steps->step * 0x101));
+    fixture_set(steps->b, FIXTURE_ATTR_DIMMER, steps->step);
+}
+
+// Every channel the steps touch, on both heads, carries the same step
+static bool frame_heads_agree(const dmx_decoded_frame_t *frame, void *arg)
+{
+    const uint16_t channels[] = {
+        RIG_HEAD_A + MH_X25_CHANNEL_PAN,
+        RIG_HEAD_A + MH_X25_CHANNEL_PAN_FINE,
+        RIG_HEAD_A + MH_X25_CHANNEL_DIMMER,
+        RIG_HEAD_B + MH_X25_CHANNEL_TILT,
+        RIG_HEAD_B + MH_X25_CHANNEL_TILT_FINE,
+        RIG_HEAD_B + MH_X25_CHANNEL_DIMMER,
+    };
+
+    for (size_t i = 1; i < sizeof(channels) / sizeof(channels[0]); i++)
+    {
+        if (frame->data[channels[i]] != frame->data[channels[0]])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("fixtures at different addresses change in the same frame", "[fixture]")
+{
+    line_log_t log;
+    dmx_handle_t dmx = line_log_open(&log, DMX_TX_MODE_HW_BREAK, DMX_FRAME_FULL, frame_heads_agree, NULL);
+
+    // Registered before the rig, so each step is set before the rig writes
+    rig_steps_t steps = {0};
+    TEST_ESP_OK(dmx_add_frame_callback(dmx, rig_step_frame_cb, &steps));
+
+    fixture_rig_handle_t rig;
+    TEST_ESP_OK(fixture_rig_create(dmx, &rig));
+    TEST_ESP_OK(fixture_add(rig, &mh_x25_profile, RIG_HEAD_A, &steps.a));
+    TEST_ESP_OK(fixture_add(rig, &mh_x25_profile, RIG_HEAD_B, &steps.b));
+
+    TEST_ESP_OK(dmx_start_transmission(dmx));
+    vTaskDelay(pdMS_TO_TICKS(500));
+    TEST_ESP_OK(dmx_stop_transmission(dmx));
+
+    TEST_ESP_OK(dmx_remove_frame_callback(dmx, rig_step_frame_cb, &steps));
+    TEST_ESP_OK(fixture_rig_delete(rig));
+    line_log_close(&log, dmx);
+
+    printf("%lu frames, %lu changed, %lu with the heads apart\n", (unsigned long)log.frames,
+           (unsigned long)log.changes, (unsigned long)log.rejected);
+    TEST_ASSERT_GREATER_THAN_UINT32(10, log.frames);
+    TEST_ASSERT_GREATER_THAN_UINT32(log.frames / 2, log.changes);
+    TEST_ASSERT_EQUAL_UINT32(0, log.rejected);
+    TEST_ASSERT_NOT_EQUAL(0, log.last.data[RIG_HEAD_A + MH_X25_CHANNEL_DIMMER]);
+
+    // Channels between and around the heads are left alone
+    TEST_ASSERT_EQUAL_HEX8(0x00, log.last.data[RIG_HEAD_A + MH_X25_CHANNEL_TILT]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, log.last.data[RIG_HEAD_A + MH_X25_NUM_CHANNELS]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, log.last.data[RIG_HEAD_B + MH_X25_CHANNEL_PAN]);
+}
+
+TEST_CASE("overlapping fixtures and out-of-range values are refused", "[fixture]")
+{
+    line_log_t log;
+    dmx_handle_t dmx = line_log_open(&log, DMX_TX_MODE_HW_BREAK, DMX_FRAME_FULL, NULL, NULL);
+
+    fixture_rig_handle_t rig;
+    fixture_handle_t a;
+    fixture_handle_t b;
+    fixture_handle_t other;
+    TEST_ESP_OK(fixture_rig_create(dmx, &rig));
+    TEST_ESP_OK(fixture_add(rig, &mh_x25_profile, RIG_HEAD_A, &a));
+    TEST_ESP_OK(fixture_add(rig, &mh_x25_profile, RIG_HEAD_B, &b));
+
+    // Overlaps from above and from below; right next to a head is fine
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, fixture_add(rig, &mh_x25_profile, RIG_HEAD_A + 6, &other));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG,
+                      fixture_add(rig, &mh_x25_profile, RIG_HEAD_B - MH_X25_NUM_CHANNELS + 1, &other));
+    TEST_ESP_OK(fixture_add(rig, &mh_x25_profile, RIG_HEAD_A + MH_X25_NUM_CHANNELS, &other));
+
+    // Addresses off the universe
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, fixture_add(rig, &mh_x25_profile, 0, &other));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG,
+                      fixture_add(rig, &mh_x25_profile, DMX_UNIVERSE_SIZE - MH_X25_NUM_CHANNELS + 2, &other));
+
+    // 8-bit attributes stop at 255, 16-bit ones take the full range
+    uint16_t value;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, fixture_set(a, FIXTURE_ATTR_DIMMER, 256));
+    TEST_ESP_OK(fixture_get(a, FIXTURE_ATTR_DIMMER, &value));
+    TEST_ASSERT_EQUAL_UINT16(0, value);
+    TEST_ESP_OK(fixture_set(b, FIXTURE_ATTR_PAN, UINT16_MAX));
+    TEST_ESP_OK(fixture_get(b, FIXTURE_ATTR_PAN, &value));
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, value);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, fixture_set(a, FIXTURE_ATTR_COUNT, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, fixture_set_range(a, FIXTURE_ATTR_COLOR, "ultraviolet"));
+    TEST_ESP_OK(fixture_set_range(a, FIXTURE_ATTR_COLOR, "pink"));
+
+    TEST_ESP_OK(fixture_rig_delete(rig));
+    line_log_close(&log, dmx);
+}
@@ -0,0 +1,16 @@
+/**
+ * @file test_main.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Runs the DMX line tests and exits with their result
+ */
+
+#include <stdlib.h>
+#include "unity.h"
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    exit(UNITY_END() ? 1 : 0);
+}
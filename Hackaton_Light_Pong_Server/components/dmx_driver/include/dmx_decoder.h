@@ -0,0 +1,114 @@
+/**
+ * @file dmx_decoder.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief DMX512 line decoder
+ *
+ * Rebuilds timestamped DMX frames from a stream of break markers and bytes.
+ * Has no hardware or RTOS dependencies, so it runs on the target and on a
+ * Linux host alike.
+ */
+
+#ifndef DMX_DECODER_H
+#define DMX_DECODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DMX_DECODER_MAX_SLOTS 512 // Slots per universe
+
+    /**
+     * @brief One decoded DMX frame
+     */
+    typedef struct
+    {
+        int64_t timestamp_us; ///< Start of the break that opened the frame
+        uint32_t break_us;    ///< Length of that break
+        uint16_t slots;       ///< Channel slots received (excluding start code)
+        bool overrun;         ///< More than DMX_DECODER_MAX_SLOTS slots were received, extra bytes dropped
+        uint8_t data[DMX_DECODER_MAX_SLOTS + 1]; ///< Start code followed by the channel values
+    } dmx_decoded_frame_t;
+
+    /**
+     * @brief Called for every completed frame
+     *
+     * The frame is only valid for the duration of the call.
+     */
+    typedef void (*dmx_decoder_frame_cb_t)(const dmx_decoded_frame_t *frame, void *arg);
+
+    /**
+     * @brief Decoder state
+     */
+    typedef struct
+    {
+        dmx_decoded_frame_t frame; ///< Frame being assembled
+        bool in_frame;             ///< A break has been seen, bytes belong to frame
+        uint16_t received;         ///< Bytes received for frame, including start code
+        dmx_decoder_frame_cb_t on_frame;
+        void *on_frame_arg;
+        uint32_t frames;           ///< Frames completed
+        uint32_t stray_bytes;      ///< Bytes received outside a frame
+        uint32_t resyncs;          ///< Partial frames dropped by dmx_decoder_reset()
+    } dmx_decoder_t;
+
+    /**
+     * @brief Initialize a decoder
+     *
+     * @param decoder Decoder state
+     * @param on_frame Callback for completed frames
+     * @param arg Argument passed to the callback
+     */
+    void dmx_decoder_init(dmx_decoder_t *decoder, dmx_decoder_frame_cb_t on_frame, void *arg);
+
+    /**
+     * @brief Feed a break
+     *
+     * Completes the frame in progress and opens a new one.
+     *
+     * @param decoder Decoder state
+     * @param timestamp_us When the break started
+     * @param break_us Break length in microseconds
+     */
+    void dmx_decoder_feed_break(dmx_decoder_t *decoder, int64_t timestamp_us, uint32_t break_us);
+
+    /**
+     * @brief Feed received bytes
+     *
+     * Every byte is a slot, whatever its value. A receiver that reports the
+     * break as a byte (a UART's 0x00 with a framing error) must leave that
+     * byte out.
+     *
+     * @param decoder Decoder state
+     * @param data Received bytes
+     * @param length Number of bytes
+     */
+    void dmx_decoder_feed(dmx_decoder_t *decoder, const uint8_t *data, size_t length);
+
+    /**
+     * @brief Complete the frame in progress without waiting for the next break
+     *
+     * @param decoder Decoder state
+     */
+    void dmx_decoder_flush(dmx_decoder_t *decoder);
+
+    /**
+     * @brief Drop the frame in progress and wait for the next break
+     *
+     * Used after receive errors, when the bytes of the current frame can no
+     * longer be trusted.
+     *
+     * @param decoder Decoder state
+     */
+    void dmx_decoder_reset(dmx_decoder_t *decoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMX_DECODER_H
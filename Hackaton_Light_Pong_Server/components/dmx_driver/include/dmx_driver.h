@@ -6,15 +6,28 @@
  *
  * This driver implements DMX512 protocol over RS-485 using UART.
  * DMX512 is a unidirectional protocol commonly used for lighting control.
+ *
+ * Channel setters edit a back buffer and publish it to the transmitter with a
+ * single atomic buffer swap, so every transmitted frame is complete and
+ * consistent and writers never block on the UART.
  */
 
 #ifndef DMX_DRIVER_H
 #define DMX_DRIVER_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "dmx_transport.h"
+#if CONFIG_IDF_TARGET_LINUX
+typedef int uart_port_t; // Host builds have no UART/GPIO drivers, keep dmx_config_t layout
+typedef int gpio_num_t;
+#else
 #include "driver/uart.h"
 #include "driver/gpio.h"
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -26,6 +39,8 @@ extern "C"
 #define DMX_BREAK_US 92            // Break time in microseconds (88-1000us)
 #define DMX_MAB_US 12              // Mark After Break (8-1000us)
 #define DMX_PACKET_TIMEOUT_MS 1000 // Timeout for packet transmission
+#define DMX_SLOT_US 44             // One slot on the wire (11 bits at 250kbaud)
+#define DMX_MIN_PACKET_US 1204     // Minimum break-to-break time allowed by DMX512-A
 
 /* Default GPIO Configuration for Clownfish ESP32-C3 */
 /* Adjust these based on your actual board layout */
@@ -40,23 +55,128 @@ extern "C"
 #define DMX_PARITY UART_PARITY_DISABLE
 #define DMX_STOP_BITS UART_STOP_BITS_2
 
+/* Break and MAB expressed in UART bit times (4us each at 250kbaud), rounded up */
+#define DMX_BREAK_BITS ((DMX_BREAK_US * (DMX_BAUD_RATE / 1000) + 999) / 1000)
+#define DMX_MAB_BITS ((DMX_MAB_US * (DMX_BAUD_RATE / 1000) + 999) / 1000)
+
+    /**
+     * @brief DMX transmitter mode
+     */
+    typedef enum
+    {
+        DMX_TX_MODE_BUSY_WAIT = 0, ///< Break/MAB timed by the TX task with busy-wait delays
+        DMX_TX_MODE_HW_BREAK,      ///< Break/MAB generated by the UART, TX task never spins
+    } dmx_tx_mode_t;
+
+    /**
+     * @brief DMX frame length mode
+     */
+    typedef enum
+    {
+        DMX_FRAME_FULL = 0,  ///< Always send universe_size slots at the standard 44Hz
+        DMX_FRAME_TRUNCATED, ///< Send up to the highest patched or written channel, as fast as timing allows
+    } dmx_frame_mode_t;
+
     /**
      * @brief DMX Configuration Structure
      */
     typedef struct
     {
         gpio_num_t tx_pin;      ///< UART TX pin
-        gpio_num_t rx_pin;      ///< UART RX pin (optional, not used in TX-only mode)
+        gpio_num_t rx_pin;      ///< UART RX pin, upstream input for dmx_input_start() (optional)
         gpio_num_t enable_pin;  ///< RS-485 DE/RE control pin
         uart_port_t uart_num;   ///< UART port number
         uint16_t universe_size; ///< Number of DMX channels (1-512)
+        dmx_tx_mode_t tx_mode;  ///< How break and MAB are generated
+        dmx_frame_mode_t frame_mode; ///< Full universe or truncated high-refresh frames
+        dmx_transport_t *transport;  ///< Custom transport, NULL for the built-in UART (pins above).
+                                     ///< Owned by the caller and must outlive the DMX handle.
     } dmx_config_t;
 
+    /**
+     * @brief Timing of a transmitted DMX frame
+     *
+     * Timestamps are esp_timer_get_time() microseconds. start_us - published_us
+     * is the time the newest data waited for the wire.
+     */
+    typedef struct
+    {
+        uint32_t sequence;    ///< Frames sent since init
+        int64_t start_us;     ///< When the frame data was handed to the UART
+        int64_t published_us; ///< When the data in this frame was published by a writer
+        int64_t requested_us; ///< When dmx_request_frame() asked for this frame, 0 if not requested
+        uint16_t slots;       ///< Channel slots sent (excluding start code)
+        bool fresh;           ///< Frame carried newly published data
+    } dmx_frame_info_t;
+
+/* Histogram buckets: bucket i counts values below 4^(i+1) us, the last bucket is open-ended */
+#define DMX_STATS_HIST_BUCKETS 8
+
+    /**
+     * @brief DMX output timing statistics
+     *
+     * All times are in microseconds. Collected continuously; use
+     * dmx_reset_stats() to measure a specific window.
+     */
+    typedef struct
+    {
+        uint32_t frames_sent;         ///< Frames handed to the UART
+        uint32_t frames_fresh;        ///< Frames that carried newly published data
+        uint32_t frames_requested;    ///< Frames sent early because of dmx_request_frame()
+        uint32_t write_incomplete;    ///< UART accepted fewer bytes than the frame length
+        uint32_t write_failed;        ///< Break generation or UART write returned an error
+        uint32_t period_min_us;       ///< Shortest break-to-break period of regular frames
+        uint32_t period_max_us;       ///< Longest break-to-break period of regular frames
+        uint32_t jitter_max_us;       ///< Largest deviation from the nominal period
+        uint32_t jitter_hist[DMX_STATS_HIST_BUCKETS];     ///< Deviation from the nominal period
+        uint32_t break_min_us;        ///< Shortest break (busy-wait timing; nominal in hw-break mode)
+        uint32_t break_max_us;        ///< Longest break (busy-wait timing; nominal in hw-break mode)
+        uint32_t write_max_us;        ///< Longest UART write call
+        uint32_t write_hist[DMX_STATS_HIST_BUCKETS];      ///< UART write call duration
+        uint32_t mutex_waits;         ///< Writer lock acquisitions
+        uint32_t mutex_wait_max_us;   ///< Longest wait for the writer lock
+        uint32_t mutex_wait_hist[DMX_STATS_HIST_BUCKETS]; ///< Wait for the writer lock
+    } dmx_stats_t;
+
     /**
      * @brief DMX driver handle
      */
     typedef void *dmx_handle_t;
 
+    /**
+     * @brief Per-frame callback, see dmx_add_frame_callback()
+     *
+     * @param handle Universe that just sent a frame
+     * @param next_frame_us esp_timer time the next regular frame is due
+     * @param arg Argument passed to dmx_add_frame_callback()
+     */
+    typedef void (*dmx_frame_cb_t)(dmx_handle_t handle, int64_t next_frame_us, void *arg);
+
+#define DMX_FRAME_CALLBACKS_MAX 4 // Frame callbacks per universe
+
+/* Static allocation */
+#define DMX_TASK_STACK_SIZE 4096                     // TX task stack in bytes
+#define DMX_FRAME_POOL_SIZE (3 * (DMX_UNIVERSE_SIZE + 1)) // Triple-buffered start code + universe
+#define DMX_STATIC_CONTEXT_WORDS 96                  // Opaque driver state, size checked at build time
+
+    /**
+     * @brief Caller-provided storage for dmx_init_static()
+     *
+     * Holds everything the driver would otherwise allocate: context, the
+     * built-in UART transport, frame buffers, writer mutex and TX task with
+     * its exit semaphore. Must outlive the handle; usually a static variable.
+     * The contents are private to the driver.
+     */
+    typedef struct
+    {
+        uint64_t context[DMX_STATIC_CONTEXT_WORDS];
+        uint8_t frame_pool[DMX_FRAME_POOL_SIZE];
+        StaticSemaphore_t mutex;
+        StaticSemaphore_t tx_exited;
+        StaticTask_t task;
+        StackType_t task_stack[DMX_TASK_STACK_SIZE];
+    } dmx_static_t;
+
     /**
      * @brief Initialize DMX driver
      *
@@ -70,6 +190,23 @@ extern "C"
      */
     esp_err_t dmx_init(const dmx_config_t *config, dmx_handle_t *out_handle);
 
+    /**
+     * @brief Initialize DMX driver in caller-provided storage
+     *
+     * Same as dmx_init() without heap allocations by the driver itself, and
+     * dmx_start_transmission() then runs the TX task from the same storage.
+     * The UART driver and the pacing esp_timer still allocate internally.
+     *
+     * @param config Pointer to DMX configuration structure
+     * @param storage Storage for the driver, must outlive the handle
+     * @param out_handle Pointer to store the DMX handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_FAIL: UART configuration failed
+     */
+    esp_err_t dmx_init_static(const dmx_config_t *config, dmx_static_t *storage, dmx_handle_t *out_handle);
+
     /**
      * @brief Deinitialize DMX driver
      *
@@ -77,6 +214,7 @@ extern "C"
      * @return
      *      - ESP_OK: Success
      *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: Universe is part of a group
      */
     esp_err_t dmx_deinit(dmx_handle_t handle);
 
@@ -106,6 +244,22 @@ extern "C"
     esp_err_t dmx_set_channels(dmx_handle_t handle, uint16_t start_channel,
                                const uint8_t *data, uint16_t length);
 
+    /**
+     * @brief Declare a channel range as patched
+     *
+     * In DMX_FRAME_TRUNCATED mode frames always extend to the highest patched
+     * channel, even if it was never written. Fixture drivers call this for
+     * their footprint. Has no effect on the frame length in DMX_FRAME_FULL mode.
+     *
+     * @param handle DMX handle
+     * @param start_channel First patched channel (1-512)
+     * @param count Number of patched channels
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t dmx_patch(dmx_handle_t handle, uint16_t start_channel, uint16_t count);
+
     /**
      * @brief Get DMX channel value
      *
@@ -118,11 +272,45 @@ extern "C"
      */
     esp_err_t dmx_get_channel(dmx_handle_t handle, uint16_t channel, uint8_t *value);
 
+    /**
+     * @brief Begin a DMX transaction
+     *
+     * Channel writes made by the calling task until dmx_commit() are collected
+     * under a single lock and published together, so they always go out in the
+     * same frame. dmx_set_channel(), dmx_set_channels(), dmx_get_channel() and
+     * dmx_clear_all() may be used inside the transaction. Transactions nest;
+     * only the outermost dmx_commit() publishes. Other writers block until the
+     * transaction is committed, so keep it short and never delay inside it.
+     *
+     * @param handle DMX handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: Nesting limit reached
+     */
+    esp_err_t dmx_begin(dmx_handle_t handle);
+
+    /**
+     * @brief Commit a DMX transaction
+     *
+     * Publishes the channels changed since the outermost dmx_begin() as one
+     * frame. Nothing is published if no channel was written.
+     *
+     * @param handle DMX handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: The calling task has no transaction open
+     */
+    esp_err_t dmx_commit(dmx_handle_t handle);
+
     /**
      * @brief Transmit DMX packet
      *
      * Sends a complete DMX512 packet including break, MAB, and data.
      * This function should be called periodically (typically 44Hz or 25-44ms interval).
+     * The most recently published frame is sent; channel setters never wait for
+     * the UART. Only one task may act as the transmitter at a time.
      *
      * @param handle DMX handle
      * @return
@@ -132,16 +320,83 @@ extern "C"
      */
     esp_err_t dmx_transmit(dmx_handle_t handle);
 
+    /**
+     * @brief Request a frame as soon as possible
+     *
+     * Wakes the transmission task so the latest published data goes out as
+     * soon as the minimum spacing after the previous frame allows, instead of
+     * waiting for the next regular refresh slot. The regular cadence restarts
+     * from the early frame. Call after dmx_commit() for latency-critical changes.
+     *
+     * @param handle DMX handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: Continuous transmission not running
+     */
+    esp_err_t dmx_request_frame(dmx_handle_t handle);
+
+    /**
+     * @brief Run a callback on every transmitted frame
+     *
+     * The callback runs on the transmission task right after each frame has
+     * been handed to the transport, with the time the next regular frame is
+     * due, so it can compute and write the channels for exactly that frame
+     * (e.g. one step of an interpolated movement). Channel writes from the
+     * callback take the writer lock like any other writer; the callback must
+     * not block otherwise and should finish well within one frame period.
+     * Callbacks run in the order they were added.
+     *
+     * @param handle DMX handle
+     * @param callback Callback
+     * @param arg Argument passed to the callback
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: DMX_FRAME_CALLBACKS_MAX callbacks already added
+     */
+    esp_err_t dmx_add_frame_callback(dmx_handle_t handle, dmx_frame_cb_t callback, void *arg);
+
+    /**
+     * @brief Remove a callback added with dmx_add_frame_callback()
+     *
+     * The callback may still be running on the transmission task when this
+     * returns; it has finished once the next frame has been sent (see
+     * dmx_get_last_frame()).
+     *
+     * @param handle DMX handle
+     * @param callback Callback
+     * @param arg Argument it was added with
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NOT_FOUND: Callback was not added
+     */
+    esp_err_t dmx_remove_frame_callback(dmx_handle_t handle, dmx_frame_cb_t callback, void *arg);
+
+    /**
+     * @brief Get timing of the most recently transmitted frame
+     *
+     * @param handle DMX handle
+     * @param info Pointer to store the frame timing
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t dmx_get_last_frame(dmx_handle_t handle, dmx_frame_info_t *info);
+
     /**
      * @brief Start continuous DMX transmission
      *
-     * Starts a task that continuously transmits DMX packets at ~44Hz.
+     * Starts a task that continuously transmits DMX packets at ~44Hz, or in
+     * DMX_FRAME_TRUNCATED mode at the fastest rate the current frame length
+     * allows (never faster than one packet per DMX_MIN_PACKET_US).
      *
      * @param handle DMX handle
      * @return
      *      - ESP_OK: Success
      *      - ESP_ERR_INVALID_ARG: Invalid handle
-     *      - ESP_ERR_INVALID_STATE: Already running
+     *      - ESP_ERR_INVALID_STATE: Already running or part of a group
      */
     esp_err_t dmx_start_transmission(dmx_handle_t handle);
 
@@ -152,9 +407,48 @@ extern "C"
      * @return
      *      - ESP_OK: Success
      *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: Universe is part of a group
      */
     esp_err_t dmx_stop_transmission(dmx_handle_t handle);
 
+    /**
+     * @brief Get DMX output timing statistics
+     *
+     * @param handle DMX handle
+     * @param stats Pointer to store a consistent snapshot of the statistics
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t dmx_get_stats(dmx_handle_t handle, dmx_stats_t *stats);
+
+    /**
+     * @brief Reset DMX output timing statistics
+     *
+     * @param handle DMX handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t dmx_reset_stats(dmx_handle_t handle);
+
+    /**
+     * @brief Get the time the TX path spends blocked in the transport
+     *
+     * Measured with timestamps around every break, frame write and wait for
+     * the line to drain, over the last full second of continuous
+     * transmission. DMX_TX_MODE_BUSY_WAIT pays break, MAB and the whole
+     * frame here; DMX_TX_MODE_HW_BREAK only queueing the frame. Comparing
+     * the two modes gives the time the hardware break hands back.
+     *
+     * @param handle DMX handle
+     * @param us_per_second Pointer to store the blocked time in microseconds per second
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t dmx_get_tx_blocked(dmx_handle_t handle, uint32_t *us_per_second);
+
     /**
      * @brief Clear all DMX channels (set to 0)
      *
@@ -165,6 +459,176 @@ extern "C"
      */
     esp_err_t dmx_clear_all(dmx_handle_t handle);
 
+/* Upstream input merge */
+#define DMX_INPUT_HOLD_MS 1000 // Input is dropped from the merge after this long without a frame
+
+    /**
+     * @brief How input and game output share channels the game has not patched
+     */
+    typedef enum
+    {
+        DMX_MERGE_HTP = 0, ///< Highest takes precedence
+        DMX_MERGE_LTP,     ///< Latest change takes precedence
+    } dmx_merge_mode_t;
+
+    /**
+     * @brief Upstream input statistics
+     */
+    typedef struct
+    {
+        uint32_t frames;         ///< Frames with start code 0x00 merged
+        uint32_t frames_ignored; ///< Frames with an alternate start code
+        uint32_t frames_overrun; ///< Frames longer than DMX_UNIVERSE_SIZE slots
+        uint16_t slots;          ///< Slots in the most recent frame
+        int64_t last_frame_us;   ///< When the most recent frame was completed, 0 if none yet
+    } dmx_input_stats_t;
+
+    /**
+     * @brief Start merging an upstream universe into the output
+     *
+     * The UART transport receives on the configured rx_pin through its own
+     * RS-485 receiver (receive-only, independent of the output transceiver).
+     * Frames are split on break and handed to the TX path lock-free. Each
+     * transmitted frame merges the most recent input with the game output:
+     * channels claimed with dmx_patch() always carry the game value, all
+     * others are merged with the given mode. Once no input frame has arrived
+     * for DMX_INPUT_HOLD_MS the output is the game universe alone.
+     *
+     * In DMX_FRAME_TRUNCATED mode frames grow to cover the input slots.
+     *
+     * @param handle DMX handle
+     * @param mode Merge mode for channels not patched by the game
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_INVALID_STATE: Input already running
+     *      - ESP_ERR_NOT_SUPPORTED: Transport cannot receive
+     *      - ESP_ERR_NO_MEM: Out of memory
+     */
+    esp_err_t dmx_input_start(dmx_handle_t handle, dmx_merge_mode_t mode);
+
+    /**
+     * @brief Stop the upstream input and return to game-only output
+     *
+     * @param handle DMX handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t dmx_input_stop(dmx_handle_t handle);
+
+    /**
+     * @brief Get upstream input statistics
+     *
+     * @param handle DMX handle
+     * @param stats Pointer to store the statistics
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_INVALID_STATE: Input is not running
+     */
+    esp_err_t dmx_input_get_stats(dmx_handle_t handle, dmx_input_stats_t *stats);
+
+/* Multi-universe output */
+#define DMX_GROUP_MAX_UNIVERSES 4
+
+    /**
+     * @brief DMX universe group handle
+     *
+     * A group drives several universes from one scheduler task instead of
+     * one TX task per handle. The ESP32-C3 has two UARTs, so two UART
+     * universes need UART0 as well; move the console to USB-Serial-JTAG
+     * (CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG) before giving it to DMX. Further
+     * universes need custom transports.
+     */
+    typedef struct dmx_group_t *dmx_group_handle_t;
+
+    /**
+     * @brief Create a group from initialized universes
+     *
+     * The universes must not be transmitting. While grouped, their TX is
+     * started and stopped through the group; channel setters, transactions
+     * and dmx_request_frame() work per universe as before.
+     *
+     * Only DMX_TX_MODE_HW_BREAK universes can be grouped. They hand each
+     * frame to the transport and return; a DMX_TX_MODE_BUSY_WAIT universe
+     * would hold the shared task for its whole frame (about 22.7 ms at 512
+     * slots) and starve the others.
+     *
+     * @param universes Handles from dmx_init(), each on its own port
+     * @param count Number of universes (1 to DMX_GROUP_MAX_UNIVERSES)
+     * @param out_group Pointer to store the group handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments or duplicate universe
+     *      - ESP_ERR_INVALID_STATE: A universe is transmitting or already grouped
+     *      - ESP_ERR_NOT_SUPPORTED: A universe uses DMX_TX_MODE_BUSY_WAIT
+     *      - ESP_ERR_NO_MEM: Out of memory
+     */
+    esp_err_t dmx_group_create(const dmx_handle_t *universes, size_t count, dmx_group_handle_t *out_group);
+
+    /**
+     * @brief Delete a group, stopping it first
+     *
+     * The universes stay initialized and can be started on their own again.
+     *
+     * @param group Group handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t dmx_group_delete(dmx_group_handle_t group);
+
+    /**
+     * @brief Start transmission on all universes of a group
+     *
+     * Each universe keeps its own frame rate. First frames are spread over
+     * the period and frame starts on different universes are kept at least
+     * one break and MAB apart, so breaks never pile up.
+     *
+     * @param group Group handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: Already running
+     *      - ESP_FAIL: Scheduler task could not be created
+     */
+    esp_err_t dmx_group_start(dmx_group_handle_t group);
+
+    /**
+     * @brief Stop transmission on all universes of a group
+     *
+     * @param group Group handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t dmx_group_stop(dmx_group_handle_t group);
+
+    /**
+     * @brief Get statistics combined over all universes of a group
+     *
+     * Counters and histograms are summed, extremes are taken over all
+     * universes. Use dmx_get_stats() for a single universe.
+     *
+     * @param group Group handle
+     * @param stats Pointer to store the combined statistics
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t dmx_group_get_stats(dmx_group_handle_t group, dmx_stats_t *stats);
+
+    /**
+     * @brief Reset statistics of all universes of a group
+     *
+     * @param group Group handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t dmx_group_reset_stats(dmx_group_handle_t group);
+
 #ifdef __cplusplus
 }
 #endif
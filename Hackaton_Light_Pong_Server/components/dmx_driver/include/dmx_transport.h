@@ -0,0 +1,86 @@
+/**
+ * @file dmx_transport.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Byte transport underneath the DMX512 driver
+ *
+ * The DMX driver builds frames and paces them; a transport puts the bytes and
+ * breaks on the line, and optionally decodes frames arriving on its input. The built-in UART transport drives the RS-485 adapter,
+ * the Linux transport captures the line for host-side testing.
+ */
+
+#ifndef DMX_TRANSPORT_H
+#define DMX_TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "dmx_decoder.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct dmx_transport_t dmx_transport_t;
+
+    /**
+     * @brief Transport operations
+     *
+     * Embed this structure as the first member of a transport's context.
+     * All operations are called from the DMX TX path only.
+     */
+    struct dmx_transport_t
+    {
+        /**
+         * @brief Generate break and MAB in software
+         *
+         * Called once the previous frame has left the line. Blocks for the
+         * whole break and MAB.
+         *
+         * @param break_us Break length in microseconds
+         * @param mab_us Mark-after-break length in microseconds
+         * @param measured_break_us Pointer to store the break length actually produced
+         */
+        esp_err_t (*send_break)(dmx_transport_t *transport, uint32_t break_us, uint32_t mab_us,
+                                uint32_t *measured_break_us);
+
+        /**
+         * @brief Queue frame bytes for transmission
+         *
+         * @param break_bits If non-zero, the transport appends a break of this
+         *                   many bit times plus MAB after the data (opening the
+         *                   next frame) without blocking the caller
+         * @return Number of bytes accepted, or -1 on error
+         */
+        int (*write)(dmx_transport_t *transport, const uint8_t *data, size_t length, uint32_t break_bits);
+
+        /**
+         * @brief Wait until all queued bytes have left the line
+         */
+        esp_err_t (*wait_done)(dmx_transport_t *transport, uint32_t timeout_ms);
+
+        /**
+         * @brief Start receiving frames from the line's input side
+         *
+         * Optional, NULL if the transport cannot receive. Completed frames
+         * are delivered from the transport's own context.
+         */
+        esp_err_t (*rx_start)(dmx_transport_t *transport, dmx_decoder_frame_cb_t on_frame, void *arg);
+
+        /**
+         * @brief Stop receiving; no callbacks are made once this returns
+         */
+        esp_err_t (*rx_stop)(dmx_transport_t *transport);
+
+        /**
+         * @brief Release the transport and its resources
+         */
+        esp_err_t (*del)(dmx_transport_t *transport);
+    };
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMX_TRANSPORT_H
@@ -0,0 +1,112 @@
+/**
+ * @file dmx_transport_linux.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Virtual DMX line for Linux host builds
+ *
+ * Stands in for the UART when the project is built for the ESP-IDF linux
+ * target. Bytes and breaks are timestamped as they would appear on a
+ * 250kbaud line, optionally recorded raw, and decoded back into DMX frames
+ * so refresh rate, frame atomicity and truncation can be checked without
+ * an RS-485 adapter.
+ */
+
+#ifndef DMX_TRANSPORT_LINUX_H
+#define DMX_TRANSPORT_LINUX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "dmx_transport.h"
+#include "dmx_decoder.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief One event on the virtual line
+     */
+    typedef struct
+    {
+        int64_t timestamp_us; ///< Line time the event started
+        uint16_t value;       ///< Byte value, or break length in microseconds
+        bool is_break;        ///< Break marker instead of a data byte
+    } dmx_capture_event_t;
+
+    /**
+     * @brief Linux transport configuration
+     */
+    typedef struct
+    {
+        dmx_capture_event_t *capture; ///< Raw capture storage, NULL to only decode
+        size_t capture_capacity;      ///< Number of events capture can hold
+        dmx_decoder_frame_cb_t on_frame; ///< Called for every decoded frame, may be NULL
+        void *on_frame_arg;           ///< Argument passed to on_frame
+    } dmx_linux_transport_config_t;
+
+    /**
+     * @brief Create a virtual line transport
+     *
+     * Pass the result as dmx_config_t.transport.
+     *
+     * @param config Transport configuration
+     * @param out_transport Pointer to store the transport
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: Out of memory
+     */
+    esp_err_t dmx_linux_transport_create(const dmx_linux_transport_config_t *config,
+                                         dmx_transport_t **out_transport);
+
+    /**
+     * @brief Get the raw capture recorded so far
+     *
+     * @param transport Transport created by dmx_linux_transport_create()
+     * @param count Pointer to store the number of recorded events
+     * @param dropped Pointer to store the number of events that did not fit, may be NULL
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t dmx_linux_transport_get_capture(dmx_transport_t *transport, size_t *count, size_t *dropped);
+
+    /**
+     * @brief Deliver a frame to the transport's input side
+     *
+     * Stands in for an upstream console: the frame is decoded as if it had
+     * arrived after a break, and handed to the receiver started by the DMX
+     * driver. Called from the test's own task.
+     *
+     * @param transport Transport created by dmx_linux_transport_create()
+     * @param data Start code followed by the channel values
+     * @param length Number of bytes, including the start code
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_INVALID_STATE: Input is not started
+     */
+    esp_err_t dmx_linux_transport_receive(dmx_transport_t *transport, const uint8_t *data, size_t length);
+
+    /**
+     * @brief Decode a raw capture into frames
+     *
+     * Replays the events through a decoder; the frame in progress at the
+     * end of the capture is completed as well.
+     *
+     * @param events Captured events
+     * @param count Number of events
+     * @param on_frame Called for every decoded frame
+     * @param arg Argument passed to on_frame
+     */
+    void dmx_decode_capture(const dmx_capture_event_t *events, size_t count,
+                            dmx_decoder_frame_cb_t on_frame, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMX_TRANSPORT_LINUX_H
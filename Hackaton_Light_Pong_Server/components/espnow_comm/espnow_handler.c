@@ -13,6 +13,8 @@
 #include "nvs_flash.h"
 #include "esp_event.h"
 #include "esp_netif.h"
+#include "esp_timer.h"
+#include <math.h>
 #include <string.h>
 
 static const char *TAG = "espnow_handler";
@@ -24,19 +26,78 @@ static const char *TAG = "espnow_handler";
 static const uint8_t BROADCAST_MAC[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
 // Context for communication with game controller
-static EventGroupHandle_t paddle_events = NULL;
-static volatile uint8_t *last_btn_left_pressed = NULL;
-static volatile uint8_t *last_btn_right_pressed = NULL;
+static QueueHandle_t paddle_hits = NULL;
+
+// Hit counters, written from the receive callback and read by espnow_get_hit_stats()
+static uint32_t hits_received = 0;
+static uint32_t hits_dropped = 0;
+static uint16_t hits_max_depth = 0;
+static portMUX_TYPE hit_lock = portMUX_INITIALIZER_UNLOCKED; // Guards the hit counters
 
 // Dynamic player registry
 static uint8_t player_macs[MAX_PLAYERS][6];
 static uint8_t num_players = 0;
 
-void espnow_set_context(EventGroupHandle_t events, volatile uint8_t *btn_left, volatile uint8_t *btn_right)
+// Recent time sync replies of a paddle, written only from the receive callback
+typedef struct
+{
+    int64_t offset_us[ESPNOW_SYNC_SAMPLES];
+    int32_t rtt_us[ESPNOW_SYNC_SAMPLES];
+    uint8_t count;
+    uint8_t next;
+} sync_history_t;
+
+static sync_history_t sync_history[MAX_PLAYERS];
+static espnow_paddle_clock_t paddle_clocks[MAX_PLAYERS];
+static portMUX_TYPE clock_lock = portMUX_INITIALIZER_UNLOCKED; // Guards paddle_clocks
+static uint8_t sync_seq = 0;
+
+void espnow_set_context(QueueHandle_t hits)
+{
+    paddle_hits = hits;
+}
+
+void espnow_get_hit_stats(espnow_hit_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&hit_lock);
+    stats->received = hits_received;
+    stats->dropped = hits_dropped;
+    stats->max_depth = hits_max_depth;
+    portEXIT_CRITICAL(&hit_lock);
+    stats->depth = (paddle_hits != NULL) ? (uint16_t)uxQueueMessagesWaiting(paddle_hits) : 0;
+}
+
+void espnow_get_paddle_clock(uint8_t player_id, espnow_paddle_clock_t *clock)
 {
-    paddle_events = events;
-    last_btn_left_pressed = btn_left;
-    last_btn_right_pressed = btn_right;
+    if (clock == NULL)
+    {
+        return;
+    }
+
+    if (player_id == 0 || player_id > MAX_PLAYERS)
+    {
+        memset(clock, 0, sizeof(*clock));
+        return;
+    }
+
+    portENTER_CRITICAL(&clock_lock);
+    *clock = paddle_clocks[player_id - 1];
+    portEXIT_CRITICAL(&clock_lock);
+}
+
+// Forget a paddle's clock, e.g. after it rebooted
+static void reset_paddle_clock(uint8_t player_id)
+{
+    memset(&sync_history[player_id - 1], 0, sizeof(sync_history_t));
+
+    portENTER_CRITICAL(&clock_lock);
+    memset(&paddle_clocks[player_id - 1], 0, sizeof(espnow_paddle_clock_t));
+    portEXIT_CRITICAL(&clock_lock);
 }
 
 uint8_t espnow_get_num_players(void)
@@ -64,6 +125,9 @@ static void handle_hello_message(const uint8_t *mac_addr)
     {
         ESP_LOGI(TAG, "Player already registered as ID %d", existing_id);
 
+        // A paddle only says hello again after a restart, which resets its clock
+        reset_paddle_clock(existing_id);
+
         // Send assignment confirmation via broadcast (client may not have added us as peer yet)
         server_assign_t assign = {
             .type = MSG_SERVER_ASSIGN,
@@ -96,6 +160,7 @@ static void handle_hello_message(const uint8_t *mac_addr)
     memcpy(player_macs[num_players], mac_addr, 6);
     num_players++;
     uint8_t assigned_id = num_players;
+    reset_paddle_clock(assigned_id);
 
     esp_now_peer_info_t peer = {0};
     memcpy(peer.peer_addr, mac_addr, 6);
@@ -128,51 +193,191 @@ static void handle_hello_message(const uint8_t *mac_addr)
     }
 }
 
-static void handle_paddle_input(const uint8_t *mac_addr, const uint8_t *data, int len)
+// Float sensor value to a saturated fixed-point int16
+static int16_t to_fixed(float value, float scale)
 {
-    if (len < sizeof(input_event_t))
+    float scaled = roundf(value * scale);
+    if (isnan(scaled))
     {
-        ESP_LOGW(TAG, "Invalid paddle input size: %d", len);
+        return 0;
+    }
+    if (scaled >= INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (scaled <= INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)scaled;
+}
+
+static void handle_time_sync_reply(const uint8_t *mac_addr, const uint8_t *data, int len)
+{
+    int64_t now_us = esp_timer_get_time();
+
+    if (len != sizeof(time_sync_t))
+    {
+        ESP_LOGW(TAG, "Invalid time sync reply size: %d", len);
         return;
     }
 
-    input_event_t *m = (input_event_t *)data;
     uint8_t player_id = espnow_get_player_id(mac_addr);
-
     if (player_id == 0)
     {
-        ESP_LOGW(TAG, "Received input from unregistered player");
         return;
     }
 
-    if (player_id == 1)
+    // Copied out, the receive buffer need not be aligned for the 64-bit fields
+    time_sync_t m;
+    memcpy(&m, data, sizeof(m));
+
+    int64_t rtt_us = now_us - m.server_us;
+    if (rtt_us <= 0 || rtt_us > ESPNOW_SYNC_MAX_RTT_US)
     {
-        if (last_btn_left_pressed != NULL)
-        {
-            *last_btn_left_pressed = m->btn_right_pressed;
-        }
-        ESP_LOGI(TAG, "LEFT PADDLE (Player 1) HIT! Button: %d", m->btn_right_pressed);
+        ESP_LOGD(TAG, "Player %d time sync %d discarded, round trip %lld us",
+                 player_id, m.seq, (long long)rtt_us);
+        return;
+    }
 
-        if (paddle_events != NULL)
-        {
-            xEventGroupSetBits(paddle_events, PADDLE_TOP_HIT);
-        }
+    // Assume the paddle replied halfway through the round trip
+    sync_history_t *history = &sync_history[player_id - 1];
+    history->offset_us[history->next] = m.paddle_us - (m.server_us + rtt_us / 2);
+    history->rtt_us[history->next] = (int32_t)rtt_us;
+    history->next = (history->next + 1) % ESPNOW_SYNC_SAMPLES;
+    if (history->count < ESPNOW_SYNC_SAMPLES)
+    {
+        history->count++;
     }
-    else if (player_id == 2)
+
+    // Queueing only ever adds delay, so the fastest reply is the most symmetric one
+    uint8_t best = 0;
+    for (uint8_t i = 1; i < history->count; i++)
     {
-        if (last_btn_right_pressed != NULL)
+        if (history->rtt_us[i] < history->rtt_us[best])
         {
-            *last_btn_right_pressed = m->btn_left_pressed;
+            best = i;
         }
-        ESP_LOGI(TAG, "RIGHT PADDLE (Player 2) HIT! Button: %d", m->btn_left_pressed);
+    }
+
+    espnow_paddle_clock_t clock = {
+        .synced = true,
+        .latency_us = history->rtt_us[best] / 2,
+        .offset_us = history->offset_us[best]};
+
+    portENTER_CRITICAL(&clock_lock);
+    paddle_clocks[player_id - 1] = clock;
+    portEXIT_CRITICAL(&clock_lock);
+
+    ESP_LOGD(TAG, "Player %d time sync %d: round trip %lld us, latency %ld us",
+             player_id, m.seq, (long long)rtt_us, (long)clock.latency_us);
+}
 
-        if (paddle_events != NULL)
+// Send each registered paddle the server clock; the replies measure the links
+static void send_time_sync(void)
+{
+    for (uint8_t i = 0; i < num_players; i++)
+    {
+        time_sync_t sync = {
+            .type = MSG_TIME_SYNC,
+            .seq = sync_seq++,
+            .server_us = esp_timer_get_time()};
+        esp_err_t ret = esp_now_send(player_macs[i], (const uint8_t *)&sync, sizeof(sync));
+        if (ret != ESP_OK)
         {
-            xEventGroupSetBits(paddle_events, PADDLE_BOTTOM_HIT);
+            ESP_LOGD(TAG, "Failed to send time sync to Player %d: %s", i + 1, esp_err_to_name(ret));
         }
     }
 }
 
+// Paddle swing time in server time, rx_us if the paddle's clock is unknown
+static int64_t swing_to_server_time(uint8_t player_id, int64_t paddle_swing_us, int64_t rx_us,
+                                    int32_t *latency_us)
+{
+    espnow_paddle_clock_t clock;
+    espnow_get_paddle_clock(player_id, &clock);
+    if (!clock.synced)
+    {
+        *latency_us = 0;
+        return rx_us;
+    }
+
+    *latency_us = clock.latency_us;
+
+    // The swing cannot come after its packet; a stamp far back is from a stale clock
+    int64_t swing_us = paddle_swing_us - clock.offset_us;
+    if (swing_us > rx_us)
+    {
+        swing_us = rx_us;
+    }
+    else if (swing_us < rx_us - (int64_t)ESPNOW_SWING_MAX_AGE_MS * 1000)
+    {
+        swing_us = rx_us - (int64_t)ESPNOW_SWING_MAX_AGE_MS * 1000;
+    }
+    return swing_us;
+}
+
+static void handle_paddle_input(const uint8_t *mac_addr, const uint8_t *data, int len)
+{
+    int64_t rx_us = esp_timer_get_time();
+
+    if (len < sizeof(input_event_t))
+    {
+        ESP_LOGW(TAG, "Invalid paddle input size: %d", len);
+        return;
+    }
+
+    // Copied out, the receive buffer need not be aligned for the 64-bit fields
+    input_event_t event;
+    memcpy(&event, data, sizeof(event));
+    const input_event_t *m = &event;
+    uint8_t player_id = espnow_get_player_id(mac_addr);
+
+    if (player_id == 0)
+    {
+        ESP_LOGW(TAG, "Received input from unregistered player");
+        return;
+    }
+
+    portENTER_CRITICAL(&hit_lock);
+    uint32_t seq = hits_received + hits_dropped;
+    portEXIT_CRITICAL(&hit_lock);
+
+    // The paddles face each other, so each player's action button is on the other side
+    paddle_hit_t hit = {
+        .rx_us = rx_us,
+        .seq = seq,
+        .player = player_id,
+        .button = (player_id == 1) ? m->btn_right_pressed : m->btn_left_pressed,
+        .btn_left = m->btn_left_pressed,
+        .btn_right = m->btn_right_pressed,
+        .accel_mg = {to_fixed(m->ax, 1000.0f), to_fixed(m->ay, 1000.0f), to_fixed(m->az, 1000.0f)},
+        .gyro_dps = {to_fixed(m->gx, 1.0f), to_fixed(m->gy, 1.0f), to_fixed(m->gz, 1.0f)}};
+    hit.swing_us = swing_to_server_time(player_id, m->swing_us, rx_us, &hit.latency_us);
+
+    ESP_LOGI(TAG, "%s PADDLE (Player %d) HIT! Button: %d",
+             (player_id == 1) ? "LEFT" : "RIGHT", player_id, hit.button);
+
+    // Runs in the WiFi task, which must not block; a full queue drops the hit
+    if (paddle_hits == NULL || xQueueSend(paddle_hits, &hit, 0) != pdTRUE)
+    {
+        portENTER_CRITICAL(&hit_lock);
+        uint32_t dropped = ++hits_dropped;
+        portEXIT_CRITICAL(&hit_lock);
+        ESP_LOGW(TAG, "Paddle hit %lu dropped (%lu so far)", (unsigned long)hit.seq, (unsigned long)dropped);
+        return;
+    }
+
+    uint16_t depth = (uint16_t)uxQueueMessagesWaiting(paddle_hits);
+    portENTER_CRITICAL(&hit_lock);
+    hits_received++;
+    if (depth > hits_max_depth)
+    {
+        hits_max_depth = depth;
+    }
+    portEXIT_CRITICAL(&hit_lock);
+}
+
 void on_receive(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len)
 {
     if (len < 1)
@@ -201,6 +406,10 @@ void on_receive(const esp_now_recv_info_t *recv_info, const uint8_t *data, int l
         handle_paddle_input(mac_addr, data, len);
         break;
 
+    case MSG_TIME_SYNC_REPLY:
+        handle_time_sync_reply(mac_addr, data, len);
+        break;
+
     default:
         ESP_LOGW(TAG, "Unknown message type: %d", msg_type);
         break;
@@ -258,7 +467,8 @@ void espnow_receiver_task(void *pvParameters)
 
     while (1)
     {
-        vTaskDelay(pdMS_TO_TICKS(10));
+        vTaskDelay(pdMS_TO_TICKS(ESPNOW_SYNC_INTERVAL_MS));
+        send_time_sync();
     }
 }
 
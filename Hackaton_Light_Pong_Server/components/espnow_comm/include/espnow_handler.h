@@ -9,14 +9,20 @@
 #define ESPNOW_HANDLER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "freertos/FreeRTOS.h"
-#include "freertos/event_groups.h"
+#include "freertos/queue.h"
 #include "esp_now.h"
 #include "esp_err.h"
 
-// Event bits for paddle hits
-#define PADDLE_TOP_HIT BIT0
-#define PADDLE_BOTTOM_HIT BIT1
+// Paddle hit queue length; hits beyond it are dropped and counted
+#define ESPNOW_HIT_QUEUE_LEN 8
+
+// Paddle clock synchronization
+#define ESPNOW_SYNC_INTERVAL_MS 1000 // Time sync request to each paddle
+#define ESPNOW_SYNC_SAMPLES 8        // Replies kept per paddle, the fastest one is used
+#define ESPNOW_SYNC_MAX_RTT_US 50000 // Slower replies say nothing about the link
+#define ESPNOW_SWING_MAX_AGE_MS 200  // Swing stamps older than this on arrival are clamped
 
 // Broadcast MAC address for ESP-NOW
 #define ESPNOW_BROADCAST_MAC ((const uint8_t[]){0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF})
@@ -31,10 +37,12 @@ extern "C"
      */
     typedef enum
     {
-        MSG_HELLO = 0,        // Client registration request
-        MSG_PADDLE_INPUT = 1, // Paddle input data
-        MSG_GAME_SCORE = 2,   // Game score broadcast
-        MSG_SERVER_ASSIGN = 3 // Server player ID assignment
+        MSG_HELLO = 0,          // Client registration request
+        MSG_PADDLE_INPUT = 1,   // Paddle input data
+        MSG_GAME_SCORE = 2,     // Game score broadcast
+        MSG_SERVER_ASSIGN = 3,  // Server player ID assignment
+        MSG_TIME_SYNC = 4,      // Server clock sample sent to a paddle
+        MSG_TIME_SYNC_REPLY = 5 // Same message returned with the paddle's clock
     } msg_type_t;
 
     /**
@@ -66,14 +74,66 @@ extern "C"
         uint8_t btn_left_pressed;
         float ax, ay, az;
         float gx, gy, gz;
+        int64_t swing_us; // Paddle esp_timer time of the IMU sample that triggered the send
     } input_event_t;
 
     /**
-     * @brief Initialize ESP-NOW and start receiver task
+     * @brief Time sync request and reply
+     *
+     * The server sends its clock, the paddle returns the message at once
+     * with its own clock added. Half the round trip is the one-way latency.
+     */
+    typedef struct
+    {
+        uint8_t type;      // MSG_TIME_SYNC or MSG_TIME_SYNC_REPLY
+        uint8_t seq;       // Request number, echoed
+        int64_t server_us; // Server esp_timer time when sent, echoed
+        int64_t paddle_us; // Paddle esp_timer time when replied
+    } time_sync_t;
+
+    /**
+     * @brief Paddle hit as queued for the game task
      *
-     * @param paddle_events Event group handle for paddle hit synchronization
-     * @param btn_left Pointer to store left button state
-     * @param btn_right Pointer to store right button state
+     * Fixed size and copied by value into the queue, so the receiver always
+     * sees the buttons and motion of one packet together.
+     */
+    typedef struct
+    {
+        int64_t rx_us;       // esp_timer time the packet arrived
+        int64_t swing_us;    // Swing time in server esp_timer time (rx_us if the paddle is not synced)
+        int32_t latency_us;  // One-way latency of the paddle's link, 0 if not measured
+        uint32_t seq;        // Receive order over all players, gaps are dropped hits
+        uint8_t player;      // Player ID (1 or 2)
+        uint8_t button;      // Action button of that player's paddle
+        uint8_t btn_left;    // Raw button states
+        uint8_t btn_right;
+        int16_t accel_mg[3]; // Paddle acceleration in milli-g
+        int16_t gyro_dps[3]; // Paddle rotation rate in deg/s
+    } paddle_hit_t;
+
+    /**
+     * @brief Paddle hit queue counters
+     */
+    typedef struct
+    {
+        uint32_t received;  // Hits queued since boot
+        uint32_t dropped;   // Hits lost to a full queue or a missing queue
+        uint16_t depth;     // Hits waiting now
+        uint16_t max_depth; // Most hits ever waiting at once
+    } espnow_hit_stats_t;
+
+    /**
+     * @brief Paddle clock as measured by time sync
+     */
+    typedef struct
+    {
+        bool synced;        // At least one usable reply received
+        int32_t latency_us; // One-way latency, half the fastest recent round trip
+        int64_t offset_us;  // Paddle clock minus server clock
+    } espnow_paddle_clock_t;
+
+    /**
+     * @brief Initialize ESP-NOW and start receiver task
      */
     void espnow_receiver_task(void *pvParameters);
 
@@ -94,19 +154,26 @@ extern "C"
     void on_receive(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len);
 
     /**
-     * @brief Get last button state for left paddle
+     * @brief Set the queue paddle hits are sent to
+     *
+     * @param hits Queue of paddle_hit_t, ESPNOW_HIT_QUEUE_LEN long
      */
-    uint8_t espnow_get_left_button(void);
+    void espnow_set_context(QueueHandle_t hits);
 
     /**
-     * @brief Get last button state for right paddle
+     * @brief Get paddle hit queue counters
+     *
+     * @param stats Pointer to store the counters
      */
-    uint8_t espnow_get_right_button(void);
+    void espnow_get_hit_stats(espnow_hit_stats_t *stats);
 
     /**
-     * @brief Set event group and button pointers for communication
+     * @brief Get the measured clock of a paddle
+     *
+     * @param player_id Player ID (1 or 2)
+     * @param clock Pointer to store the clock, synced = false if unknown
      */
-    void espnow_set_context(EventGroupHandle_t events, volatile uint8_t *btn_left, volatile uint8_t *btn_right);
+    void espnow_get_paddle_clock(uint8_t player_id, espnow_paddle_clock_t *clock);
 
     /**
      * @brief Get number of registered players
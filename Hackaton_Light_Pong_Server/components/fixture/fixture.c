@@ -0,0 +1,356 @@
+/**
+ * @file fixture.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Profile-driven fixture layer implementation
+ */
+
+#include "fixture.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+
+static const char *TAG = "FIXTURE";
+
+#define FIXTURE_DETACH_WAIT_TICKS 5 // Upper bound for the TX task to leave the callback
+
+_Static_assert(FIXTURE_MAX_CHANNELS <= 32, "dirty bitmap is 32 bits");
+
+/**
+ * @brief Fixture context
+ */
+struct fixture_t
+{
+    struct fixture_rig_t *rig;             // Rig the fixture belongs to
+    const fixture_profile_t *profile;
+    uint16_t start_channel;                // DMX address of the first channel
+    uint8_t channels[FIXTURE_MAX_CHANNELS]; // Current channel values (under rig lock)
+    uint32_t dirty;                        // Channels changed since the last write, bit per channel
+};
+
+/**
+ * @brief Rig context
+ */
+struct fixture_rig_t
+{
+    dmx_handle_t dmx_handle;
+    portMUX_TYPE lock;                                  // Guards fixture channels, dirty bits and count
+    _Atomic bool pending;                               // Some fixture has dirty channels
+    uint8_t fixture_count;
+    struct fixture_t fixtures[FIXTURE_RIG_MAX_FIXTURES];
+    uint8_t staging[FIXTURE_MAX_CHANNELS];              // Copy being written (under the DMX writer lock)
+};
+
+/**
+ * @brief Write all dirty channels of the rig in one DMX transaction
+ */
+static void fixture_rig_write(struct fixture_rig_t *rig)
+{
+    // Setters raise pending after marking channels dirty, so clearing it
+    // first never loses a change
+    if (!atomic_exchange(&rig->pending, false))
+    {
+        return;
+    }
+
+    if (dmx_begin(rig->dmx_handle) != ESP_OK)
+    {
+        atomic_store(&rig->pending, true);
+        return;
+    }
+
+    portENTER_CRITICAL(&rig->lock);
+    uint8_t count = rig->fixture_count;
+    portEXIT_CRITICAL(&rig->lock);
+
+    for (int i = 0; i < count; i++)
+    {
+        struct fixture_t *fixture = &rig->fixtures[i];
+        int first = -1;
+        int last = -1;
+
+        portENTER_CRITICAL(&rig->lock);
+        for (int ch = 0; ch < fixture->profile->channel_count; ch++)
+        {
+            if (fixture->dirty & (1UL << ch))
+            {
+                if (first < 0)
+                {
+                    first = ch;
+                }
+                last = ch;
+            }
+        }
+        if (first >= 0)
+        {
+            memcpy(rig->staging, &fixture->channels[first], last - first + 1);
+            fixture->dirty = 0;
+        }
+        portEXIT_CRITICAL(&rig->lock);
+
+        if (first >= 0)
+        {
+            dmx_set_channels(rig->dmx_handle, fixture->start_channel + first, rig->staging, last - first + 1);
+        }
+    }
+
+    dmx_commit(rig->dmx_handle);
+}
+
+/**
+ * @brief Write pending changes for the upcoming frame (DMX TX task)
+ */
+static void fixture_rig_frame_cb(dmx_handle_t dmx_handle, int64_t next_frame_us, void *arg)
+{
+    fixture_rig_write((struct fixture_rig_t *)arg);
+}
+
+/**
+ * @brief Check a profile against the layer's limits
+ */
+static bool fixture_profile_valid(const fixture_profile_t *profile)
+{
+    if (profile->channel_count == 0 || profile->channel_count > FIXTURE_MAX_CHANNELS)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < FIXTURE_ATTR_COUNT; i++)
+    {
+        const fixture_attr_map_t *map = &profile->attrs[i];
+        if (map->channel > profile->channel_count || map->fine_channel > profile->channel_count ||
+            (map->fine_channel != 0 && map->channel == 0))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Look up an attribute, checking handle and profile
+ */
+static esp_err_t fixture_attr(fixture_handle_t fixture, fixture_attr_t attr, const fixture_attr_map_t **map)
+{
+    if (fixture == NULL || attr >= FIXTURE_ATTR_COUNT)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *map = &fixture->profile->attrs[attr];
+    return ((*map)->channel == 0) ? ESP_ERR_NOT_SUPPORTED : ESP_OK;
+}
+
+esp_err_t fixture_rig_create(dmx_handle_t dmx_handle, fixture_rig_handle_t *out_rig)
+{
+    if (dmx_handle == NULL || out_rig == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct fixture_rig_t *rig = (struct fixture_rig_t *)calloc(1, sizeof(struct fixture_rig_t));
+    if (rig == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate rig");
+        return ESP_ERR_NO_MEM;
+    }
+
+    rig->dmx_handle = dmx_handle;
+    portMUX_INITIALIZE(&rig->lock);
+
+    esp_err_t ret = dmx_add_frame_callback(dmx_handle, fixture_rig_frame_cb, rig);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to attach to the frame clock: %s", esp_err_to_name(ret));
+        free(rig);
+        return ret;
+    }
+
+    *out_rig = rig;
+    return ESP_OK;
+}
+
+esp_err_t fixture_rig_delete(fixture_rig_handle_t rig)
+{
+    if (rig == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_frame_info_t before;
+    dmx_get_last_frame(rig->dmx_handle, &before);
+    dmx_remove_frame_callback(rig->dmx_handle, fixture_rig_frame_cb, rig);
+
+    // The TX task may be inside the callback right now; it has left it once
+    // the next frame went out. Without transmission the wait just times out.
+    for (int i = 0; i < FIXTURE_DETACH_WAIT_TICKS; i++)
+    {
+        dmx_frame_info_t now;
+        dmx_get_last_frame(rig->dmx_handle, &now);
+        if (now.sequence != before.sequence)
+        {
+            break;
+        }
+        vTaskDelay(1);
+    }
+
+    fixture_rig_write(rig);
+    free(rig);
+
+    return ESP_OK;
+}
+
+esp_err_t fixture_add(fixture_rig_handle_t rig, const fixture_profile_t *profile,
+                      uint16_t start_channel, fixture_handle_t *out_fixture)
+{
+    if (rig == NULL || profile == NULL || out_fixture == NULL || !fixture_profile_valid(profile))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t end_channel = start_channel + profile->channel_count - 1;
+    if (start_channel == 0 || end_channel > DMX_UNIVERSE_SIZE)
+    {
+        ESP_LOGE(TAG, "Invalid start channel %d for %s", start_channel, profile->name);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Only fixture_add() changes the count, and it is not called concurrently
+    // for the same rig, so the list can be scanned without the lock
+    if (rig->fixture_count >= FIXTURE_RIG_MAX_FIXTURES)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < rig->fixture_count; i++)
+    {
+        const struct fixture_t *other = &rig->fixtures[i];
+        uint16_t other_end = other->start_channel + other->profile->channel_count - 1;
+        if (start_channel <= other_end && end_channel >= other->start_channel)
+        {
+            ESP_LOGE(TAG, "%s at %d overlaps %s at %d", profile->name, start_channel,
+                     other->profile->name, other->start_channel);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    struct fixture_t *fixture = &rig->fixtures[rig->fixture_count];
+    fixture->rig = rig;
+    fixture->profile = profile;
+    fixture->start_channel = start_channel;
+    memset(fixture->channels, 0, sizeof(fixture->channels));
+    fixture->dirty = 0;
+
+    dmx_patch(rig->dmx_handle, start_channel, profile->channel_count);
+    dmx_set_channels(rig->dmx_handle, start_channel, fixture->channels, profile->channel_count);
+
+    portENTER_CRITICAL(&rig->lock);
+    rig->fixture_count++;
+    portEXIT_CRITICAL(&rig->lock);
+
+    ESP_LOGI(TAG, "%s added: DMX channels %d-%d", profile->name, start_channel, end_channel);
+
+    *out_fixture = fixture;
+    return ESP_OK;
+}
+
+esp_err_t fixture_set(fixture_handle_t fixture, fixture_attr_t attr, uint16_t value)
+{
+    const fixture_attr_map_t *map;
+    esp_err_t ret = fixture_attr(fixture, attr, &map);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    if (map->fine_channel == 0 && value > 255)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct fixture_rig_t *rig = fixture->rig;
+    uint8_t coarse = (map->fine_channel != 0) ? (value >> 8) : value;
+    bool changed = false;
+
+    portENTER_CRITICAL(&rig->lock);
+    if (fixture->channels[map->channel - 1] != coarse)
+    {
+        fixture->channels[map->channel - 1] = coarse;
+        fixture->dirty |= 1UL << (map->channel - 1);
+        changed = true;
+    }
+    if (map->fine_channel != 0 && fixture->channels[map->fine_channel - 1] != (value & 0xFF))
+    {
+        fixture->channels[map->fine_channel - 1] = value & 0xFF;
+        fixture->dirty |= 1UL << (map->fine_channel - 1);
+        changed = true;
+    }
+    portEXIT_CRITICAL(&rig->lock);
+
+    if (changed)
+    {
+        atomic_store(&rig->pending, true);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t fixture_set_range(fixture_handle_t fixture, fixture_attr_t attr, const char *range)
+{
+    const fixture_attr_map_t *map;
+    esp_err_t ret = fixture_attr(fixture, attr, &map);
+    if (ret != ESP_OK || range == NULL)
+    {
+        return (ret != ESP_OK) ? ret : ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < map->range_count; i++)
+    {
+        if (strcmp(map->ranges[i].name, range) == 0)
+        {
+            // A named range on a 16-bit attribute addresses the coarse channel
+            uint16_t value = map->ranges[i].value;
+            return fixture_set(fixture, attr, (map->fine_channel != 0) ? (value << 8) : value);
+        }
+    }
+
+    ESP_LOGW(TAG, "%s has no range \"%s\"", fixture->profile->name, range);
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t fixture_get(fixture_handle_t fixture, fixture_attr_t attr, uint16_t *value)
+{
+    const fixture_attr_map_t *map;
+    esp_err_t ret = fixture_attr(fixture, attr, &map);
+    if (ret != ESP_OK || value == NULL)
+    {
+        return (ret != ESP_OK) ? ret : ESP_ERR_INVALID_ARG;
+    }
+
+    struct fixture_rig_t *rig = fixture->rig;
+
+    portENTER_CRITICAL(&rig->lock);
+    *value = fixture->channels[map->channel - 1];
+    if (map->fine_channel != 0)
+    {
+        *value = (*value << 8) | fixture->channels[map->fine_channel - 1];
+    }
+    portEXIT_CRITICAL(&rig->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t fixture_rig_flush(fixture_rig_handle_t rig)
+{
+    if (rig == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    fixture_rig_write(rig);
+    return ESP_OK;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file fixture.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Profile-driven fixture layer for several heads per universe
+ *
+ * A fixture profile is a const table describing one DMX personality:
+ * which channel carries each attribute, which attributes are 16-bit
+ * coarse/fine pairs, and the named ranges of wheel and function channels.
+ * A rig drives any number of fixtures (up to FIXTURE_RIG_MAX_FIXTURES) on
+ * one universe from those tables, so a new head type needs a profile, not
+ * a driver.
+ *
+ * Setters only update the rig's copy of the fixture channels and never
+ * wait for the DMX writer lock. Once per frame the rig writes everything
+ * that changed, for all fixtures, in a single DMX transaction from the
+ * transmission task (see dmx_add_frame_callback()).
+ */
+
+#ifndef FIXTURE_H
+#define FIXTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "dmx_driver.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define FIXTURE_MAX_CHANNELS 32     // Channels per profile
+#define FIXTURE_RIG_MAX_FIXTURES 16 // Fixtures per rig
+
+    /**
+     * @brief Fixture attributes a profile can map
+     */
+    typedef enum
+    {
+        FIXTURE_ATTR_PAN = 0,
+        FIXTURE_ATTR_TILT,
+        FIXTURE_ATTR_SPEED,
+        FIXTURE_ATTR_COLOR,
+        FIXTURE_ATTR_SHUTTER,
+        FIXTURE_ATTR_DIMMER,
+        FIXTURE_ATTR_GOBO,
+        FIXTURE_ATTR_GOBO_ROT,
+        FIXTURE_ATTR_SPECIAL,
+        FIXTURE_ATTR_PROGRAM,
+        FIXTURE_ATTR_COUNT
+    } fixture_attr_t;
+
+    /**
+     * @brief Named range of a channel, e.g. one slot of a color wheel
+     */
+    typedef struct
+    {
+        const char *name; ///< Range name, unique within the attribute
+        uint8_t from;     ///< First DMX value of the range
+        uint8_t to;       ///< Last DMX value of the range
+        uint8_t value;    ///< Value sent when the range is selected by name
+    } fixture_range_t;
+
+    /**
+     * @brief Where an attribute lives in the profile
+     */
+    typedef struct
+    {
+        uint8_t channel;               ///< Channel in the personality (1-based, as in the manual), 0 if absent
+        uint8_t fine_channel;          ///< Fine channel for 16-bit attributes, 0 for 8-bit
+        const fixture_range_t *ranges; ///< Named ranges, may be NULL
+        uint8_t range_count;           ///< Number of entries in ranges
+    } fixture_attr_map_t;
+
+    /**
+     * @brief DMX personality of a fixture
+     *
+     * Attributes left out of attrs are absent from the personality.
+     */
+    typedef struct
+    {
+        const char *name;                            ///< Profile name for logs
+        uint8_t channel_count;                       ///< Channels the personality occupies
+        fixture_attr_map_t attrs[FIXTURE_ATTR_COUNT]; ///< Attribute map, indexed by fixture_attr_t
+    } fixture_profile_t;
+
+    /**
+     * @brief Set of fixtures on one universe
+     */
+    typedef struct fixture_rig_t *fixture_rig_handle_t;
+
+    /**
+     * @brief One fixture in a rig
+     */
+    typedef struct fixture_t *fixture_handle_t;
+
+    /**
+     * @brief Create a rig and attach it to the universe's frame clock
+     *
+     * @param dmx_handle Universe the fixtures are patched on
+     * @param out_rig Pointer to store the rig handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: Out of memory or no frame callback slot left
+     */
+    esp_err_t fixture_rig_create(dmx_handle_t dmx_handle, fixture_rig_handle_t *out_rig);
+
+    /**
+     * @brief Detach a rig from the frame clock and free it
+     *
+     * Pending changes are written first. Fixture handles of the rig become
+     * invalid.
+     *
+     * @param rig Rig handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t fixture_rig_delete(fixture_rig_handle_t rig);
+
+    /**
+     * @brief Add a fixture to a rig
+     *
+     * The fixture's channels are patched on the universe and start at 0.
+     *
+     * @param rig Rig handle
+     * @param profile Fixture profile, must outlive the rig (normally a const table)
+     * @param start_channel DMX start address (1-512)
+     * @param out_fixture Pointer to store the fixture handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments, or the channels overlap another fixture
+     *      - ESP_ERR_NO_MEM: Rig already holds FIXTURE_RIG_MAX_FIXTURES fixtures
+     */
+    esp_err_t fixture_add(fixture_rig_handle_t rig, const fixture_profile_t *profile,
+                          uint16_t start_channel, fixture_handle_t *out_fixture);
+
+    /**
+     * @brief Set an attribute
+     *
+     * 16-bit attributes take 0-65535 (coarse in the high byte); 8-bit
+     * attributes take 0-255. Goes out with the next frame.
+     *
+     * @param fixture Fixture handle
+     * @param attr Attribute
+     * @param value New value
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments or value out of range
+     *      - ESP_ERR_NOT_SUPPORTED: Profile has no such attribute
+     */
+    esp_err_t fixture_set(fixture_handle_t fixture, fixture_attr_t attr, uint16_t value);
+
+    /**
+     * @brief Set an attribute to a named range of the profile
+     *
+     * @param fixture Fixture handle
+     * @param attr Attribute
+     * @param range Range name, e.g. "red" for FIXTURE_ATTR_COLOR
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NOT_SUPPORTED: Profile has no such attribute
+     *      - ESP_ERR_NOT_FOUND: Profile has no range of that name
+     */
+    esp_err_t fixture_set_range(fixture_handle_t fixture, fixture_attr_t attr, const char *range);
+
+    /**
+     * @brief Get the value last set for an attribute
+     *
+     * @param fixture Fixture handle
+     * @param attr Attribute
+     * @param value Pointer to store the value
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NOT_SUPPORTED: Profile has no such attribute
+     */
+    esp_err_t fixture_get(fixture_handle_t fixture, fixture_attr_t attr, uint16_t *value);
+
+    /**
+     * @brief Write pending changes now instead of after the next frame
+     *
+     * Follow with dmx_request_frame() for latency-critical changes.
+     *
+     * @param rig Rig handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t fixture_rig_flush(fixture_rig_handle_t rig);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIXTURE_H
@@ -0,0 +1,31 @@
+# Point celebrations: blink in the scorer's color, then back to the plain ball.
+# The wheels change over in the dark; wait_look relights once they have settled.
+
+effect ball
+  0 color white
+  0 gobo open
+  0 gobo_rot 0
+  0 dimmer 0
+  0 dimmer full wait_look
+
+effect celebrate_blue
+  passes 10
+  duration 500
+  next ball
+    0 color dark_blue
+    0 gobo open
+    0 gobo_rot 0
+    0 dimmer 0
+    0 dimmer full wait_look
+  250 dimmer 0
+
+effect celebrate_green
+  passes 10
+  duration 500
+  next ball
+    0 color green
+    0 gobo open
+    0 gobo_rot 0
+    0 dimmer 0
+    0 dimmer full wait_look
+  250 dimmer 0
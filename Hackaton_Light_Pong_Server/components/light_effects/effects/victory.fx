@@ -0,0 +1,73 @@
+# Victory: color spin, flashes in the winner's color, spinning open blinks, ball.
+# victory_p1 and victory_p2 share everything but the flash color.
+
+effect victory_p1
+  passes 3
+  duration 1200
+  next victory_flash_p1
+     0 gobo_rot 200
+     0 color red
+   200 color green
+   400 color dark_blue
+   600 color yellow
+   800 color pink
+  1000 color light_blue
+
+effect victory_p2
+  passes 3
+  duration 1200
+  next victory_flash_p2
+     0 gobo_rot 200
+     0 color red
+   200 color green
+   400 color dark_blue
+   600 color yellow
+   800 color pink
+  1000 color light_blue
+
+effect victory_flash_p1
+  passes 2
+  duration 1200
+  next victory_blink
+     0 color green
+     0 gobo_rot 0
+     0 gobo 1
+     0 dimmer full
+   150 dimmer 0
+   300 gobo 2
+   300 dimmer full
+   450 dimmer 0
+   600 gobo 3
+   600 dimmer full
+   750 dimmer 0
+   900 gobo 4
+   900 dimmer full
+  1050 dimmer 0
+
+effect victory_flash_p2
+  passes 2
+  duration 1200
+  next victory_blink
+     0 color dark_blue
+     0 gobo_rot 0
+     0 gobo 1
+     0 dimmer full
+   150 dimmer 0
+   300 gobo 2
+   300 dimmer full
+   450 dimmer 0
+   600 gobo 3
+   600 dimmer full
+   750 dimmer 0
+   900 gobo 4
+   900 dimmer full
+  1050 dimmer 0
+
+effect victory_blink
+  passes 5
+  duration 600
+  next ball
+    0 gobo open
+    0 gobo_rot 200
+    0 dimmer full
+  300 dimmer 0
@@ -3,26 +3,246 @@
  * @author Matthias Hefel
  * @date 2026
  * @brief Light effects and animations for game events
+ *
+ * Effects are timelines of keyframes played by an effect player that runs
+ * from the DMX frame clock (dmx_add_frame_callback()). Starting an effect
+ * returns at once; the caller keeps running while the keyframes go out
+ * frame by frame, and learns about the end through a done callback.
+ *
+ * The built-in effects are written as text (the .fx files in effects/) and
+ * compiled at build time by tools/compile_effects.py, which documents the
+ * format, into const tables in flash. Playback allocates nothing.
+ *
+ * Without a mixer layer an effect owns the channels its keyframes write
+ * while it plays. With one, the keyframes go into the layer and the layer is
+ * released when the effect ends or is stopped, so the layers below show
+ * again. Pan and tilt stay with the motion engine either way.
  */
 
 #ifndef LIGHT_EFFECTS_H
 #define LIGHT_EFFECTS_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "dmx_driver.h"
 #include "mh_x25_driver.h"
+#include "light_mixer.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+/* Keyframe channels, numbered like the MH_X25_APPLY_* bits. Pan and tilt
+ * belong to the motion engine and are not available to effects. */
+#define LIGHT_FX_SPEED 2
+#define LIGHT_FX_COLOR 3
+#define LIGHT_FX_SHUTTER 4
+#define LIGHT_FX_DIMMER 5
+#define LIGHT_FX_GOBO 6
+#define LIGHT_FX_GOBO_ROT 7
+#define LIGHT_FX_SPECIAL 8
+#define LIGHT_FX_PROGRAM 9
+#define LIGHT_FX_CHANNELS 10
+
+/* Keyframe curves: how the channel gets from its current value to the keyframe's */
+#define LIGHT_FX_CURVE_STEP 0     // Jump at at_ms
+#define LIGHT_FX_CURVE_LINEAR 1   // Fade over fade_ms at constant rate
+#define LIGHT_FX_CURVE_EASE_IN 2  // Fade starting slowly
+#define LIGHT_FX_CURVE_EASE_OUT 3 // Fade ending slowly
+
+/* Keyframe flags */
+#define LIGHT_FX_WAIT_LOOK (1 << 6) // Hold the timeline until the color/gobo wheels have settled
+
+/* Packing of light_fx_key_t.op */
+#define LIGHT_FX_OP(channel, curve, flags) ((uint8_t)((channel) | ((curve) << 4) | (flags)))
+#define LIGHT_FX_OP_CHANNEL(op) ((op) & 0x0F)
+#define LIGHT_FX_OP_CURVE(op) (((op) >> 4) & 0x03)
+
+    /**
+     * @brief One keyframe of an effect timeline, 6 bytes in flash
+     *
+     * At at_ms the channel starts moving to value along the curve and gets
+     * there fade_ms later. Fades must end within the pass.
+     */
+    typedef struct
+    {
+        uint16_t at_ms;   ///< Offset from the start of the pass
+        uint16_t fade_ms; ///< Fade length, ignored for LIGHT_FX_CURVE_STEP
+        uint8_t op;       ///< Channel, curve and flags, see LIGHT_FX_OP()
+        uint8_t value;    ///< Channel value at the end of the keyframe
+    } light_fx_key_t;
+
+    /**
+     * @brief Called in the first frame of an effect, before its first keyframe
+     *
+     * Runs in the DMX transmission task and must not block.
+     *
+     * @param fixture Fixture the effect plays on
+     * @param arg Argument passed to light_effects_play()
+     */
+    typedef void (*light_effect_start_cb_t)(mh_x25_handle_t fixture, void *arg);
+
+    /**
+     * @brief Called every frame while an effect plays, after the due keyframes
+     *
+     * Runs in the DMX transmission task and must not block.
+     *
+     * @param fixture Fixture the effect plays on
+     * @param elapsed_ms Time into the current pass at the upcoming frame
+     * @param arg Argument passed to light_effects_play()
+     */
+    typedef void (*light_effect_update_cb_t)(mh_x25_handle_t fixture, uint32_t elapsed_ms, void *arg);
+
+    /**
+     * @brief Called once when a played effect chain ends
+     *
+     * After completion this runs in the DMX transmission task and must not
+     * block; after light_effects_stop() or a replacing light_effects_play()
+     * it runs in the caller's task.
+     *
+     * @param completed true if the last keyframe of the chain went out
+     * @param arg Argument passed to light_effects_play()
+     */
+    typedef void (*light_effect_done_cb_t)(bool completed, void *arg);
+
+    /**
+     * @brief Effect definition
+     *
+     * A pass writes the keyframes at their offsets and ends duration_ms after
+     * it started, or later if a LIGHT_FX_WAIT_LOOK keyframe had to wait.
+     * After the last pass the next effect, if any, starts in the same frame.
+     * Chains must end; an effect must not lead back to itself.
+     */
+    typedef struct light_effect_s
+    {
+        const char *name;                     ///< For logging
+        const light_fx_key_t *keys;           ///< Keyframes in time order
+        uint16_t key_count;                   ///< Number of keyframes
+        uint16_t passes;                      ///< Times the timeline plays, 0 counts as 1
+        uint32_t duration_ms;                 ///< Length of one pass
+        const struct light_effect_s *next;    ///< Effect played afterwards, NULL to end
+        light_effect_start_cb_t on_start;     ///< Optional
+        light_effect_update_cb_t on_update;   ///< Optional
+    } light_effect_t;
+
+    /**
+     * @brief Effect player configuration
+     */
+    typedef struct
+    {
+        dmx_handle_t dmx_handle;          ///< Universe whose frames clock the player
+        mh_x25_handle_t fixture;          ///< Fixture on that universe to play on
+        light_mixer_layer_handle_t layer; ///< Mixer layer to write, NULL to write the fixture directly
+    } light_effects_config_t;
+
+    /**
+     * @brief Effect player handle
+     */
+    typedef void *light_effects_handle_t;
+
+    /**
+     * @brief Caller-provided storage for light_effects_init_static()
+     *
+     * Must outlive the handle. The contents are private to the player.
+     */
+    typedef struct
+    {
+        uint64_t reserved[20];
+    } light_effects_static_t;
+
+    /**
+     * @brief Built-in celebration after a point: blink in a color, then back to the ball
+     */
+    extern const light_effect_t light_effect_celebrate_blue;
+    extern const light_effect_t light_effect_celebrate_green;
+
+    /**
+     * @brief Create an effect player and attach it to the universe's frame clock
+     *
+     * @param config Pointer to configuration structure
+     * @param out_handle Pointer to store the player handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: Out of memory
+     */
+    esp_err_t light_effects_init(const light_effects_config_t *config, light_effects_handle_t *out_handle);
+
+    /**
+     * @brief Create an effect player in caller-provided storage
+     *
+     * Same as light_effects_init() without allocating the player context.
+     *
+     * @param config Pointer to configuration structure
+     * @param storage Storage for the player, must outlive the handle
+     * @param out_handle Pointer to store the player handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t light_effects_init_static(const light_effects_config_t *config, light_effects_static_t *storage,
+                                        light_effects_handle_t *out_handle);
+
+    /**
+     * @brief Detach the player from the frame clock and release it
+     *
+     * A playing effect is stopped without calling its done callback.
+     *
+     * @param handle Player handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t light_effects_deinit(light_effects_handle_t handle);
+
+    /**
+     * @brief Start an effect
+     *
+     * The first keyframes go out in the next frame. An effect still playing
+     * is replaced; its done callback runs with completed = false before this
+     * returns.
+     *
+     * @param handle Player handle
+     * @param effect Effect to play, must stay valid while it plays
+     * @param on_done Called when the effect chain ends, may be NULL
+     * @param arg Passed to the effect's callbacks and on_done
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t light_effects_play(light_effects_handle_t handle, const light_effect_t *effect,
+                                 light_effect_done_cb_t on_done, void *arg);
+
+    /**
+     * @brief Stop the playing effect
+     *
+     * The channels keep the values of the last keyframe written. The done
+     * callback runs with completed = false before this returns.
+     *
+     * @param handle Player handle
+     * @return
+     *      - ESP_OK: Success (also if nothing was playing)
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t light_effects_stop(light_effects_handle_t handle);
+
+    /**
+     * @brief Check whether an effect is playing
+     *
+     * @param handle Player handle
+     * @return true until the last keyframe of the chain has gone out
+     */
+    bool light_effects_is_playing(light_effects_handle_t handle);
+
     /**
-     * @brief Play winning animation for the victor
+     * @brief Get the victory animation for a player
      *
      * @param winning_player Player number who won (1 or 2)
-     * @param light_handle Handle to MH X25 light
+     * @return Effect ending with the plain white ball at full dimmer
      */
-    void play_winning_animation(uint8_t winning_player, mh_x25_handle_t light_handle);
+    const light_effect_t *light_effects_victory(uint8_t winning_player);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,577 @@
+/**
+ * @file light_effect_player.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Keyframe timeline player driven by the DMX frame clock
+ */
+
+#include "light_effects.h"
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "EFFECTS";
+
+#define LIGHT_EFFECTS_DETACH_WAIT_TICKS 5 // Upper bound for the TX task to leave the callback
+
+/**
+ * @brief Fade in progress on one channel
+ */
+typedef struct
+{
+    uint16_t key;  // Keyframe of the current effect driving the fade
+    uint8_t from;  // Channel value when the fade started
+    bool active;
+} light_effects_fade_t;
+
+/**
+ * @brief Playback position
+ */
+typedef struct
+{
+    const light_effect_t *effect;  // Effect of the chain now playing, NULL when idle
+    uint16_t index;                // Next keyframe of the current pass
+    uint16_t pass;                 // Current pass of the effect
+    bool started;                  // on_start ran for the current effect
+    int64_t origin_us;             // Start of the current pass, moved by look waits
+    light_effects_fade_t fades[LIGHT_FX_CHANNELS];
+} light_effects_cursor_t;
+
+/**
+ * @brief Effect player context
+ */
+typedef struct
+{
+    dmx_handle_t dmx_handle;       // Universe clocking the player
+    mh_x25_handle_t fixture;       // Fixture being played on
+    light_mixer_layer_handle_t layer; // Layer written instead of the fixture, or NULL
+    portMUX_TYPE lock;             // Guards everything below, shared with the TX task
+    light_effects_cursor_t cur;
+    light_effect_done_cb_t on_done;
+    void *arg;
+    uint32_t play_id;              // Bumped on every play or stop
+    bool is_static;                // Lives in light_effects_static_t storage
+} light_effects_context_t;
+
+_Static_assert(sizeof(light_effects_context_t) <= sizeof(light_effects_static_t),
+               "light_effects_static_t too small for the player context");
+
+/**
+ * @brief Channel writes collected for one mh_x25_apply() or light_mixer_set()
+ */
+typedef struct
+{
+    mh_x25_state_t state;
+    uint32_t mask;
+} light_effects_out_t;
+
+static uint8_t *light_effects_field(mh_x25_state_t *state, uint8_t channel)
+{
+    switch (channel)
+    {
+    case LIGHT_FX_SPEED:
+        return &state->speed;
+    case LIGHT_FX_COLOR:
+        return &state->color;
+    case LIGHT_FX_SHUTTER:
+        return &state->shutter;
+    case LIGHT_FX_DIMMER:
+        return &state->dimmer;
+    case LIGHT_FX_GOBO:
+        return &state->gobo;
+    case LIGHT_FX_GOBO_ROT:
+        return &state->gobo_rotation;
+    case LIGHT_FX_SPECIAL:
+        return &state->special;
+    case LIGHT_FX_PROGRAM:
+        return &state->program;
+    default:
+        return NULL;
+    }
+}
+
+static void light_effects_put(light_effects_out_t *out, uint8_t channel, uint8_t value)
+{
+    uint8_t *field = light_effects_field(&out->state, channel);
+    if (field != NULL)
+    {
+        *field = value;
+        out->mask |= 1u << channel;
+    }
+}
+
+/**
+ * @brief Hand the collected writes on
+ *
+ * @param now Resolve a mixer layer into the fixture at once instead of with the frame
+ */
+static void light_effects_flush(const light_effects_context_t *ctx, light_effects_out_t *out, bool now)
+{
+    if (out->mask == 0)
+    {
+        return;
+    }
+
+    if (ctx->layer == NULL)
+    {
+        mh_x25_apply(ctx->fixture, &out->state, out->mask);
+    }
+    else
+    {
+        light_mixer_set(ctx->layer, &out->state, out->mask);
+        if (now)
+        {
+            light_mixer_flush(light_mixer_get_mixer(ctx->layer));
+        }
+    }
+    out->mask = 0;
+}
+
+/**
+ * @brief Give the channels of a finished or replaced effect back to the lower layers
+ */
+static void light_effects_release(const light_effects_context_t *ctx)
+{
+    if (ctx->layer != NULL)
+    {
+        light_mixer_release(ctx->layer, LIGHT_MIXER_CHANNELS);
+    }
+}
+
+/**
+ * @brief Value a channel has going into the upcoming frame
+ */
+static uint8_t light_effects_current(mh_x25_handle_t fixture, light_effects_out_t *out, uint8_t channel)
+{
+    if (!(out->mask & (1u << channel)))
+    {
+        mh_x25_state_t state;
+        if (mh_x25_get_state(fixture, &state) != ESP_OK)
+        {
+            return 0;
+        }
+        return *light_effects_field(&state, channel);
+    }
+
+    return *light_effects_field(&out->state, channel);
+}
+
+/**
+ * @brief Map linear fade progress to the curve, both Q16 in [0, 1 << 16]
+ */
+static uint32_t light_effects_ease(uint8_t curve, uint32_t t)
+{
+    uint64_t x = t;
+
+    switch (curve)
+    {
+    case LIGHT_FX_CURVE_EASE_IN:
+        return (uint32_t)((x * x) >> 16);
+    case LIGHT_FX_CURVE_EASE_OUT:
+    {
+        uint64_t r = (1u << 16) - x;
+        return (1u << 16) - (uint32_t)((r * r) >> 16);
+    }
+    default:
+        return t;
+    }
+}
+
+/**
+ * @brief Write the value of every running fade at the upcoming frame
+ */
+static void light_effects_run_fades(light_effects_cursor_t *cur, light_effects_out_t *out, int64_t next_frame_us)
+{
+    for (uint8_t channel = 0; channel < LIGHT_FX_CHANNELS; channel++)
+    {
+        light_effects_fade_t *fade = &cur->fades[channel];
+        if (!fade->active)
+        {
+            continue;
+        }
+
+        const light_fx_key_t *key = &cur->effect->keys[fade->key];
+        int64_t elapsed_us = next_frame_us - (cur->origin_us + (int64_t)key->at_ms * 1000);
+        int64_t length_us = (int64_t)key->fade_ms * 1000;
+
+        if (elapsed_us >= length_us)
+        {
+            light_effects_put(out, channel, key->value);
+            fade->active = false;
+            continue;
+        }
+
+        uint32_t t = (elapsed_us <= 0) ? 0 : (uint32_t)(((uint64_t)elapsed_us << 16) / length_us);
+        int32_t delta = (int32_t)key->value - (int32_t)fade->from;
+        int32_t step = (int32_t)(((int64_t)delta * light_effects_ease(LIGHT_FX_OP_CURVE(key->op), t)) >> 16);
+        light_effects_put(out, channel, (uint8_t)(fade->from + step));
+    }
+}
+
+/**
+ * @brief Jump to a keyframe's value or start its fade
+ */
+static void light_effects_start_key(mh_x25_handle_t fixture, light_effects_cursor_t *cur,
+                                    light_effects_out_t *out)
+{
+    const light_fx_key_t *key = &cur->effect->keys[cur->index];
+    uint8_t channel = LIGHT_FX_OP_CHANNEL(key->op);
+    if (channel >= LIGHT_FX_CHANNELS)
+    {
+        return;
+    }
+
+    light_effects_fade_t *fade = &cur->fades[channel];
+
+    if (LIGHT_FX_OP_CURVE(key->op) == LIGHT_FX_CURVE_STEP || key->fade_ms == 0)
+    {
+        fade->active = false;
+        light_effects_put(out, channel, key->value);
+        return;
+    }
+
+    fade->key = cur->index;
+    fade->from = light_effects_current(fixture, out, channel);
+    fade->active = true;
+}
+
+/**
+ * @brief Collect every write due by the upcoming frame and advance the cursor
+ *
+ * @return true if the chain has ended
+ */
+static bool light_effects_advance(const light_effects_context_t *ctx, light_effects_cursor_t *cur,
+                                  light_effects_out_t *out, int64_t next_frame_us, void *arg)
+{
+    mh_x25_handle_t fixture = ctx->fixture;
+
+    while (cur->effect != NULL)
+    {
+        const light_effect_t *effect = cur->effect;
+
+        if (!cur->started)
+        {
+            cur->started = true;
+            if (effect->on_start != NULL)
+            {
+                effect->on_start(fixture, arg);
+            }
+        }
+
+        bool pending = false;
+        while (cur->index < effect->key_count)
+        {
+            const light_fx_key_t *key = &effect->keys[cur->index];
+            int64_t due_us = cur->origin_us + (int64_t)key->at_ms * 1000;
+
+            if (key->op & LIGHT_FX_WAIT_LOOK)
+            {
+                // Wheel moves collected so far have to reach the driver to be
+                // planned; the rest of the pass shifts back by the wait
+                light_effects_flush(ctx, out, true);
+                int64_t ready_us;
+                if (mh_x25_get_look_ready(fixture, &ready_us) == ESP_OK && ready_us > due_us)
+                {
+                    cur->origin_us += ready_us - due_us;
+                    due_us = ready_us;
+                }
+            }
+
+            if (due_us > next_frame_us)
+            {
+                pending = true;
+                break;
+            }
+
+            light_effects_start_key(fixture, cur, out);
+            cur->index++;
+        }
+
+        light_effects_run_fades(cur, out, next_frame_us);
+
+        int64_t end_us = cur->origin_us + (int64_t)effect->duration_ms * 1000;
+        if (pending || end_us > next_frame_us)
+        {
+            return false;
+        }
+
+        // Fades end within the pass, so none carries over
+        memset(cur->fades, 0, sizeof(cur->fades));
+
+        uint16_t passes = (effect->passes == 0) ? 1 : effect->passes;
+        cur->origin_us = end_us;
+        cur->index = 0;
+        if (++cur->pass < passes)
+        {
+            continue;
+        }
+
+        cur->effect = effect->next;
+        cur->pass = 0;
+        cur->started = false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Play the keyframes due in the upcoming frame (DMX TX task)
+ */
+static void light_effects_frame_cb(dmx_handle_t dmx_handle, int64_t next_frame_us, void *arg)
+{
+    light_effects_context_t *ctx = (light_effects_context_t *)arg;
+
+    portENTER_CRITICAL(&ctx->lock);
+    if (ctx->cur.effect == NULL)
+    {
+        portEXIT_CRITICAL(&ctx->lock);
+        return;
+    }
+    light_effects_cursor_t cur = ctx->cur;
+    uint32_t play_id = ctx->play_id;
+    void *effect_arg = ctx->arg;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    light_effects_out_t out = {.mask = 0};
+    bool ended = light_effects_advance(ctx, &cur, &out, next_frame_us, effect_arg);
+    light_effects_flush(ctx, &out, false);
+
+    if (!ended && cur.effect->on_update != NULL)
+    {
+        int64_t elapsed_us = next_frame_us - cur.origin_us;
+        cur.effect->on_update(ctx->fixture, (elapsed_us > 0) ? (uint32_t)(elapsed_us / 1000) : 0, effect_arg);
+    }
+
+    // A play or stop given meanwhile has taken over, leave its state alone
+    light_effect_done_cb_t on_done = NULL;
+    portENTER_CRITICAL(&ctx->lock);
+    bool current = (ctx->play_id == play_id);
+    if (current)
+    {
+        ctx->cur = cur;
+        if (ended)
+        {
+            on_done = ctx->on_done;
+            ctx->on_done = NULL;
+        }
+    }
+    portEXIT_CRITICAL(&ctx->lock);
+
+    // Only this callback writes the layer, so a release also drops writes
+    // of a replaced effect that raced with light_effects_play()/stop()
+    if (ended || !current)
+    {
+        light_effects_release(ctx);
+    }
+
+    if (on_done != NULL)
+    {
+        on_done(true, effect_arg);
+    }
+}
+
+/**
+ * @brief Clear the playing effect and release its layer (lock held)
+ *
+ * @return The done callback the caller has to run, or NULL
+ */
+static light_effect_done_cb_t light_effects_take(light_effects_context_t *ctx, void **done_arg)
+{
+    light_effect_done_cb_t on_done = (ctx->cur.effect != NULL) ? ctx->on_done : NULL;
+    *done_arg = ctx->arg;
+
+    light_effects_release(ctx);
+    memset(&ctx->cur, 0, sizeof(ctx->cur));
+    ctx->on_done = NULL;
+    ctx->play_id++;
+
+    return on_done;
+}
+
+/**
+ * @brief Check a configuration before any storage is touched
+ */
+static esp_err_t light_effects_check_config(const light_effects_config_t *config, const void *out_handle)
+{
+    if (config == NULL || out_handle == NULL || config->dmx_handle == NULL || config->fixture == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Initialize a zeroed context and attach it to the frame clock
+ */
+static esp_err_t light_effects_setup(light_effects_context_t *ctx, const light_effects_config_t *config)
+{
+    ctx->dmx_handle = config->dmx_handle;
+    ctx->fixture = config->fixture;
+    ctx->layer = config->layer;
+    portMUX_INITIALIZE(&ctx->lock);
+
+    esp_err_t ret = dmx_add_frame_callback(ctx->dmx_handle, light_effects_frame_cb, ctx);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Effect player attached");
+    return ESP_OK;
+}
+
+esp_err_t light_effects_init(const light_effects_config_t *config, light_effects_handle_t *out_handle)
+{
+    esp_err_t ret = light_effects_check_config(config, out_handle);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    light_effects_context_t *ctx = (light_effects_context_t *)calloc(1, sizeof(light_effects_context_t));
+    if (ctx == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ret = light_effects_setup(ctx, config);
+    if (ret != ESP_OK)
+    {
+        free(ctx);
+        return ret;
+    }
+
+    *out_handle = (light_effects_handle_t)ctx;
+    return ESP_OK;
+}
+
+esp_err_t light_effects_init_static(const light_effects_config_t *config, light_effects_static_t *storage,
+                                    light_effects_handle_t *out_handle)
+{
+    esp_err_t ret = light_effects_check_config(config, out_handle);
+    if (ret != ESP_OK || storage == NULL)
+    {
+        return (ret != ESP_OK) ? ret : ESP_ERR_INVALID_ARG;
+    }
+
+    light_effects_context_t *ctx = (light_effects_context_t *)storage;
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->is_static = true;
+
+    ret = light_effects_setup(ctx, config);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    *out_handle = (light_effects_handle_t)ctx;
+    return ESP_OK;
+}
+
+esp_err_t light_effects_deinit(light_effects_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    light_effects_context_t *ctx = (light_effects_context_t *)handle;
+
+    dmx_frame_info_t before;
+    dmx_get_last_frame(ctx->dmx_handle, &before);
+    dmx_remove_frame_callback(ctx->dmx_handle, light_effects_frame_cb, ctx);
+
+    // The TX task may be inside the callback right now; it has left it once
+    // the next frame went out. Without transmission the wait just times out.
+    for (int i = 0; i < LIGHT_EFFECTS_DETACH_WAIT_TICKS; i++)
+    {
+        dmx_frame_info_t now;
+        dmx_get_last_frame(ctx->dmx_handle, &now);
+        if (now.sequence != before.sequence)
+        {
+            break;
+        }
+        vTaskDelay(1);
+    }
+
+    if (!ctx->is_static)
+    {
+        free(ctx);
+    }
+    ESP_LOGI(TAG, "Effect player detached");
+
+    return ESP_OK;
+}
+
+esp_err_t light_effects_play(light_effects_handle_t handle, const light_effect_t *effect,
+                             light_effect_done_cb_t on_done, void *arg)
+{
+    if (handle == NULL || effect == NULL || (effect->key_count > 0 && effect->keys == NULL))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    light_effects_context_t *ctx = (light_effects_context_t *)handle;
+    int64_t now = esp_timer_get_time();
+
+    void *replaced_arg;
+    portENTER_CRITICAL(&ctx->lock);
+    light_effect_done_cb_t replaced = light_effects_take(ctx, &replaced_arg);
+    ctx->cur.effect = effect;
+    ctx->cur.origin_us = now;
+    ctx->on_done = on_done;
+    ctx->arg = arg;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    if (replaced != NULL)
+    {
+        replaced(false, replaced_arg);
+    }
+
+    ESP_LOGD(TAG, "Playing %s", (effect->name != NULL) ? effect->name : "effect");
+    return ESP_OK;
+}
+
+esp_err_t light_effects_stop(light_effects_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    light_effects_context_t *ctx = (light_effects_context_t *)handle;
+
+    void *stopped_arg;
+    portENTER_CRITICAL(&ctx->lock);
+    light_effect_done_cb_t stopped = light_effects_take(ctx, &stopped_arg);
+    portEXIT_CRITICAL(&ctx->lock);
+
+    if (stopped != NULL)
+    {
+        stopped(false, stopped_arg);
+    }
+
+    return ESP_OK;
+}
+
+bool light_effects_is_playing(light_effects_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return false;
+    }
+
+    light_effects_context_t *ctx = (light_effects_context_t *)handle;
+
+    portENTER_CRITICAL(&ctx->lock);
+    bool playing = (ctx->cur.effect != NULL);
+    portEXIT_CRITICAL(&ctx->lock);
+
+    return playing;
+}
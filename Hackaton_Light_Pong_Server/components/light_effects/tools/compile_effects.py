@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+"""Compile light effect descriptions into const C tables for the effect player.
+
+Run by the light_effects component at build time; any error fails the build.
+
+Format, one statement per line, '#' starts a comment:
+
+    effect <name>                   start an effect, becomes light_effect_<name>
+      passes <n>                    times the timeline plays (default 1)
+      duration <ms>                 length of one pass (default: end of the last keyframe)
+      next <name>                   effect played afterwards
+      <at_ms> <channel> <value> [fade <ms> [linear|ease_in|ease_out]] [wait_look]
+
+Channels are speed, color, shutter, dimmer, gobo, gobo_rot, special and
+program. Values are 0-255 or a name from mh_x25_driver.h without its prefix,
+e.g. "color dark_blue" for MH_X25_COLOR_DARK_BLUE. A fade moves the channel
+from its current value to the keyframe's value; wait_look holds the timeline
+until the color and gobo wheels have settled.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+CHANNELS = {
+    'speed': ('LIGHT_FX_SPEED', 'SPEED'),
+    'color': ('LIGHT_FX_COLOR', 'COLOR'),
+    'shutter': ('LIGHT_FX_SHUTTER', 'SHUTTER'),
+    'dimmer': ('LIGHT_FX_DIMMER', 'DIMMER'),
+    'gobo': ('LIGHT_FX_GOBO', 'GOBO'),
+    'gobo_rot': ('LIGHT_FX_GOBO_ROT', 'GOBO_ROT'),
+    'special': ('LIGHT_FX_SPECIAL', 'SPECIAL'),
+    'program': ('LIGHT_FX_PROGRAM', 'PROGRAM'),
+}
+
+# Wheels step from slot to slot, a fade would only sweep through the others
+WHEELS = ('color', 'gobo')
+
+CURVES = {
+    'linear': 'LIGHT_FX_CURVE_LINEAR',
+    'ease_in': 'LIGHT_FX_CURVE_EASE_IN',
+    'ease_out': 'LIGHT_FX_CURVE_EASE_OUT',
+}
+
+KEY_BYTES = 6
+U16_MAX = 0xFFFF
+
+
+class EffectError(Exception):
+    pass
+
+
+class Key:
+    def __init__(self, where, at_ms, channel, value, value_c, fade_ms, curve, wait):
+        self.where = where
+        self.at_ms = at_ms
+        self.channel = channel
+        self.value = value
+        self.value_c = value_c
+        self.fade_ms = fade_ms
+        self.curve = curve
+        self.wait = wait
+
+
+class Effect:
+    def __init__(self, where, name):
+        self.where = where
+        self.name = name
+        self.passes = 1
+        self.duration_ms = None
+        self.next = None
+        self.keys = []
+
+
+def load_constants(header):
+    """Read the MH_X25_<CHANNEL>_<NAME> values from the driver header."""
+    constants = {}
+    pattern = re.compile(r'^\s*#define\s+(MH_X25_\w+)\s+(0x[0-9A-Fa-f]+|\d+)\b')
+    with open(header, encoding='utf-8') as f:
+        for line in f:
+            m = pattern.match(line)
+            if m:
+                constants[m.group(1)] = int(m.group(2), 0)
+    return constants
+
+
+def parse_int(where, text, what, limit):
+    try:
+        value = int(text, 0)
+    except ValueError:
+        raise EffectError(f'{where}: {what} "{text}" is not a number')
+    if value < 0 or value > limit:
+        raise EffectError(f'{where}: {what} {value} out of range 0-{limit}')
+    return value
+
+
+def parse_value(where, channel, text, constants):
+    if re.fullmatch(r'0x[0-9A-Fa-f]+|\d+', text):
+        value = parse_int(where, text, 'value', 255)
+        return value, str(value)
+
+    macro = f'MH_X25_{CHANNELS[channel][1]}_{text.upper()}'
+    if macro not in constants:
+        raise EffectError(f'{where}: unknown {channel} value "{text}" ({macro} not in the driver header)')
+    value = constants[macro]
+    if value > 255:
+        raise EffectError(f'{where}: {macro} = {value} does not fit a DMX channel')
+    return value, macro
+
+
+def parse_key(where, words, constants):
+    if len(words) < 3:
+        raise EffectError(f'{where}: keyframe needs <at_ms> <channel> <value>')
+
+    at_ms = parse_int(where, words[0], 'time', U16_MAX)
+    channel = words[1]
+    if channel not in CHANNELS:
+        if channel in ('pan', 'tilt'):
+            raise EffectError(f'{where}: {channel} belongs to the motion engine')
+        raise EffectError(f'{where}: unknown channel "{channel}"')
+    value, value_c = parse_value(where, channel, words[2], constants)
+
+    fade_ms = 0
+    curve = None
+    wait = False
+    rest = words[3:]
+    while rest:
+        word = rest.pop(0)
+        if word == 'fade':
+            if not rest:
+                raise EffectError(f'{where}: fade needs a length')
+            fade_ms = parse_int(where, rest.pop(0), 'fade', U16_MAX)
+            curve = 'linear'
+            if rest and rest[0] in CURVES:
+                curve = rest.pop(0)
+        elif word == 'wait_look':
+            wait = True
+        else:
+            raise EffectError(f'{where}: unexpected "{word}"')
+
+    if fade_ms > 0 and channel in WHEELS:
+        raise EffectError(f'{where}: the {channel} wheel cannot fade')
+
+    return Key(where, at_ms, channel, value, value_c, fade_ms, curve, wait)
+
+
+def parse_file(path, constants, effects):
+    current = None
+    with open(path, encoding='utf-8') as f:
+        for number, line in enumerate(f, 1):
+            where = f'{os.path.basename(path)}:{number}'
+            words = line.split('#', 1)[0].split()
+            if not words:
+                continue
+
+            if words[0] == 'effect':
+                if len(words) != 2 or not re.fullmatch(r'[a-z_][a-z0-9_]*', words[1]):
+                    raise EffectError(f'{where}: expected "effect <name>" in lower case')
+                if words[1] in effects:
+                    raise EffectError(f'{where}: effect {words[1]} already defined at {effects[words[1]].where}')
+                current = Effect(where, words[1])
+                effects[current.name] = current
+                continue
+
+            if current is None:
+                raise EffectError(f'{where}: statement outside an effect')
+
+            if words[0] == 'passes' and len(words) == 2:
+                current.passes = parse_int(where, words[1], 'passes', U16_MAX)
+                if current.passes == 0:
+                    raise EffectError(f'{where}: passes must be at least 1')
+            elif words[0] == 'duration' and len(words) == 2:
+                current.duration_ms = parse_int(where, words[1], 'duration', 0xFFFFFFFF)
+            elif words[0] == 'next' and len(words) == 2:
+                current.next = words[1]
+            else:
+                current.keys.append(parse_key(where, words, constants))
+
+
+def check(effects):
+    for effect in effects.values():
+        if not effect.keys:
+            raise EffectError(f'{effect.where}: effect {effect.name} has no keyframes')
+
+        end_ms = 0
+        fade_end = {}
+        last_at = 0
+        for key in effect.keys:
+            if key.at_ms < last_at:
+                raise EffectError(f'{key.where}: keyframes must be in time order')
+            last_at = key.at_ms
+            if fade_end.get(key.channel, 0) > key.at_ms:
+                raise EffectError(f'{key.where}: {key.channel} is still fading until {fade_end[key.channel]} ms')
+            fade_end[key.channel] = key.at_ms + key.fade_ms
+            end_ms = max(end_ms, key.at_ms + key.fade_ms)
+
+        if effect.duration_ms is None:
+            effect.duration_ms = end_ms
+        elif effect.duration_ms < end_ms:
+            raise EffectError(f'{effect.where}: effect {effect.name} runs {end_ms} ms, '
+                              f'longer than its duration {effect.duration_ms} ms')
+
+        if effect.next is not None and effect.next not in effects:
+            raise EffectError(f'{effect.where}: next effect {effect.next} is not defined')
+
+    for effect in effects.values():
+        seen = [effect.name]
+        name = effect.next
+        while name is not None:
+            if name in seen:
+                raise EffectError(f'{effect.where}: chain {" -> ".join(seen + [name])} never ends')
+            seen.append(name)
+            name = effects[name].next
+
+
+def chain_ms(effects, effect):
+    total = 0
+    while effect is not None:
+        total += effect.passes * effect.duration_ms
+        effect = effects[effect.next] if effect.next else None
+    return total
+
+
+def emit(effects, sources, out):
+    lines = [
+        '/*',
+        ' * Generated by tools/compile_effects.py from ' + ', '.join(os.path.basename(s) for s in sources) + '.',
+        ' * Do not edit; change the .fx files instead.',
+        ' */',
+        '',
+        '#include "light_effects.h"',
+        '',
+    ]
+
+    for effect in effects.values():
+        lines.append(f'extern const light_effect_t light_effect_{effect.name};')
+    lines.append('')
+
+    for effect in effects.values():
+        lines.append(f'// {effect.name}: {effect.passes} x {effect.duration_ms} ms')
+        lines.append(f'static const light_fx_key_t {effect.name}_keys[] = {{')
+        for key in effect.keys:
+            curve = CURVES[key.curve] if key.fade_ms > 0 else 'LIGHT_FX_CURVE_STEP'
+            flags = 'LIGHT_FX_WAIT_LOOK' if key.wait else '0'
+            op = f'LIGHT_FX_OP({CHANNELS[key.channel][0]}, {curve}, {flags})'
+            lines.append(f'    {{{key.at_ms}, {key.fade_ms}, {op}, {key.value_c}}},')
+        lines.append('};')
+        lines.append('')
+        lines.append(f'const light_effect_t light_effect_{effect.name} = {{')
+        lines.append(f'    .name = "{effect.name}",')
+        lines.append(f'    .keys = {effect.name}_keys,')
+        lines.append(f'    .key_count = {len(effect.keys)},')
+        lines.append(f'    .passes = {effect.passes},')
+        lines.append(f'    .duration_ms = {effect.duration_ms},')
+        if effect.next is not None:
+            lines.append(f'    .next = &light_effect_{effect.next},')
+        lines.append('};')
+        lines.append('')
+
+    text = '\n'.join(lines)
+    # Leave the file alone when nothing changed so the build does not recompile it
+    if os.path.exists(out):
+        with open(out, encoding='utf-8') as f:
+            if f.read() == text:
+                return
+    with open(out, 'w', encoding='utf-8') as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n', 1)[0])
+    parser.add_argument('--header', required=True, help='mh_x25_driver.h for the named channel values')
+    parser.add_argument('-o', '--output', required=True, help='C file to write')
+    parser.add_argument('sources', nargs='+', help='.fx effect descriptions')
+    args = parser.parse_args()
+
+    try:
+        constants = load_constants(args.header)
+        effects = {}
+        for source in args.sources:
+            parse_file(source, constants, effects)
+        check(effects)
+    except (EffectError, OSError) as e:
+        print(f'error: {e}', file=sys.stderr)
+        return 1
+
+    emit(effects, args.sources, args.output)
+
+    total_keys = 0
+    for effect in effects.values():
+        total_keys += len(effect.keys)
+        chain = f', chain {chain_ms(effects, effect)} ms' if effect.next else ''
+        print(f'effect {effect.name}: {len(effect.keys)} keys, '
+              f'{effect.passes} x {effect.duration_ms} ms{chain}')
+    print(f'{len(effects)} effects, {total_keys * KEY_BYTES} bytes of keyframes')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
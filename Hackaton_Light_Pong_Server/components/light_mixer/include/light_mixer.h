@@ -0,0 +1,193 @@
+/**
+ * @file light_mixer.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Priority mixer between look writers and the MH-X25 driver
+ *
+ * Each writer (the ball, an effect player, ...) owns a layer and sets the
+ * channels it wants; the layer keeps them until they are released. Once per
+ * DMX frame the mixer resolves all layers into one mh_x25_apply():
+ *
+ * - Dimmer is highest-takes-precedence: the brightest contribution wins, so a
+ *   layer cannot darken the beam while another one lights it.
+ * - Every other channel is latest-takes-precedence within the highest
+ *   priority that contributes it: a higher-priority layer covers lower ones
+ *   for as long as it holds the channel, and among equal priorities the most
+ *   recent write wins.
+ *
+ * Channels no layer holds are left alone. Pan and tilt are not mixed; they
+ * belong to the motion engine.
+ */
+
+#ifndef LIGHT_MIXER_H
+#define LIGHT_MIXER_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "dmx_driver.h"
+#include "mh_x25_driver.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define LIGHT_MIXER_MAX_LAYERS 4
+
+/* Channels a layer may hold */
+#define LIGHT_MIXER_CHANNELS (MH_X25_APPLY_ALL & ~MH_X25_APPLY_POSITION)
+
+    /**
+     * @brief Mixer configuration
+     */
+    typedef struct
+    {
+        dmx_handle_t dmx_handle; ///< Universe whose frames clock the mixer
+        mh_x25_handle_t fixture; ///< Fixture on that universe to write
+    } light_mixer_config_t;
+
+    /**
+     * @brief Mixer handle
+     */
+    typedef struct light_mixer_t *light_mixer_handle_t;
+
+    /**
+     * @brief Layer handle
+     */
+    typedef struct light_mixer_layer_t *light_mixer_layer_handle_t;
+
+    /**
+     * @brief Caller-provided storage for light_mixer_init_static()
+     *
+     * Must outlive the handle. The contents are private to the mixer.
+     */
+    typedef struct
+    {
+        uint64_t reserved[48];
+    } light_mixer_static_t;
+
+    /**
+     * @brief Create a mixer
+     *
+     * The mixer resolves layers only after light_mixer_start().
+     *
+     * @param config Pointer to configuration structure
+     * @param out_mixer Pointer to store the mixer handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: Out of memory
+     */
+    esp_err_t light_mixer_init(const light_mixer_config_t *config, light_mixer_handle_t *out_mixer);
+
+    /**
+     * @brief Create a mixer in caller-provided storage
+     *
+     * Same as light_mixer_init() without allocating the mixer context.
+     *
+     * @param config Pointer to configuration structure
+     * @param storage Storage for the mixer, must outlive the handle
+     * @param out_mixer Pointer to store the mixer handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t light_mixer_init_static(const light_mixer_config_t *config, light_mixer_static_t *storage,
+                                      light_mixer_handle_t *out_mixer);
+
+    /**
+     * @brief Detach the mixer from the frame clock and release it
+     *
+     * The fixture keeps the last resolved values. Layer handles become invalid.
+     *
+     * @param mixer Mixer handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t light_mixer_deinit(light_mixer_handle_t mixer);
+
+    /**
+     * @brief Add a layer
+     *
+     * @param mixer Mixer handle
+     * @param priority Higher numbers cover lower ones on LTP channels
+     * @param out_layer Pointer to store the layer handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: LIGHT_MIXER_MAX_LAYERS layers already added
+     */
+    esp_err_t light_mixer_add_layer(light_mixer_handle_t mixer, uint8_t priority,
+                                    light_mixer_layer_handle_t *out_layer);
+
+    /**
+     * @brief Attach the mixer to the universe's frame clock
+     *
+     * Frame callbacks run in the order they were added, so start the mixer
+     * after the layer writers that run from the frame clock (effect players)
+     * have been created; their writes then go out in the same frame.
+     *
+     * @param mixer Mixer handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_NO_MEM: No frame callback slot left
+     */
+    esp_err_t light_mixer_start(light_mixer_handle_t mixer);
+
+    /**
+     * @brief Set channels of a layer
+     *
+     * Takes only a spinlock and may be called from a frame callback. The
+     * values go out with the next resolve.
+     *
+     * @param layer Layer handle
+     * @param state Values for the channels in mask
+     * @param mask MH_X25_APPLY_* bits, within LIGHT_MIXER_CHANNELS
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments or pan/tilt in mask
+     */
+    esp_err_t light_mixer_set(light_mixer_layer_handle_t layer, const mh_x25_state_t *state, uint32_t mask);
+
+    /**
+     * @brief Stop a layer contributing channels
+     *
+     * The channels fall back to the remaining layers, or keep their value if
+     * no layer holds them any more.
+     *
+     * @param layer Layer handle
+     * @param mask MH_X25_APPLY_* bits to release
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t light_mixer_release(light_mixer_layer_handle_t layer, uint32_t mask);
+
+    /**
+     * @brief Resolve the layers into the fixture now instead of at the next frame
+     *
+     * For writers that need the result in the driver right away, e.g. to
+     * read mh_x25_get_look_ready() for the look they just set.
+     *
+     * @param mixer Mixer handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t light_mixer_flush(light_mixer_handle_t mixer);
+
+    /**
+     * @brief Get the mixer a layer belongs to
+     *
+     * @param layer Layer handle
+     * @return Mixer handle, NULL for an invalid layer
+     */
+    light_mixer_handle_t light_mixer_get_mixer(light_mixer_layer_handle_t layer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIGHT_MIXER_H
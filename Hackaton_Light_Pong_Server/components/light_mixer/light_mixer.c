@@ -0,0 +1,382 @@
+/**
+ * @file light_mixer.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Priority mixer implementation
+ */
+
+#include "light_mixer.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+
+static const char *TAG = "MIXER";
+
+#define LIGHT_MIXER_CHANNEL_BITS 10  // MH_X25_APPLY_* bits, pan and tilt unused
+#define LIGHT_MIXER_DETACH_WAIT_TICKS 5 // Upper bound for the TX task to leave the callback
+
+struct light_mixer_layer_t
+{
+    struct light_mixer_t *mixer;                // Mixer the layer belongs to
+    mh_x25_state_t state;                       // Values of the held channels
+    uint32_t mask;                              // Channels the layer holds
+    uint32_t stamp[LIGHT_MIXER_CHANNEL_BITS];   // Write order per channel, for LTP
+    uint8_t priority;
+};
+
+struct light_mixer_t
+{
+    dmx_handle_t dmx_handle;   // Universe clocking the mixer
+    mh_x25_handle_t fixture;   // Fixture being written
+    portMUX_TYPE lock;         // Guards the layers, stamps and dirty flag
+    struct light_mixer_layer_t layers[LIGHT_MIXER_MAX_LAYERS];
+    uint8_t layer_count;
+    uint32_t next_stamp;       // Stamp of the next write
+    bool dirty;                // Layers changed since the last resolve
+    bool started;              // Attached to the frame clock
+    bool is_static;            // Lives in light_mixer_static_t storage
+};
+
+_Static_assert(sizeof(struct light_mixer_t) <= sizeof(light_mixer_static_t),
+               "light_mixer_static_t too small for the mixer context");
+
+static uint8_t *light_mixer_field(mh_x25_state_t *state, uint8_t bit)
+{
+    switch (1u << bit)
+    {
+    case MH_X25_APPLY_SPEED:
+        return &state->speed;
+    case MH_X25_APPLY_COLOR:
+        return &state->color;
+    case MH_X25_APPLY_SHUTTER:
+        return &state->shutter;
+    case MH_X25_APPLY_DIMMER:
+        return &state->dimmer;
+    case MH_X25_APPLY_GOBO:
+        return &state->gobo;
+    case MH_X25_APPLY_GOBO_ROT:
+        return &state->gobo_rotation;
+    case MH_X25_APPLY_SPECIAL:
+        return &state->special;
+    case MH_X25_APPLY_PROGRAM:
+        return &state->program;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Combine the layers into one state (lock held)
+ *
+ * @return MH_X25_APPLY_* bits of the channels any layer holds
+ */
+static uint32_t light_mixer_combine(struct light_mixer_t *mixer, mh_x25_state_t *out)
+{
+    uint32_t out_mask = 0;
+
+    for (uint8_t bit = 0; bit < LIGHT_MIXER_CHANNEL_BITS; bit++)
+    {
+        uint8_t *out_field = light_mixer_field(out, bit);
+        if (out_field == NULL)
+        {
+            continue;
+        }
+
+        const struct light_mixer_layer_t *winner = NULL;
+        for (uint8_t i = 0; i < mixer->layer_count; i++)
+        {
+            struct light_mixer_layer_t *layer = &mixer->layers[i];
+            if (!(layer->mask & (1u << bit)))
+            {
+                continue;
+            }
+
+            uint8_t value = *light_mixer_field(&layer->state, bit);
+
+            if ((1u << bit) == MH_X25_APPLY_DIMMER)
+            {
+                // HTP
+                if (winner == NULL || value > *out_field)
+                {
+                    winner = layer;
+                    *out_field = value;
+                }
+                continue;
+            }
+
+            // LTP within the highest priority; stamps compare by wrapping difference
+            if (winner == NULL || layer->priority > winner->priority ||
+                (layer->priority == winner->priority && (int32_t)(layer->stamp[bit] - winner->stamp[bit]) > 0))
+            {
+                winner = layer;
+                *out_field = value;
+            }
+        }
+
+        if (winner != NULL)
+        {
+            out_mask |= 1u << bit;
+        }
+    }
+
+    return out_mask;
+}
+
+/**
+ * @brief Write the combined layers to the fixture
+ *
+ * The DMX transaction serializes resolves from the TX task and from
+ * light_mixer_flush(), so an older combination never lands after a newer one.
+ */
+static void light_mixer_resolve(struct light_mixer_t *mixer, bool force)
+{
+    if (dmx_begin(mixer->dmx_handle) != ESP_OK)
+    {
+        return;
+    }
+
+    mh_x25_state_t state = {0};
+    uint32_t mask = 0;
+
+    portENTER_CRITICAL(&mixer->lock);
+    bool resolve = force || mixer->dirty;
+    mixer->dirty = false;
+    if (resolve)
+    {
+        mask = light_mixer_combine(mixer, &state);
+    }
+    portEXIT_CRITICAL(&mixer->lock);
+
+    // Channels that did not change are suppressed by the driver
+    if (mask != 0)
+    {
+        mh_x25_apply(mixer->fixture, &state, mask);
+    }
+
+    dmx_commit(mixer->dmx_handle);
+}
+
+/**
+ * @brief Resolve changed layers into the upcoming frame (DMX TX task)
+ */
+static void light_mixer_frame_cb(dmx_handle_t dmx_handle, int64_t next_frame_us, void *arg)
+{
+    light_mixer_resolve((struct light_mixer_t *)arg, false);
+}
+
+/**
+ * @brief Check a configuration before any storage is touched
+ */
+static esp_err_t light_mixer_check_config(const light_mixer_config_t *config, const void *out_mixer)
+{
+    if (config == NULL || out_mixer == NULL || config->dmx_handle == NULL || config->fixture == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+static void light_mixer_setup(struct light_mixer_t *mixer, const light_mixer_config_t *config)
+{
+    mixer->dmx_handle = config->dmx_handle;
+    mixer->fixture = config->fixture;
+    portMUX_INITIALIZE(&mixer->lock);
+}
+
+esp_err_t light_mixer_init(const light_mixer_config_t *config, light_mixer_handle_t *out_mixer)
+{
+    esp_err_t ret = light_mixer_check_config(config, out_mixer);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    struct light_mixer_t *mixer = (struct light_mixer_t *)calloc(1, sizeof(struct light_mixer_t));
+    if (mixer == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    light_mixer_setup(mixer, config);
+
+    *out_mixer = mixer;
+    return ESP_OK;
+}
+
+esp_err_t light_mixer_init_static(const light_mixer_config_t *config, light_mixer_static_t *storage,
+                                  light_mixer_handle_t *out_mixer)
+{
+    esp_err_t ret = light_mixer_check_config(config, out_mixer);
+    if (ret != ESP_OK || storage == NULL)
+    {
+        return (ret != ESP_OK) ? ret : ESP_ERR_INVALID_ARG;
+    }
+
+    struct light_mixer_t *mixer = (struct light_mixer_t *)storage;
+    memset(mixer, 0, sizeof(*mixer));
+    mixer->is_static = true;
+
+    light_mixer_setup(mixer, config);
+
+    *out_mixer = mixer;
+    return ESP_OK;
+}
+
+esp_err_t light_mixer_deinit(light_mixer_handle_t mixer)
+{
+    if (mixer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (mixer->started)
+    {
+        dmx_frame_info_t before;
+        dmx_get_last_frame(mixer->dmx_handle, &before);
+        dmx_remove_frame_callback(mixer->dmx_handle, light_mixer_frame_cb, mixer);
+
+        // The TX task may be inside the callback right now; it has left it once
+        // the next frame went out. Without transmission the wait just times out.
+        for (int i = 0; i < LIGHT_MIXER_DETACH_WAIT_TICKS; i++)
+        {
+            dmx_frame_info_t now;
+            dmx_get_last_frame(mixer->dmx_handle, &now);
+            if (now.sequence != before.sequence)
+            {
+                break;
+            }
+            vTaskDelay(1);
+        }
+    }
+
+    if (!mixer->is_static)
+    {
+        free(mixer);
+    }
+    ESP_LOGI(TAG, "Mixer released");
+
+    return ESP_OK;
+}
+
+esp_err_t light_mixer_add_layer(light_mixer_handle_t mixer, uint8_t priority,
+                                light_mixer_layer_handle_t *out_layer)
+{
+    if (mixer == NULL || out_layer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct light_mixer_layer_t *layer = NULL;
+
+    portENTER_CRITICAL(&mixer->lock);
+    if (mixer->layer_count < LIGHT_MIXER_MAX_LAYERS)
+    {
+        layer = &mixer->layers[mixer->layer_count];
+        memset(layer, 0, sizeof(*layer));
+        layer->mixer = mixer;
+        layer->priority = priority;
+        mixer->layer_count++;
+    }
+    portEXIT_CRITICAL(&mixer->lock);
+
+    if (layer == NULL)
+    {
+        ESP_LOGE(TAG, "No free layer (max %d)", LIGHT_MIXER_MAX_LAYERS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    *out_layer = layer;
+    return ESP_OK;
+}
+
+esp_err_t light_mixer_start(light_mixer_handle_t mixer)
+{
+    if (mixer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (mixer->started)
+    {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = dmx_add_frame_callback(mixer->dmx_handle, light_mixer_frame_cb, mixer);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to attach to the frame clock: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    mixer->started = true;
+
+    ESP_LOGI(TAG, "Mixer started with %d layers", mixer->layer_count);
+    return ESP_OK;
+}
+
+esp_err_t light_mixer_set(light_mixer_layer_handle_t layer, const mh_x25_state_t *state, uint32_t mask)
+{
+    if (layer == NULL || state == NULL || (mask & ~LIGHT_MIXER_CHANNELS) != 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct light_mixer_t *mixer = layer->mixer;
+
+    portENTER_CRITICAL(&mixer->lock);
+    uint32_t stamp = mixer->next_stamp++;
+    for (uint8_t bit = 0; bit < LIGHT_MIXER_CHANNEL_BITS; bit++)
+    {
+        if (mask & (1u << bit))
+        {
+            *light_mixer_field(&layer->state, bit) = *light_mixer_field((mh_x25_state_t *)state, bit);
+            layer->stamp[bit] = stamp;
+        }
+    }
+    layer->mask |= mask;
+    mixer->dirty = true;
+    portEXIT_CRITICAL(&mixer->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t light_mixer_release(light_mixer_layer_handle_t layer, uint32_t mask)
+{
+    if (layer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct light_mixer_t *mixer = layer->mixer;
+
+    portENTER_CRITICAL(&mixer->lock);
+    if (layer->mask & mask)
+    {
+        layer->mask &= ~mask;
+        mixer->dirty = true;
+    }
+    portEXIT_CRITICAL(&mixer->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t light_mixer_flush(light_mixer_handle_t mixer)
+{
+    if (mixer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    light_mixer_resolve(mixer, true);
+    return ESP_OK;
+}
+
+light_mixer_handle_t light_mixer_get_mixer(light_mixer_layer_handle_t layer)
+{
+    return (layer != NULL) ? layer->mixer : NULL;
+}
@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include "esp_err.h"
 #include "dmx_driver.h"
+#include "fixture.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -114,6 +115,14 @@ extern "C"
 #define MH_X25_SPECIAL_RESET_GOBO_ROT 132       // 128-135 Gobo rotation reset
 #define MH_X25_SPECIAL_RESET_ALL 156            // 152-159 All channel reset
 
+    /**
+     * @brief 12-channel personality for the fixture layer (fixture_add())
+     *
+     * Lets several MH-X25 heads share a universe through a fixture rig
+     * instead of one driver instance each.
+     */
+    extern const fixture_profile_t mh_x25_profile;
+
     /**
      * @brief MH X25 Device Configuration
      */
@@ -128,6 +137,63 @@ extern "C"
      */
     typedef void *mh_x25_handle_t;
 
+    /**
+     * @brief Complete fixture state for mh_x25_apply()
+     *
+     * Pan and tilt are 16-bit (coarse in the high byte, fine in the low
+     * byte); use value << 8 for 8-bit positions.
+     */
+    typedef struct
+    {
+        uint16_t pan;          ///< Pan position (0-65535)
+        uint16_t tilt;         ///< Tilt position (0-65535)
+        uint8_t speed;         ///< Pan/tilt speed (see MH_X25_SPEED_*)
+        uint8_t color;         ///< Color wheel (see MH_X25_COLOR_*)
+        uint8_t shutter;       ///< Shutter/strobe (see MH_X25_SHUTTER_*)
+        uint8_t dimmer;        ///< Dimmer (0-255)
+        uint8_t gobo;          ///< Gobo wheel (see MH_X25_GOBO_*)
+        uint8_t gobo_rotation; ///< Gobo rotation (see MH_X25_GOBO_ROT_*)
+        uint8_t special;       ///< Special functions (see MH_X25_SPECIAL_*)
+        uint8_t program;       ///< Built-in programs
+    } mh_x25_state_t;
+
+    /**
+     * @brief Write counters
+     *
+     * Setters and mh_x25_apply() compare against the driver's copy of the
+     * fixture channels and skip writes that would not change anything.
+     */
+    typedef struct
+    {
+        uint32_t writes_issued;     ///< DMX writes made (one writer lock round-trip each)
+        uint32_t writes_suppressed; ///< Calls that changed nothing and were not written
+    } mh_x25_write_stats_t;
+
+/* Change mask bits for mh_x25_apply() */
+#define MH_X25_APPLY_PAN (1 << 0)
+#define MH_X25_APPLY_TILT (1 << 1)
+#define MH_X25_APPLY_SPEED (1 << 2)
+#define MH_X25_APPLY_COLOR (1 << 3)
+#define MH_X25_APPLY_SHUTTER (1 << 4)
+#define MH_X25_APPLY_DIMMER (1 << 5)
+#define MH_X25_APPLY_GOBO (1 << 6)
+#define MH_X25_APPLY_GOBO_ROT (1 << 7)
+#define MH_X25_APPLY_SPECIAL (1 << 8)
+#define MH_X25_APPLY_PROGRAM (1 << 9)
+#define MH_X25_APPLY_POSITION (MH_X25_APPLY_PAN | MH_X25_APPLY_TILT)
+#define MH_X25_APPLY_LOOK (MH_X25_APPLY_COLOR | MH_X25_APPLY_GOBO | MH_X25_APPLY_GOBO_ROT)
+#define MH_X25_APPLY_ALL 0x03FF
+
+    /**
+     * @brief Caller-provided storage for mh_x25_init_static()
+     *
+     * Must outlive the handle. The contents are private to the driver.
+     */
+    typedef struct
+    {
+        uint64_t reserved[8];
+    } mh_x25_static_t;
+
     /**
      * @brief Initialize MH X25 device
      *
@@ -140,6 +206,21 @@ extern "C"
      */
     esp_err_t mh_x25_init(const mh_x25_config_t *config, mh_x25_handle_t *out_handle);
 
+    /**
+     * @brief Initialize MH X25 device in caller-provided storage
+     *
+     * Same as mh_x25_init() without allocating the device context.
+     *
+     * @param config Pointer to configuration structure
+     * @param storage Storage for the device, must outlive the handle
+     * @param out_handle Pointer to store the device handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_init_static(const mh_x25_config_t *config, mh_x25_static_t *storage,
+                                 mh_x25_handle_t *out_handle);
+
     /**
      * @brief Deinitialize MH X25 device
      *
@@ -273,6 +354,118 @@ extern "C"
      */
     esp_err_t mh_x25_set_special(mh_x25_handle_t handle, uint8_t special);
 
+    /**
+     * @brief Set pan, tilt, color, shutter, gobo and gobo rotation at once
+     *
+     * @param handle Device handle
+     * @param pan Pan value (0-255)
+     * @param tilt Tilt value (0-255)
+     * @param color Color value (see MH_X25_COLOR_* macros)
+     * @param shutter Shutter value (see MH_X25_SHUTTER_* macros)
+     * @param gobo Gobo value (see MH_X25_GOBO_* macros)
+     * @param gobo_rot Rotation value (see MH_X25_GOBO_ROT_* macros)
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_set_all(mh_x25_handle_t handle, uint8_t pan, uint8_t tilt,
+                             uint8_t color, uint8_t shutter, uint8_t gobo, uint8_t gobo_rot);
+
+    /**
+     * @brief Apply several fields of a fixture state in one DMX write
+     *
+     * Only the fields selected by mask are taken from state. Channels whose
+     * value actually changes are copied into the DMX universe under a single
+     * writer lock, so they always go out in the same frame. Nothing is
+     * written if no selected field changes.
+     *
+     * Channels outside the mask are never written, so tasks that own
+     * different fields (e.g. the motion engine owning pan/tilt) can apply
+     * concurrently without overwriting each other. The driver's channel
+     * copy is read and updated without a lock, so concurrent callers must
+     * select disjoint fields; two tasks applying the same field race.
+     *
+     * @param handle Device handle
+     * @param state Desired state
+     * @param mask MH_X25_APPLY_* bits selecting the fields to apply
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_apply(mh_x25_handle_t handle, const mh_x25_state_t *state, uint32_t mask);
+
+    /**
+     * @brief Get the current fixture state
+     *
+     * @param handle Device handle
+     * @param state Pointer to store the state
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_get_state(mh_x25_handle_t handle, mh_x25_state_t *state);
+
+    /**
+     * @brief Begin a group of setter calls that must land in the same DMX frame
+     *
+     * Wraps dmx_begin() on the fixture's DMX universe. Every mh_x25_set_* call
+     * made by the calling task until mh_x25_commit() is published as one frame.
+     * Groups may nest.
+     *
+     * @param handle Device handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: Nesting limit reached
+     */
+    esp_err_t mh_x25_begin(mh_x25_handle_t handle);
+
+    /**
+     * @brief Publish a group of setter calls started with mh_x25_begin()
+     *
+     * @param handle Device handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: No group open in this task
+     */
+    esp_err_t mh_x25_commit(mh_x25_handle_t handle);
+
+    /**
+     * @brief Send the current fixture state without waiting for the next refresh slot
+     *
+     * Wraps dmx_request_frame() for latency-critical changes such as a new
+     * ball position after a paddle hit.
+     *
+     * @param handle Device handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     *      - ESP_ERR_INVALID_STATE: DMX transmission not running
+     */
+    esp_err_t mh_x25_request_frame(mh_x25_handle_t handle);
+
+    /**
+     * @brief Get write counters
+     *
+     * @param handle Device handle
+     * @param stats Pointer to store the counters
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_get_write_stats(mh_x25_handle_t handle, mh_x25_write_stats_t *stats);
+
+    /**
+     * @brief Reset write counters
+     *
+     * @param handle Device handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t mh_x25_reset_write_stats(mh_x25_handle_t handle);
+
     /**
      * @brief Turn off the light (shutter and dimmer)
      *
@@ -283,6 +476,83 @@ extern "C"
      */
     esp_err_t mh_x25_off(mh_x25_handle_t handle);
 
+    /**
+     * @brief Predict how long the head takes to travel a distance
+     *
+     * Looks up the calibration table in mh_x25_kinematics.c, interpolating
+     * between measured distances and speed settings. Pan and tilt move
+     * simultaneously, so the slower axis decides. The fixture's response
+     * latency (DMX change to first movement) is included.
+     *
+     * @param pan_distance Pan travel in 16-bit position units
+     * @param tilt_distance Tilt travel in 16-bit position units
+     * @param speed Pan/tilt speed channel value (see MH_X25_SPEED_*)
+     * @return Time in milliseconds from the DMX frame until the beam settles
+     */
+    uint32_t mh_x25_travel_time_ms(uint16_t pan_distance, uint16_t tilt_distance, uint8_t speed);
+
+    /**
+     * @brief Predict when a move from the current position arrives
+     *
+     * Uses the position and speed channel the driver last wrote.
+     *
+     * @param handle Device handle
+     * @param pan Target pan (0-65535)
+     * @param tilt Target tilt (0-65535)
+     * @param start_us esp_timer time of the frame carrying the move
+     * @param arrival_us Pointer to store the expected esp_timer arrival time
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_predict_arrival(mh_x25_handle_t handle, uint16_t pan, uint16_t tilt,
+                                     int64_t start_us, int64_t *arrival_us);
+
+    /**
+     * @brief Predict how long a wheel takes between two channel values
+     *
+     * The color and gobo wheels are mechanical: the wheel steps through
+     * every slot between the two positions, taking the shorter way round,
+     * then settles. Per-slot step times come from the calibration table in
+     * mh_x25_kinematics.c.
+     *
+     * @param channel MH_X25_CHANNEL_COLOR or MH_X25_CHANNEL_GOBO; other channels take 0
+     * @param from Current channel value
+     * @param to New channel value
+     * @return Time in milliseconds until the wheel is at rest; 0 if nothing moves
+     *         or the new value rotates the wheel continuously
+     */
+    uint32_t mh_x25_wheel_time_ms(uint8_t channel, uint8_t from, uint8_t to);
+
+    /**
+     * @brief Predict how long a look change would take to become stable
+     *
+     * Includes the rest of any wheel transition still in progress. Use it
+     * to pre-position the wheels early enough, e.g. while the beam is dark
+     * or in flight, so the look shows clean when it matters.
+     *
+     * @param handle Device handle
+     * @param state Desired look
+     * @param mask MH_X25_APPLY_* bits of the fields that would change
+     * @param settle_ms Pointer to store the time in milliseconds
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_plan_look(mh_x25_handle_t handle, const mh_x25_state_t *state, uint32_t mask,
+                               uint32_t *settle_ms);
+
+    /**
+     * @brief Get when the wheels settle after the changes made so far
+     *
+     * @param handle Device handle
+     * @param ready_us Pointer to store the esp_timer time; in the past when the look is stable
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t mh_x25_get_look_ready(mh_x25_handle_t handle, int64_t *ready_us);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,9 +6,13 @@
  */
 
 #include "mh_x25_driver.h"
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
 
 static const char *TAG = "MH_X25";
 
@@ -20,9 +24,113 @@ typedef struct
     dmx_handle_t dmx_handle;               // DMX driver handle
     uint16_t start_channel;                // DMX start channel
     uint8_t channels[MH_X25_NUM_CHANNELS]; // Current channel values
+    bool is_static;                        // Lives in mh_x25_static_t storage
+    _Atomic uint32_t writes_issued;        // DMX writes made, counted from the DMX and game tasks
+    _Atomic uint32_t writes_suppressed;    // Writes skipped, channels already held the values
+    portMUX_TYPE lock;                     // Guards look_ready_us, written by whichever task resolves the mixer
+    int64_t look_ready_us;                 // When the wheels settle after the last change
 } mh_x25_context_t;
 
-esp_err_t mh_x25_init(const mh_x25_config_t *config, mh_x25_handle_t *out_handle)
+_Static_assert(sizeof(mh_x25_context_t) <= sizeof(mh_x25_static_t),
+               "mh_x25_static_t too small for the device context");
+
+/**
+ * @brief Find the span of channels a write would change
+ *
+ * @param offset First fixture channel (MH_X25_CHANNEL_*)
+ * @param values New values for channels offset..offset+count-1
+ * @param first Pointer to store the index of the first changed value
+ * @param last Pointer to store the index of the last changed value
+ * @return true if at least one channel changes
+ */
+static bool mh_x25_changed_span(const mh_x25_context_t *ctx, uint8_t offset, const uint8_t *values,
+                                uint8_t count, int *first, int *last)
+{
+    *first = -1;
+    *last = -1;
+    for (int i = 0; i < count; i++)
+    {
+        if (values[i] != ctx->channels[offset + i])
+        {
+            if (*first < 0)
+            {
+                *first = i;
+            }
+            *last = i;
+        }
+    }
+
+    return *first >= 0;
+}
+
+/**
+ * @brief Write a changed span to the universe and the shadow copy
+ */
+static esp_err_t mh_x25_store(mh_x25_context_t *ctx, uint8_t offset, const uint8_t *values, int first, int last)
+{
+    esp_err_t ret = dmx_set_channels(ctx->dmx_handle, ctx->start_channel + offset + first,
+                                     &values[first], last - first + 1);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // Wheels start moving with this write
+    int64_t now = esp_timer_get_time();
+    int64_t ready_us = 0;
+    for (int i = first; i <= last; i++)
+    {
+        uint8_t channel = offset + i;
+        uint32_t ms = mh_x25_wheel_time_ms(channel, ctx->channels[channel], values[i]);
+        if (ms > 0 && now + (int64_t)ms * 1000 > ready_us)
+        {
+            ready_us = now + (int64_t)ms * 1000;
+        }
+    }
+
+    // 64-bit, so not written in one store on a 32-bit core
+    if (ready_us != 0)
+    {
+        portENTER_CRITICAL(&ctx->lock);
+        if (ready_us > ctx->look_ready_us)
+        {
+            ctx->look_ready_us = ready_us;
+        }
+        portEXIT_CRITICAL(&ctx->lock);
+    }
+
+    memcpy(&ctx->channels[offset + first], &values[first], last - first + 1);
+    return ESP_OK;
+}
+
+/**
+ * @brief Write fixture channels through the shadow copy
+ *
+ * Only the span between the first and last channel that actually changes is
+ * written; nothing is written if all channels already hold the values. The
+ * shadow copy is updated once the DMX write succeeded.
+ *
+ * @param offset First fixture channel (MH_X25_CHANNEL_*)
+ * @param values New values for channels offset..offset+count-1
+ */
+static esp_err_t mh_x25_write(mh_x25_context_t *ctx, uint8_t offset, const uint8_t *values, uint8_t count)
+{
+    int first;
+    int last;
+    if (!mh_x25_changed_span(ctx, offset, values, count, &first, &last))
+    {
+        atomic_fetch_add(&ctx->writes_suppressed, 1);
+        return ESP_OK;
+    }
+
+    atomic_fetch_add(&ctx->writes_issued, 1);
+    return mh_x25_store(ctx, offset, values, first, last);
+}
+
+/**
+ * @brief Check a configuration before any storage is touched
+ */
+static esp_err_t mh_x25_check_config(const mh_x25_config_t *config, const void *out_handle)
 {
     if (config == NULL || out_handle == NULL)
     {
@@ -42,6 +150,37 @@ esp_err_t mh_x25_init(const mh_x25_config_t *config, mh_x25_handle_t *out_handle
         return ESP_ERR_INVALID_ARG;
     }
 
+    return ESP_OK;
+}
+
+/**
+ * @brief Initialize a zeroed context and patch it into the universe
+ */
+static void mh_x25_setup(mh_x25_context_t *ctx, const mh_x25_config_t *config)
+{
+    ctx->dmx_handle = config->dmx_handle;
+    ctx->start_channel = config->start_channel;
+    portMUX_INITIALIZE(&ctx->lock);
+    atomic_init(&ctx->writes_issued, 0);
+    atomic_init(&ctx->writes_suppressed, 0);
+
+    memset(ctx->channels, 0, MH_X25_NUM_CHANNELS);
+
+    dmx_patch(ctx->dmx_handle, ctx->start_channel, MH_X25_NUM_CHANNELS);
+    dmx_set_channels(ctx->dmx_handle, ctx->start_channel, ctx->channels, MH_X25_NUM_CHANNELS);
+
+    ESP_LOGI(TAG, "MH X25 initialized: DMX channels %d-%d",
+             ctx->start_channel, ctx->start_channel + MH_X25_NUM_CHANNELS - 1);
+}
+
+esp_err_t mh_x25_init(const mh_x25_config_t *config, mh_x25_handle_t *out_handle)
+{
+    esp_err_t ret = mh_x25_check_config(config, out_handle);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
     mh_x25_context_t *ctx = (mh_x25_context_t *)calloc(1, sizeof(mh_x25_context_t));
     if (ctx == NULL)
     {
@@ -49,18 +188,28 @@ esp_err_t mh_x25_init(const mh_x25_config_t *config, mh_x25_handle_t *out_handle
         return ESP_ERR_NO_MEM;
     }
 
-    ctx->dmx_handle = config->dmx_handle;
-    ctx->start_channel = config->start_channel;
+    mh_x25_setup(ctx, config);
 
-    memset(ctx->channels, 0, MH_X25_NUM_CHANNELS);
+    *out_handle = (mh_x25_handle_t)ctx;
+    return ESP_OK;
+}
 
-    dmx_set_channels(ctx->dmx_handle, ctx->start_channel, ctx->channels, MH_X25_NUM_CHANNELS);
+esp_err_t mh_x25_init_static(const mh_x25_config_t *config, mh_x25_static_t *storage,
+                             mh_x25_handle_t *out_handle)
+{
+    esp_err_t ret = mh_x25_check_config(config, out_handle);
+    if (ret != ESP_OK || storage == NULL)
+    {
+        return (ret != ESP_OK) ? ret : ESP_ERR_INVALID_ARG;
+    }
 
-    *out_handle = (mh_x25_handle_t)ctx;
+    mh_x25_context_t *ctx = (mh_x25_context_t *)storage;
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->is_static = true;
 
-    ESP_LOGI(TAG, "MH X25 initialized: DMX channels %d-%d",
-             ctx->start_channel, ctx->start_channel + MH_X25_NUM_CHANNELS - 1);
+    mh_x25_setup(ctx, config);
 
+    *out_handle = (mh_x25_handle_t)ctx;
     return ESP_OK;
 }
 
@@ -75,7 +224,10 @@ esp_err_t mh_x25_deinit(mh_x25_handle_t handle)
 
     mh_x25_off(handle);
 
-    free(ctx);
+    if (!ctx->is_static)
+    {
+        free(ctx);
+    }
     ESP_LOGI(TAG, "MH X25 deinitialized");
 
     return ESP_OK;
@@ -89,11 +241,7 @@ esp_err_t mh_x25_set_pan(mh_x25_handle_t handle, uint8_t pan)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_PAN] = pan;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_PAN,
-                           pan);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_PAN, &pan, 1);
 }
 
 esp_err_t mh_x25_set_tilt(mh_x25_handle_t handle, uint8_t tilt)
@@ -104,14 +252,10 @@ esp_err_t mh_x25_set_tilt(mh_x25_handle_t handle, uint8_t tilt)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_TILT] = tilt;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_TILT,
-                           tilt);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_TILT, &tilt, 1);
 }
 
-esp_err_t mh_x25_set_position_16bit(mh_x25_handle_t handle, uint16_t pan_16bit, uint16_t tilt_16bit)
+esp_err_t mh_x25_set_position(mh_x25_handle_t handle, uint8_t pan, uint8_t tilt)
 {
     if (handle == NULL)
     {
@@ -120,33 +264,21 @@ esp_err_t mh_x25_set_position_16bit(mh_x25_handle_t handle, uint16_t pan_16bit,
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
 
-    uint8_t pan_coarse = (pan_16bit >> 8) & 0xFF;
-    uint8_t pan_fine = pan_16bit & 0xFF;
-    uint8_t tilt_coarse = (tilt_16bit >> 8) & 0xFF;
-    uint8_t tilt_fine = tilt_16bit & 0xFF;
-
-    // The fine and coarse channels are not contiguous, so we must send them as separate updates.
-    // Sending them as a single block was causing incorrect movement.
-
-    ctx->channels[MH_X25_CHANNEL_PAN] = pan_coarse;
-    ctx->channels[MH_X25_CHANNEL_TILT] = tilt_coarse;
-    ctx->channels[MH_X25_CHANNEL_PAN_FINE] = pan_fine;
-    ctx->channels[MH_X25_CHANNEL_TILT_FINE] = tilt_fine;
-
-    esp_err_t ret;
-    ret = dmx_set_channel(ctx->dmx_handle, ctx->start_channel + MH_X25_CHANNEL_PAN, pan_coarse);
-    if (ret != ESP_OK)
-        return ret;
-
-    ret = dmx_set_channel(ctx->dmx_handle, ctx->start_channel + MH_X25_CHANNEL_TILT, tilt_coarse);
-    if (ret != ESP_OK)
-        return ret;
+    // Pan and tilt are adjacent (channels 1-2)
+    uint8_t position[2] = {pan, tilt};
+    return mh_x25_write(ctx, MH_X25_CHANNEL_PAN, position, 2);
+}
 
-    ret = dmx_set_channel(ctx->dmx_handle, ctx->start_channel + MH_X25_CHANNEL_PAN_FINE, pan_fine);
-    if (ret != ESP_OK)
-        return ret;
+esp_err_t mh_x25_set_position_16bit(mh_x25_handle_t handle, uint16_t pan_16bit, uint16_t tilt_16bit)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    return dmx_set_channel(ctx->dmx_handle, ctx->start_channel + MH_X25_CHANNEL_TILT_FINE, tilt_fine);
+    // Coarse and fine channels go out in one write, so they always land in the same frame
+    mh_x25_state_t state = {.pan = pan_16bit, .tilt = tilt_16bit};
+    return mh_x25_apply(handle, &state, MH_X25_APPLY_POSITION);
 }
 
 esp_err_t mh_x25_set_speed(mh_x25_handle_t handle, uint8_t speed)
@@ -157,11 +289,7 @@ esp_err_t mh_x25_set_speed(mh_x25_handle_t handle, uint8_t speed)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_SPEED] = speed;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_SPEED,
-                           speed);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_SPEED, &speed, 1);
 }
 
 esp_err_t mh_x25_set_color(mh_x25_handle_t handle, uint8_t color)
@@ -172,11 +300,7 @@ esp_err_t mh_x25_set_color(mh_x25_handle_t handle, uint8_t color)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_COLOR] = color;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_COLOR,
-                           color);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_COLOR, &color, 1);
 }
 
 esp_err_t mh_x25_set_shutter(mh_x25_handle_t handle, uint8_t shutter)
@@ -187,11 +311,7 @@ esp_err_t mh_x25_set_shutter(mh_x25_handle_t handle, uint8_t shutter)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_SHUTTER] = shutter;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_SHUTTER,
-                           shutter);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_SHUTTER, &shutter, 1);
 }
 
 esp_err_t mh_x25_set_dimmer(mh_x25_handle_t handle, uint8_t dimmer)
@@ -202,11 +322,7 @@ esp_err_t mh_x25_set_dimmer(mh_x25_handle_t handle, uint8_t dimmer)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_DIMMER] = dimmer;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_DIMMER,
-                           dimmer);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_DIMMER, &dimmer, 1);
 }
 
 esp_err_t mh_x25_set_gobo(mh_x25_handle_t handle, uint8_t gobo)
@@ -217,11 +333,7 @@ esp_err_t mh_x25_set_gobo(mh_x25_handle_t handle, uint8_t gobo)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_GOBO] = gobo;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_GOBO,
-                           gobo);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_GOBO, &gobo, 1);
 }
 
 esp_err_t mh_x25_set_gobo_rotation(mh_x25_handle_t handle, uint8_t rotation)
@@ -232,11 +344,7 @@ esp_err_t mh_x25_set_gobo_rotation(mh_x25_handle_t handle, uint8_t rotation)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_GOBO_ROT] = rotation;
-
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_GOBO_ROT,
-                           rotation);
+    return mh_x25_write(ctx, MH_X25_CHANNEL_GOBO_ROT, &rotation, 1);
 }
 
 esp_err_t mh_x25_set_special(mh_x25_handle_t handle, uint8_t special)
@@ -247,15 +355,193 @@ esp_err_t mh_x25_set_special(mh_x25_handle_t handle, uint8_t special)
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
-    ctx->channels[MH_X25_CHANNEL_SPECIAL] = special;
+    return mh_x25_write(ctx, MH_X25_CHANNEL_SPECIAL, &special, 1);
+}
+
+/**
+ * @brief Where mh_x25_apply() takes a field from and which channels it sets
+ */
+typedef struct
+{
+    uint32_t mask;        // MH_X25_APPLY_* bit selecting the field
+    uint8_t offset;       // Offset of the field in mh_x25_state_t
+    uint8_t width;        // 1 for 8-bit fields, 2 for 16-bit coarse/fine fields
+    uint8_t channel;      // MH_X25_CHANNEL_* of the value, or of the coarse byte
+    uint8_t fine_channel; // MH_X25_CHANNEL_* of the fine byte, for 16-bit fields
+} mh_x25_apply_field_t;
+
+static const mh_x25_apply_field_t mh_x25_apply_fields[] = {
+    {MH_X25_APPLY_PAN, offsetof(mh_x25_state_t, pan), 2, MH_X25_CHANNEL_PAN, MH_X25_CHANNEL_PAN_FINE},
+    {MH_X25_APPLY_TILT, offsetof(mh_x25_state_t, tilt), 2, MH_X25_CHANNEL_TILT, MH_X25_CHANNEL_TILT_FINE},
+    {MH_X25_APPLY_SPEED, offsetof(mh_x25_state_t, speed), 1, MH_X25_CHANNEL_SPEED, 0},
+    {MH_X25_APPLY_COLOR, offsetof(mh_x25_state_t, color), 1, MH_X25_CHANNEL_COLOR, 0},
+    {MH_X25_APPLY_SHUTTER, offsetof(mh_x25_state_t, shutter), 1, MH_X25_CHANNEL_SHUTTER, 0},
+    {MH_X25_APPLY_DIMMER, offsetof(mh_x25_state_t, dimmer), 1, MH_X25_CHANNEL_DIMMER, 0},
+    {MH_X25_APPLY_GOBO, offsetof(mh_x25_state_t, gobo), 1, MH_X25_CHANNEL_GOBO, 0},
+    {MH_X25_APPLY_GOBO_ROT, offsetof(mh_x25_state_t, gobo_rotation), 1, MH_X25_CHANNEL_GOBO_ROT, 0},
+    {MH_X25_APPLY_SPECIAL, offsetof(mh_x25_state_t, special), 1, MH_X25_CHANNEL_SPECIAL, 0},
+    {MH_X25_APPLY_PROGRAM, offsetof(mh_x25_state_t, program), 1, MH_X25_CHANNEL_PROGRAM, 0},
+};
+
+esp_err_t mh_x25_apply(mh_x25_handle_t handle, const mh_x25_state_t *state, uint32_t mask)
+{
+    if (handle == NULL || state == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+    uint8_t next[MH_X25_NUM_CHANNELS];
+    memcpy(next, ctx->channels, MH_X25_NUM_CHANNELS);
+
+    // Channels outside the mask are never written, not even with their
+    // shadow value, so a caller that owns other channels (the motion engine
+    // driving pan/tilt from the DMX task) cannot be overwritten with stale data.
+    uint16_t selected = 0;
+    for (size_t i = 0; i < sizeof(mh_x25_apply_fields) / sizeof(mh_x25_apply_fields[0]); i++)
+    {
+        const mh_x25_apply_field_t *field = &mh_x25_apply_fields[i];
+        if (!(mask & field->mask))
+        {
+            continue;
+        }
+
+        const uint8_t *value = (const uint8_t *)state + field->offset;
+        if (field->width == 2)
+        {
+            uint16_t wide;
+            memcpy(&wide, value, sizeof(wide));
+            next[field->channel] = (wide >> 8) & 0xFF;
+            next[field->fine_channel] = wide & 0xFF;
+            selected |= 1 << field->fine_channel;
+        }
+        else
+        {
+            next[field->channel] = *value;
+        }
+        selected |= 1 << field->channel;
+    }
+
+    // Split the selection into runs of adjacent channels and keep the changed ones
+    struct
+    {
+        uint8_t offset;
+        int first;
+        int last;
+    } runs[MH_X25_NUM_CHANNELS];
+    int run_count = 0;
+
+    for (int ch = 0; ch < MH_X25_NUM_CHANNELS;)
+    {
+        if (!(selected & (1 << ch)))
+        {
+            ch++;
+            continue;
+        }
+
+        int start = ch;
+        while (ch < MH_X25_NUM_CHANNELS && (selected & (1 << ch)))
+        {
+            ch++;
+        }
+
+        int first;
+        int last;
+        if (mh_x25_changed_span(ctx, start, &next[start], ch - start, &first, &last))
+        {
+            runs[run_count].offset = start;
+            runs[run_count].first = first;
+            runs[run_count].last = last;
+            run_count++;
+        }
+    }
+
+    if (run_count == 0)
+    {
+        atomic_fetch_add(&ctx->writes_suppressed, 1);
+        return ESP_OK;
+    }
+
+    atomic_fetch_add(&ctx->writes_issued, 1);
+
+    // Several runs go out in one transaction so they land in the same frame
+    if (run_count > 1)
+    {
+        esp_err_t ret = dmx_begin(ctx->dmx_handle);
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+    }
+
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < run_count && ret == ESP_OK; i++)
+    {
+        ret = mh_x25_store(ctx, runs[i].offset, &next[runs[i].offset], runs[i].first, runs[i].last);
+    }
+
+    if (run_count > 1)
+    {
+        esp_err_t commit_ret = dmx_commit(ctx->dmx_handle);
+        if (ret == ESP_OK)
+        {
+            ret = commit_ret;
+        }
+    }
+
+    return ret;
+}
+
+esp_err_t mh_x25_get_state(mh_x25_handle_t handle, mh_x25_state_t *state)
+{
+    if (handle == NULL || state == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
 
-    return dmx_set_channel(ctx->dmx_handle,
-                           ctx->start_channel + MH_X25_CHANNEL_SPECIAL,
-                           special);
+    state->pan = (uint16_t)((ctx->channels[MH_X25_CHANNEL_PAN] << 8) | ctx->channels[MH_X25_CHANNEL_PAN_FINE]);
+    state->tilt = (uint16_t)((ctx->channels[MH_X25_CHANNEL_TILT] << 8) | ctx->channels[MH_X25_CHANNEL_TILT_FINE]);
+    state->speed = ctx->channels[MH_X25_CHANNEL_SPEED];
+    state->color = ctx->channels[MH_X25_CHANNEL_COLOR];
+    state->shutter = ctx->channels[MH_X25_CHANNEL_SHUTTER];
+    state->dimmer = ctx->channels[MH_X25_CHANNEL_DIMMER];
+    state->gobo = ctx->channels[MH_X25_CHANNEL_GOBO];
+    state->gobo_rotation = ctx->channels[MH_X25_CHANNEL_GOBO_ROT];
+    state->special = ctx->channels[MH_X25_CHANNEL_SPECIAL];
+    state->program = ctx->channels[MH_X25_CHANNEL_PROGRAM];
+
+    return ESP_OK;
 }
 
 esp_err_t mh_x25_set_all(mh_x25_handle_t handle, uint8_t pan, uint8_t tilt,
                          uint8_t color, uint8_t shutter, uint8_t gobo, uint8_t gobo_rot)
+{
+    mh_x25_state_t state = {
+        .pan = (uint16_t)(pan << 8),
+        .tilt = (uint16_t)(tilt << 8),
+        .color = color,
+        .shutter = shutter,
+        .gobo = gobo,
+        .gobo_rotation = gobo_rot};
+
+    return mh_x25_apply(handle, &state,
+                        MH_X25_APPLY_POSITION | MH_X25_APPLY_LOOK | MH_X25_APPLY_SHUTTER);
+}
+
+esp_err_t mh_x25_begin(mh_x25_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+    return dmx_begin(ctx->dmx_handle);
+}
+
+esp_err_t mh_x25_commit(mh_x25_handle_t handle)
 {
     if (handle == NULL)
     {
@@ -263,16 +549,18 @@ esp_err_t mh_x25_set_all(mh_x25_handle_t handle, uint8_t pan, uint8_t tilt,
     }
 
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+    return dmx_commit(ctx->dmx_handle);
+}
 
-    ctx->channels[MH_X25_CHANNEL_PAN] = pan;
-    ctx->channels[MH_X25_CHANNEL_TILT] = tilt;
-    ctx->channels[MH_X25_CHANNEL_COLOR] = color;
-    ctx->channels[MH_X25_CHANNEL_SHUTTER] = shutter;
-    ctx->channels[MH_X25_CHANNEL_GOBO] = gobo;
-    ctx->channels[MH_X25_CHANNEL_GOBO_ROT] = gobo_rot;
+esp_err_t mh_x25_request_frame(mh_x25_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    return dmx_set_channels(ctx->dmx_handle, ctx->start_channel,
-                            ctx->channels, MH_X25_NUM_CHANNELS);
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+    return dmx_request_frame(ctx->dmx_handle);
 }
 
 esp_err_t mh_x25_off(mh_x25_handle_t handle)
@@ -285,9 +573,103 @@ esp_err_t mh_x25_off(mh_x25_handle_t handle)
     mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
 
     ESP_LOGI(TAG, "Turning off light - setting dimmer to 0");
-    ctx->channels[MH_X25_CHANNEL_DIMMER] = MH_X25_DIMMER_OFF;
-    ctx->channels[MH_X25_CHANNEL_SHUTTER] = MH_X25_SHUTTER_BLACKOUT;
 
-    uint8_t off_data[2] = {ctx->channels[MH_X25_CHANNEL_SHUTTER], ctx->channels[MH_X25_CHANNEL_DIMMER]};
-    return dmx_set_channels(ctx->dmx_handle, ctx->start_channel + MH_X25_CHANNEL_SHUTTER, off_data, 2);
+    uint8_t off_data[2] = {MH_X25_SHUTTER_BLACKOUT, MH_X25_DIMMER_OFF};
+    return mh_x25_write(ctx, MH_X25_CHANNEL_SHUTTER, off_data, 2);
+}
+
+esp_err_t mh_x25_predict_arrival(mh_x25_handle_t handle, uint16_t pan, uint16_t tilt,
+                                 int64_t start_us, int64_t *arrival_us)
+{
+    if (handle == NULL || arrival_us == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_state_t current;
+    mh_x25_get_state(handle, &current);
+
+    uint16_t pan_distance = (pan > current.pan) ? pan - current.pan : current.pan - pan;
+    uint16_t tilt_distance = (tilt > current.tilt) ? tilt - current.tilt : current.tilt - tilt;
+
+    *arrival_us = start_us + (int64_t)mh_x25_travel_time_ms(pan_distance, tilt_distance, current.speed) * 1000;
+    return ESP_OK;
+}
+
+esp_err_t mh_x25_plan_look(mh_x25_handle_t handle, const mh_x25_state_t *state, uint32_t mask,
+                           uint32_t *settle_ms)
+{
+    if (handle == NULL || state == NULL || settle_ms == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+
+    uint32_t ms = 0;
+    if (mask & MH_X25_APPLY_COLOR)
+    {
+        ms = mh_x25_wheel_time_ms(MH_X25_CHANNEL_COLOR, ctx->channels[MH_X25_CHANNEL_COLOR], state->color);
+    }
+    if (mask & MH_X25_APPLY_GOBO)
+    {
+        uint32_t gobo_ms = mh_x25_wheel_time_ms(MH_X25_CHANNEL_GOBO, ctx->channels[MH_X25_CHANNEL_GOBO], state->gobo);
+        ms = (gobo_ms > ms) ? gobo_ms : ms;
+    }
+
+    // A wheel still travelling from the previous change has to get there first
+    portENTER_CRITICAL(&ctx->lock);
+    int64_t ready_us = ctx->look_ready_us;
+    portEXIT_CRITICAL(&ctx->lock);
+    int64_t pending_us = ready_us - esp_timer_get_time();
+    if (pending_us > 0)
+    {
+        ms += (uint32_t)(pending_us / 1000);
+    }
+
+    *settle_ms = ms;
+    return ESP_OK;
+}
+
+esp_err_t mh_x25_get_look_ready(mh_x25_handle_t handle, int64_t *ready_us)
+{
+    if (handle == NULL || ready_us == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+    portENTER_CRITICAL(&ctx->lock);
+    *ready_us = ctx->look_ready_us;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t mh_x25_get_write_stats(mh_x25_handle_t handle, mh_x25_write_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+    stats->writes_issued = atomic_load(&ctx->writes_issued);
+    stats->writes_suppressed = atomic_load(&ctx->writes_suppressed);
+
+    return ESP_OK;
+}
+
+esp_err_t mh_x25_reset_write_stats(mh_x25_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mh_x25_context_t *ctx = (mh_x25_context_t *)handle;
+    atomic_store(&ctx->writes_issued, 0);
+    atomic_store(&ctx->writes_suppressed, 0);
+
+    return ESP_OK;
 }
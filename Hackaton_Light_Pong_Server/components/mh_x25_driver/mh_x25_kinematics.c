@@ -0,0 +1,233 @@
+/**
+ * @file mh_x25_kinematics.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief MH-X25 pan/tilt travel time and wheel transition model
+ *
+ * Travel times are looked up in a calibration table indexed by the speed
+ * channel and the distance travelled, with linear interpolation in both
+ * directions. Wheel transitions are costed slot by slot. The tables are
+ * const and stay in flash.
+ *
+ * To calibrate, time moves on the installed fixture from the DMX frame
+ * carrying the new position until the beam stops (e.g. from a 240 fps
+ * video of the table), for each distance column and speed row, and replace
+ * the figures below. The shipped figures are conservative estimates, so
+ * predicted arrivals err on the late side.
+ */
+
+#include "mh_x25_driver.h"
+#include <stdbool.h>
+
+#define MH_X25_KIN_SPEEDS 5
+#define MH_X25_KIN_DISTANCES 7
+#define MH_X25_RESPONSE_MS 40 // DMX frame to first movement
+
+/* Speed channel values the rows were measured at */
+static const uint8_t mh_x25_kin_speed[MH_X25_KIN_SPEEDS] = {0, 64, 128, 192, 255};
+
+/* Distances the columns were measured at, 16-bit position units */
+static const uint16_t mh_x25_kin_distance[MH_X25_KIN_DISTANCES] = {0, 1024, 4096, 8192, 16384, 32768, 65535};
+
+/* Pan travel time in ms (540 degree range), excluding response latency */
+static const uint16_t mh_x25_kin_pan_ms[MH_X25_KIN_SPEEDS][MH_X25_KIN_DISTANCES] = {
+    {0, 90, 180, 260, 400, 680, 1250},
+    {0, 160, 330, 500, 820, 1450, 2700},
+    {0, 260, 560, 900, 1550, 2850, 5400},
+    {0, 420, 950, 1650, 2950, 5600, 10800},
+    {0, 700, 1700, 3100, 5800, 11200, 21500},
+};
+
+/* Tilt travel time in ms (270 degree range), excluding response latency */
+static const uint16_t mh_x25_kin_tilt_ms[MH_X25_KIN_SPEEDS][MH_X25_KIN_DISTANCES] = {
+    {0, 70, 130, 190, 290, 480, 850},
+    {0, 120, 240, 370, 600, 1050, 1950},
+    {0, 200, 420, 680, 1150, 2100, 3950},
+    {0, 330, 720, 1250, 2200, 4150, 8000},
+    {0, 550, 1300, 2350, 4350, 8400, 16200},
+};
+
+/**
+ * @brief Interpolate one table row at a distance
+ */
+static uint32_t mh_x25_kin_row(const uint16_t *row, uint16_t distance)
+{
+    for (int i = 1; i < MH_X25_KIN_DISTANCES; i++)
+    {
+        if (distance <= mh_x25_kin_distance[i])
+        {
+            uint32_t d0 = mh_x25_kin_distance[i - 1];
+            uint32_t d1 = mh_x25_kin_distance[i];
+            return row[i - 1] + (uint32_t)(row[i] - row[i - 1]) * (distance - d0) / (d1 - d0);
+        }
+    }
+
+    return row[MH_X25_KIN_DISTANCES - 1];
+}
+
+/**
+ * @brief Interpolate a table at a speed setting and distance
+ */
+static uint32_t mh_x25_kin_lookup(const uint16_t table[MH_X25_KIN_SPEEDS][MH_X25_KIN_DISTANCES],
+                                  uint16_t distance, uint8_t speed)
+{
+    if (distance == 0)
+    {
+        return 0;
+    }
+
+    for (int i = 1; i < MH_X25_KIN_SPEEDS; i++)
+    {
+        if (speed <= mh_x25_kin_speed[i])
+        {
+            uint32_t s0 = mh_x25_kin_speed[i - 1];
+            uint32_t s1 = mh_x25_kin_speed[i];
+            uint32_t t0 = mh_x25_kin_row(table[i - 1], distance);
+            uint32_t t1 = mh_x25_kin_row(table[i], distance);
+            return t0 + (t1 - t0) * (speed - s0) / (s1 - s0);
+        }
+    }
+
+    return mh_x25_kin_row(table[MH_X25_KIN_SPEEDS - 1], distance);
+}
+
+uint32_t mh_x25_travel_time_ms(uint16_t pan_distance, uint16_t tilt_distance, uint8_t speed)
+{
+    uint32_t pan_ms = mh_x25_kin_lookup(mh_x25_kin_pan_ms, pan_distance, speed);
+    uint32_t tilt_ms = mh_x25_kin_lookup(mh_x25_kin_tilt_ms, tilt_distance, speed);
+
+    return MH_X25_RESPONSE_MS + ((pan_ms > tilt_ms) ? pan_ms : tilt_ms);
+}
+
+/* Wheels
+ *
+ * step_ms[i] is the time from slot i to slot i + 1; the last entry is the
+ * step across the seam back to slot 0 and is only used when the wheel takes
+ * the shorter way round. Rotating (rainbow) values have no fixed slot.
+ *
+ * The model assumes the wheels take the shorter way round; set wraps to
+ * false if the fixture is seen sweeping the long way instead.
+ */
+#define MH_X25_COLOR_SLOTS 9
+#define MH_X25_GOBO_SLOTS 8
+#define MH_X25_WHEEL_ROTATING 128 // Values from here on rotate the wheel continuously
+
+typedef struct
+{
+    uint8_t slots;
+    bool wraps;
+    uint16_t settle_ms;       // Stop and settle after the last step
+    const uint16_t *step_ms;  // Per-slot step times, slots entries
+} mh_x25_wheel_model_t;
+
+/* Color wheel: white, yellow, pink, green, peachblow, light blue, yellow green, red, dark blue */
+static const uint16_t mh_x25_color_step_ms[MH_X25_COLOR_SLOTS] = {90, 90, 90, 90, 90, 90, 90, 90, 90};
+
+/* Gobo wheel: open, gobo 2 to gobo 8 */
+static const uint16_t mh_x25_gobo_step_ms[MH_X25_GOBO_SLOTS] = {110, 110, 110, 110, 110, 110, 110, 110};
+
+static const mh_x25_wheel_model_t mh_x25_color_wheel = {
+    .slots = MH_X25_COLOR_SLOTS, .wraps = true, .settle_ms = 60, .step_ms = mh_x25_color_step_ms};
+
+static const mh_x25_wheel_model_t mh_x25_gobo_wheel = {
+    .slots = MH_X25_GOBO_SLOTS, .wraps = true, .settle_ms = 80, .step_ms = mh_x25_gobo_step_ms};
+
+/**
+ * @brief Slot a channel value parks the wheel at, -1 if the wheel rotates
+ */
+static int mh_x25_wheel_slot(uint8_t channel, uint8_t value)
+{
+    if (value >= MH_X25_WHEEL_ROTATING)
+    {
+        return -1;
+    }
+
+    if (channel == MH_X25_CHANNEL_COLOR)
+    {
+        int slot = value / 5;
+        return (slot < MH_X25_COLOR_SLOTS) ? slot : MH_X25_COLOR_SLOTS - 1;
+    }
+
+    // Shake ranges shake the last two gobos in place
+    if (value >= 72)
+    {
+        return 6;
+    }
+    if (value >= 64)
+    {
+        return 7;
+    }
+    return value / 8;
+}
+
+/**
+ * @brief Time to step from one slot to another in one direction
+ */
+static uint32_t mh_x25_wheel_steps_ms(const mh_x25_wheel_model_t *wheel, int from, int to)
+{
+    uint32_t ms = 0;
+    for (int slot = from; slot != to; slot = (slot + 1) % wheel->slots)
+    {
+        ms += wheel->step_ms[slot];
+    }
+    return ms;
+}
+
+/**
+ * @brief Shortest path between two slots
+ */
+static uint32_t mh_x25_wheel_path_ms(const mh_x25_wheel_model_t *wheel, int from, int to)
+{
+    if (from == to)
+    {
+        return 0;
+    }
+
+    if (!wheel->wraps)
+    {
+        return (from < to) ? mh_x25_wheel_steps_ms(wheel, from, to) : mh_x25_wheel_steps_ms(wheel, to, from);
+    }
+
+    uint32_t forward = mh_x25_wheel_steps_ms(wheel, from, to);
+    uint32_t backward = mh_x25_wheel_steps_ms(wheel, to, from);
+    return (forward < backward) ? forward : backward;
+}
+
+uint32_t mh_x25_wheel_time_ms(uint8_t channel, uint8_t from, uint8_t to)
+{
+    const mh_x25_wheel_model_t *wheel;
+    if (channel == MH_X25_CHANNEL_COLOR)
+    {
+        wheel = &mh_x25_color_wheel;
+    }
+    else if (channel == MH_X25_CHANNEL_GOBO)
+    {
+        wheel = &mh_x25_gobo_wheel;
+    }
+    else
+    {
+        return 0;
+    }
+
+    int to_slot = mh_x25_wheel_slot(channel, to);
+    if (to_slot < 0 || from == to)
+    {
+        // Rotation starts right away; there is no position to settle at
+        return 0;
+    }
+
+    int from_slot = mh_x25_wheel_slot(channel, from);
+    if (from_slot >= 0)
+    {
+        return mh_x25_wheel_path_ms(wheel, from_slot, to_slot) + wheel->settle_ms;
+    }
+
+    // Stopping a rotation leaves the wheel anywhere; assume the worst start
+    uint32_t worst = 0;
+    for (int slot = 0; slot < wheel->slots; slot++)
+    {
+        uint32_t ms = mh_x25_wheel_path_ms(wheel, slot, to_slot);
+        worst = (ms > worst) ? ms : worst;
+    }
+    return worst + wheel->settle_ms;
+}
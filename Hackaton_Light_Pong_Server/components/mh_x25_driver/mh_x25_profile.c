@@ -0,0 +1,100 @@
+/**
+ * @file mh_x25_profile.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief MH-X25 12-channel personality for the fixture layer
+ *
+ * Built from the MH_X25_* definitions so the driver and the profile cannot
+ * drift apart. Ranges follow the datasheet.
+ */
+
+#include "mh_x25_driver.h"
+
+#define MH_X25_CH(offset) ((offset) + 1) // Driver channel offset to profile channel number
+
+static const fixture_range_t mh_x25_color_ranges[] = {
+    {"white", 0, 4, MH_X25_COLOR_WHITE},
+    {"yellow", 5, 9, MH_X25_COLOR_YELLOW},
+    {"pink", 10, 14, MH_X25_COLOR_PINK},
+    {"green", 15, 19, MH_X25_COLOR_GREEN},
+    {"peachblow", 20, 24, MH_X25_COLOR_PEACHBLOW},
+    {"light_blue", 25, 29, MH_X25_COLOR_LIGHT_BLUE},
+    {"yellow_green", 30, 34, MH_X25_COLOR_YELLOW_GREEN},
+    {"red", 35, 39, MH_X25_COLOR_RED},
+    {"dark_blue", 40, 44, MH_X25_COLOR_DARK_BLUE},
+    {"rainbow_cw", 128, 191, MH_X25_COLOR_RAINBOW_CW},
+    {"rainbow_ccw", 192, 255, MH_X25_COLOR_RAINBOW_CCW},
+};
+
+static const fixture_range_t mh_x25_shutter_ranges[] = {
+    {"blackout", 0, 3, MH_X25_SHUTTER_BLACKOUT},
+    {"open", 4, 7, MH_X25_SHUTTER_OPEN},
+    {"strobe_slow", 8, 215, MH_X25_SHUTTER_STROBE_SLOW},
+    {"strobe_medium", 8, 215, MH_X25_SHUTTER_STROBE_MED},
+    {"strobe_fast", 8, 215, MH_X25_SHUTTER_STROBE_FAST},
+};
+
+static const fixture_range_t mh_x25_gobo_ranges[] = {
+    {"open", 0, 7, MH_X25_GOBO_OPEN},
+    {"gobo_2", 8, 15, MH_X25_GOBO_2},
+    {"gobo_3", 16, 23, MH_X25_GOBO_3},
+    {"gobo_4", 24, 31, MH_X25_GOBO_4},
+    {"gobo_5", 32, 39, MH_X25_GOBO_5},
+    {"gobo_6", 40, 47, MH_X25_GOBO_6},
+    {"gobo_7", 48, 55, MH_X25_GOBO_7},
+    {"gobo_8", 56, 63, MH_X25_GOBO_8},
+    {"gobo_8_shake", 64, 71, MH_X25_GOBO_8_SHAKE},
+    {"gobo_7_shake", 72, 79, MH_X25_GOBO_7_SHAKE},
+    {"rainbow_cw", 128, 191, MH_X25_GOBO_RAINBOW_CW},
+    {"rainbow_ccw", 192, 255, MH_X25_GOBO_RAINBOW_CCW},
+};
+
+static const fixture_range_t mh_x25_gobo_rot_ranges[] = {
+    {"stop", 0, 63, MH_X25_GOBO_ROT_STOP},
+    {"cw_slow", 64, 147, MH_X25_GOBO_ROT_CW_SLOW},
+    {"cw_fast", 64, 147, MH_X25_GOBO_ROT_CW_FAST},
+    {"ccw_slow", 148, 231, MH_X25_GOBO_ROT_CCW_SLOW},
+    {"ccw_fast", 148, 231, MH_X25_GOBO_ROT_CCW_FAST},
+};
+
+static const fixture_range_t mh_x25_special_ranges[] = {
+    {"none", 0, 7, MH_X25_SPECIAL_NONE},
+    {"blackout_pan_tilt", 8, 15, MH_X25_SPECIAL_BLACKOUT_PAN_TILT},
+    {"no_blackout_pan_tilt", 16, 23, MH_X25_SPECIAL_NO_BLACKOUT_PAN_TILT},
+    {"blackout_color", 24, 31, MH_X25_SPECIAL_BLACKOUT_COLOR},
+    {"no_blackout_color", 32, 39, MH_X25_SPECIAL_NO_BLACKOUT_COLOR},
+    {"blackout_gobo", 40, 47, MH_X25_SPECIAL_BLACKOUT_GOBO},
+    {"no_blackout_gobo", 48, 55, MH_X25_SPECIAL_NO_BLACKOUT_GOBO},
+    {"blackout_all_movement", 88, 95, MH_X25_SPECIAL_BLACKOUT_ALL_MOVEMENT},
+    {"reset_pan_tilt", 96, 103, MH_X25_SPECIAL_RESET_PAN_TILT},
+    {"reset_color", 112, 119, MH_X25_SPECIAL_RESET_COLOR},
+    {"reset_gobo", 120, 127, MH_X25_SPECIAL_RESET_GOBO},
+    {"reset_gobo_rot", 128, 135, MH_X25_SPECIAL_RESET_GOBO_ROT},
+    {"reset_all", 152, 159, MH_X25_SPECIAL_RESET_ALL},
+};
+
+static const fixture_range_t mh_x25_speed_ranges[] = {
+    {"fast", 0, 0, MH_X25_SPEED_FAST},
+    {"slow", 255, 255, MH_X25_SPEED_SLOW},
+};
+
+#define MH_X25_RANGES(table) .ranges = (table), .range_count = sizeof(table) / sizeof((table)[0])
+
+const fixture_profile_t mh_x25_profile = {
+    .name = "MH-X25 12ch",
+    .channel_count = MH_X25_NUM_CHANNELS,
+    .attrs = {
+        [FIXTURE_ATTR_PAN] = {.channel = MH_X25_CH(MH_X25_CHANNEL_PAN),
+                              .fine_channel = MH_X25_CH(MH_X25_CHANNEL_PAN_FINE)},
+        [FIXTURE_ATTR_TILT] = {.channel = MH_X25_CH(MH_X25_CHANNEL_TILT),
+                               .fine_channel = MH_X25_CH(MH_X25_CHANNEL_TILT_FINE)},
+        [FIXTURE_ATTR_SPEED] = {.channel = MH_X25_CH(MH_X25_CHANNEL_SPEED), MH_X25_RANGES(mh_x25_speed_ranges)},
+        [FIXTURE_ATTR_COLOR] = {.channel = MH_X25_CH(MH_X25_CHANNEL_COLOR), MH_X25_RANGES(mh_x25_color_ranges)},
+        [FIXTURE_ATTR_SHUTTER] = {.channel = MH_X25_CH(MH_X25_CHANNEL_SHUTTER), MH_X25_RANGES(mh_x25_shutter_ranges)},
+        [FIXTURE_ATTR_DIMMER] = {.channel = MH_X25_CH(MH_X25_CHANNEL_DIMMER)},
+        [FIXTURE_ATTR_GOBO] = {.channel = MH_X25_CH(MH_X25_CHANNEL_GOBO), MH_X25_RANGES(mh_x25_gobo_ranges)},
+        [FIXTURE_ATTR_GOBO_ROT] = {.channel = MH_X25_CH(MH_X25_CHANNEL_GOBO_ROT), MH_X25_RANGES(mh_x25_gobo_rot_ranges)},
+        [FIXTURE_ATTR_SPECIAL] = {.channel = MH_X25_CH(MH_X25_CHANNEL_SPECIAL), MH_X25_RANGES(mh_x25_special_ranges)},
+        [FIXTURE_ATTR_PROGRAM] = {.channel = MH_X25_CH(MH_X25_CHANNEL_PROGRAM)},
+    },
+};
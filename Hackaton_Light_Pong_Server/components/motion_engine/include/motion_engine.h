@@ -0,0 +1,202 @@
+/**
+ * @file motion_engine.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Pan/tilt trajectory generator driven by the DMX frame clock
+ *
+ * Instead of jumping the head to a target and leaving the path to the
+ * fixture's own speed curve, the engine writes an interpolated 16-bit
+ * pan/tilt position into every DMX frame. Flight time and path shape are
+ * therefore set by the game: the target goes out in the first frame due at
+ * or after the end of the move's duration, whatever the fixture's speed
+ * channel would have done.
+ *
+ * The engine runs from the DMX transmission task (dmx_add_frame_callback()),
+ * not from a polling task of its own. While it is attached it owns the
+ * fixture's pan and tilt channels; other code must not write them and
+ * should keep the fixture's pan/tilt speed at MH_X25_SPEED_FAST so the head
+ * follows the per-frame steps.
+ */
+
+#ifndef MOTION_ENGINE_H
+#define MOTION_ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "dmx_driver.h"
+#include "mh_x25_driver.h"
+#include "motion_math.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Motion engine configuration
+     */
+    typedef struct
+    {
+        dmx_handle_t dmx_handle;    ///< Universe whose frames clock the engine
+        mh_x25_handle_t fixture;    ///< Fixture on that universe to move
+    } motion_config_t;
+
+    /**
+     * @brief Motion engine handle
+     */
+    typedef void *motion_handle_t;
+
+    /**
+     * @brief Caller-provided storage for motion_init_static()
+     *
+     * Must outlive the handle. The contents are private to the engine.
+     */
+    typedef struct
+    {
+        uint64_t reserved[10];
+    } motion_static_t;
+
+    /**
+     * @brief Create a motion engine and attach it to the universe's frame clock
+     *
+     * The fixture's current pan/tilt is taken as the starting position.
+     *
+     * @param config Pointer to configuration structure
+     * @param out_handle Pointer to store the engine handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NO_MEM: Out of memory
+     */
+    esp_err_t motion_init(const motion_config_t *config, motion_handle_t *out_handle);
+
+    /**
+     * @brief Create a motion engine in caller-provided storage
+     *
+     * Same as motion_init() without allocating the engine context.
+     *
+     * @param config Pointer to configuration structure
+     * @param storage Storage for the engine, must outlive the handle
+     * @param out_handle Pointer to store the engine handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t motion_init_static(const motion_config_t *config, motion_static_t *storage,
+                                 motion_handle_t *out_handle);
+
+    /**
+     * @brief Detach the engine from the frame clock and release it
+     *
+     * The head stays where the last frame put it.
+     *
+     * @param handle Engine handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t motion_deinit(motion_handle_t handle);
+
+    /**
+     * @brief Move to a position in a fixed time
+     *
+     * The move starts from wherever the current trajectory is now, so a new
+     * target can be given mid-flight without a jump. A duration of 0 puts
+     * the target into the next frame.
+     *
+     * The predicted arrival is the commanded arrival plus the fixture's
+     * response time, or later if the head cannot travel that far in time at
+     * its current speed setting (see mh_x25_travel_time_ms()).
+     *
+     * @param handle Engine handle
+     * @param pan Target pan (0-65535)
+     * @param tilt Target tilt (0-65535)
+     * @param duration_ms Flight time
+     * @param profile Velocity profile
+     * @param arrival_us Pointer to store the esp_timer time the beam is expected at the target, may be NULL
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t motion_move_to(motion_handle_t handle, uint16_t pan, uint16_t tilt,
+                             uint32_t duration_ms, motion_profile_t profile, int64_t *arrival_us);
+
+    /**
+     * @brief Move to a position along a curve in a fixed time
+     *
+     * Like motion_move_to(), but the path is a quadratic Bezier from the
+     * current trajectory to the target that passes through the via point
+     * halfway along the curve (which, with an eased profile, is not halfway
+     * in time). Positions the curve would take outside the axis range are
+     * clamped to it.
+     *
+     * @param handle Engine handle
+     * @param pan Target pan (0-65535)
+     * @param tilt Target tilt (0-65535)
+     * @param via_pan Pan the path crosses at mid-curve
+     * @param via_tilt Tilt the path crosses at mid-curve
+     * @param duration_ms Flight time
+     * @param profile Velocity profile along the curve
+     * @param arrival_us Pointer to store the esp_timer time the beam is expected at the target, may be NULL
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t motion_curve_to(motion_handle_t handle, uint16_t pan, uint16_t tilt, uint16_t via_pan, uint16_t via_tilt,
+                              uint32_t duration_ms, motion_profile_t profile, int64_t *arrival_us);
+
+    /**
+     * @brief Move to a position at a given speed
+     *
+     * The flight time is derived from the longer of the pan and tilt
+     * distances; with an eased profile the speed is the average speed.
+     *
+     * @param handle Engine handle
+     * @param pan Target pan (0-65535)
+     * @param tilt Target tilt (0-65535)
+     * @param speed Position units (1/65536 of the axis range) per second, must not be 0
+     * @param profile Velocity profile
+     * @param arrival_us Pointer to store the esp_timer time the beam is expected at the target, may be NULL
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t motion_move_at_speed(motion_handle_t handle, uint16_t pan, uint16_t tilt,
+                                   uint32_t speed, motion_profile_t profile, int64_t *arrival_us);
+
+    /**
+     * @brief Stop where the most recent frame put the head
+     *
+     * @param handle Engine handle
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid handle
+     */
+    esp_err_t motion_stop(motion_handle_t handle);
+
+    /**
+     * @brief Check whether a move is still in progress
+     *
+     * @param handle Engine handle
+     * @return true until the frame carrying the target has been written
+     */
+    bool motion_is_moving(motion_handle_t handle);
+
+    /**
+     * @brief Get the position written into the most recent frame
+     *
+     * @param handle Engine handle
+     * @param pan Pointer to store pan
+     * @param tilt Pointer to store tilt
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     */
+    esp_err_t motion_get_position(motion_handle_t handle, uint16_t *pan, uint16_t *tilt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOTION_ENGINE_H
@@ -0,0 +1,72 @@
+/**
+ * @file motion_math.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Q16 trajectory maths of the motion engine
+ *
+ * Progress along a move is a Q16 fraction, 0 at the start and MOTION_ONE
+ * at the target. Integer only and free of ESP-IDF dependencies, so the
+ * same code is checked on a host (tools/host_tests).
+ */
+
+#ifndef MOTION_MATH_H
+#define MOTION_MATH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MOTION_ONE (1 << 16) // 1.0 in the Q16 progress fraction
+
+    /**
+     * @brief Velocity profile of a move
+     */
+    typedef enum
+    {
+        MOTION_PROFILE_LINEAR = 0,  ///< Constant velocity from start to target
+        MOTION_PROFILE_EASE_IN,     ///< Accelerate from rest, arrive at full speed
+        MOTION_PROFILE_EASE_OUT,    ///< Leave at full speed, decelerate into the target
+        MOTION_PROFILE_EASE_IN_OUT, ///< Accelerate, then decelerate (smoothstep)
+    } motion_profile_t;
+
+    /**
+     * @brief Linear progress of a move
+     *
+     * @param elapsed_us Time since the move started, may be negative
+     * @param duration_us Flight time of the move
+     * @return Progress in [0, MOTION_ONE], MOTION_ONE from the end of the move on
+     */
+    uint32_t motion_progress(int64_t elapsed_us, uint32_t duration_us);
+
+    /**
+     * @brief Map linear progress to eased progress, both in [0, MOTION_ONE]
+     */
+    uint32_t motion_ease(motion_profile_t profile, uint32_t t);
+
+    /**
+     * @brief Point on the straight line from -> to at a progress fraction
+     */
+    uint16_t motion_lerp(uint16_t from, uint16_t to, uint32_t fraction);
+
+    /**
+     * @brief Bezier control point that puts the curve through via halfway
+     *
+     * May lie outside the axis range.
+     */
+    int32_t motion_curve_ctrl(uint16_t from, uint16_t via, uint16_t to);
+
+    /**
+     * @brief Point on the quadratic Bezier from -> ctrl -> to at a progress fraction
+     *
+     * Positions outside the axis range are clamped to it.
+     */
+    uint16_t motion_bezier(uint16_t from, int32_t ctrl, uint16_t to, uint32_t fraction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOTION_MATH_H
@@ -0,0 +1,401 @@
+/**
+ * @file motion_engine.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Pan/tilt trajectory generator implementation
+ */
+
+#include "motion_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "MOTION";
+
+#define MOTION_DETACH_WAIT_TICKS 5 // Upper bound for the TX task to leave the callback
+
+/**
+ * @brief Motion engine context
+ */
+typedef struct
+{
+    dmx_handle_t dmx_handle;   // Universe clocking the engine
+    mh_x25_handle_t fixture;   // Fixture being moved
+    portMUX_TYPE lock;         // Guards everything below, shared with the TX task
+    uint16_t from_pan;         // Start of the current move
+    uint16_t from_tilt;
+    uint16_t to_pan;           // Target of the current move
+    uint16_t to_tilt;
+    int32_t ctrl_pan;          // Bezier control point of a curved move, may lie off the axis range
+    int32_t ctrl_tilt;
+    bool curved;               // Current move follows the control point
+    int64_t start_us;          // When the current move started
+    uint32_t duration_us;      // Flight time of the current move
+    motion_profile_t profile;  // Velocity profile of the current move
+    uint32_t move_id;          // Bumped on every new move or stop
+    bool moving;               // Frames still need positions from the move
+    uint16_t pan;              // Position written into the most recent frame
+    uint16_t tilt;
+    bool is_static;            // Lives in motion_static_t storage
+} motion_context_t;
+
+_Static_assert(sizeof(motion_context_t) <= sizeof(motion_static_t),
+               "motion_static_t too small for the engine context");
+
+/**
+ * @brief Evaluate the current move at a point in time (lock held)
+ *
+ * @return true if the target is reached at time_us
+ */
+static bool motion_position_at(const motion_context_t *ctx, int64_t time_us, uint16_t *pan, uint16_t *tilt)
+{
+    int64_t elapsed = time_us - ctx->start_us;
+
+    if (elapsed >= (int64_t)ctx->duration_us)
+    {
+        *pan = ctx->to_pan;
+        *tilt = ctx->to_tilt;
+        return true;
+    }
+
+    uint32_t fraction = motion_ease(ctx->profile, motion_progress(elapsed, ctx->duration_us));
+
+    if (ctx->curved)
+    {
+        *pan = motion_bezier(ctx->from_pan, ctx->ctrl_pan, ctx->to_pan, fraction);
+        *tilt = motion_bezier(ctx->from_tilt, ctx->ctrl_tilt, ctx->to_tilt, fraction);
+        return false;
+    }
+
+    *pan = motion_lerp(ctx->from_pan, ctx->to_pan, fraction);
+    *tilt = motion_lerp(ctx->from_tilt, ctx->to_tilt, fraction);
+    return false;
+}
+
+/**
+ * @brief Write the position for the upcoming frame (DMX TX task)
+ */
+static void motion_frame_cb(dmx_handle_t dmx_handle, int64_t next_frame_us, void *arg)
+{
+    motion_context_t *ctx = (motion_context_t *)arg;
+
+    portENTER_CRITICAL(&ctx->lock);
+    if (!ctx->moving)
+    {
+        portEXIT_CRITICAL(&ctx->lock);
+        return;
+    }
+    mh_x25_state_t state;
+    bool arrived = motion_position_at(ctx, next_frame_us, &state.pan, &state.tilt);
+    uint32_t move_id = ctx->move_id;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    if (mh_x25_apply(ctx->fixture, &state, MH_X25_APPLY_POSITION) != ESP_OK)
+    {
+        return;
+    }
+
+    // A move given meanwhile starts from its own evaluation, don't finish it here
+    portENTER_CRITICAL(&ctx->lock);
+    if (ctx->move_id == move_id)
+    {
+        ctx->pan = state.pan;
+        ctx->tilt = state.tilt;
+        if (arrived)
+        {
+            ctx->moving = false;
+        }
+    }
+    portEXIT_CRITICAL(&ctx->lock);
+}
+
+/**
+ * @brief Check a configuration before any storage is touched
+ */
+static esp_err_t motion_check_config(const motion_config_t *config, const void *out_handle)
+{
+    if (config == NULL || out_handle == NULL || config->dmx_handle == NULL || config->fixture == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Initialize a zeroed context and attach it to the frame clock
+ */
+static esp_err_t motion_setup(motion_context_t *ctx, const motion_config_t *config)
+{
+    ctx->dmx_handle = config->dmx_handle;
+    ctx->fixture = config->fixture;
+    portMUX_INITIALIZE(&ctx->lock);
+
+    mh_x25_state_t state;
+    esp_err_t ret = mh_x25_get_state(ctx->fixture, &state);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    ctx->pan = state.pan;
+    ctx->tilt = state.tilt;
+
+    ret = dmx_add_frame_callback(ctx->dmx_handle, motion_frame_cb, ctx);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Motion engine attached at pan=%u tilt=%u", ctx->pan, ctx->tilt);
+    return ESP_OK;
+}
+
+esp_err_t motion_init(const motion_config_t *config, motion_handle_t *out_handle)
+{
+    esp_err_t ret = motion_check_config(config, out_handle);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    motion_context_t *ctx = (motion_context_t *)calloc(1, sizeof(motion_context_t));
+    if (ctx == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ret = motion_setup(ctx, config);
+    if (ret != ESP_OK)
+    {
+        free(ctx);
+        return ret;
+    }
+
+    *out_handle = (motion_handle_t)ctx;
+    return ESP_OK;
+}
+
+esp_err_t motion_init_static(const motion_config_t *config, motion_static_t *storage,
+                             motion_handle_t *out_handle)
+{
+    esp_err_t ret = motion_check_config(config, out_handle);
+    if (ret != ESP_OK || storage == NULL)
+    {
+        return (ret != ESP_OK) ? ret : ESP_ERR_INVALID_ARG;
+    }
+
+    motion_context_t *ctx = (motion_context_t *)storage;
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->is_static = true;
+
+    ret = motion_setup(ctx, config);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    *out_handle = (motion_handle_t)ctx;
+    return ESP_OK;
+}
+
+esp_err_t motion_deinit(motion_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    motion_context_t *ctx = (motion_context_t *)handle;
+
+    dmx_frame_info_t before;
+    dmx_get_last_frame(ctx->dmx_handle, &before);
+    dmx_remove_frame_callback(ctx->dmx_handle, motion_frame_cb, ctx);
+
+    // The TX task may be inside the callback right now; it has left it once
+    // the next frame went out. Without transmission the wait just times out.
+    for (int i = 0; i < MOTION_DETACH_WAIT_TICKS; i++)
+    {
+        dmx_frame_info_t now;
+        dmx_get_last_frame(ctx->dmx_handle, &now);
+        if (now.sequence != before.sequence)
+        {
+            break;
+        }
+        vTaskDelay(1);
+    }
+
+    if (!ctx->is_static)
+    {
+        free(ctx);
+    }
+    ESP_LOGI(TAG, "Motion engine detached");
+
+    return ESP_OK;
+}
+
+static uint32_t motion_distance(int32_t from, int32_t to)
+{
+    return (to > from) ? (uint32_t)(to - from) : (uint32_t)(from - to);
+}
+
+static uint16_t motion_clamp_distance(uint32_t distance)
+{
+    return (distance > UINT16_MAX) ? UINT16_MAX : (uint16_t)distance;
+}
+
+/**
+ * @brief Start a straight (via == NULL) or curved move from the current trajectory
+ */
+static esp_err_t motion_start(motion_context_t *ctx, uint16_t pan, uint16_t tilt, const uint16_t via[2],
+                              uint32_t duration_ms, motion_profile_t profile, int64_t *arrival_us)
+{
+    mh_x25_state_t fixture;
+    esp_err_t ret = mh_x25_get_state(ctx->fixture, &fixture);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&ctx->lock);
+    uint16_t from_pan = ctx->pan;
+    uint16_t from_tilt = ctx->tilt;
+    if (ctx->moving)
+    {
+        motion_position_at(ctx, now, &from_pan, &from_tilt);
+    }
+    ctx->from_pan = from_pan;
+    ctx->from_tilt = from_tilt;
+    ctx->to_pan = pan;
+    ctx->to_tilt = tilt;
+    ctx->curved = (via != NULL);
+    if (ctx->curved)
+    {
+        ctx->ctrl_pan = motion_curve_ctrl(from_pan, via[0], pan);
+        ctx->ctrl_tilt = motion_curve_ctrl(from_tilt, via[1], tilt);
+    }
+    ctx->start_us = now;
+    ctx->duration_us = duration_ms * 1000;
+    ctx->profile = profile;
+    ctx->move_id++;
+    ctx->moving = true;
+    int32_t ctrl_pan = ctx->curved ? ctx->ctrl_pan : from_pan;
+    int32_t ctrl_tilt = ctx->curved ? ctx->ctrl_tilt : from_tilt;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    if (arrival_us != NULL)
+    {
+        // The beam trails the commanded path by the fixture's response time,
+        // and cannot beat the head's own travel time at its speed setting.
+        // A curve is no longer than the legs to and from its control point.
+        uint32_t pan_distance = motion_distance(from_pan, ctrl_pan) + motion_distance(ctrl_pan, pan);
+        uint32_t tilt_distance = motion_distance(from_tilt, ctrl_tilt) + motion_distance(ctrl_tilt, tilt);
+        uint32_t follow_ms = duration_ms + mh_x25_travel_time_ms(0, 0, fixture.speed);
+        uint32_t travel_ms = mh_x25_travel_time_ms(motion_clamp_distance(pan_distance),
+                                                   motion_clamp_distance(tilt_distance), fixture.speed);
+
+        *arrival_us = now + (int64_t)((follow_ms > travel_ms) ? follow_ms : travel_ms) * 1000;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t motion_move_to(motion_handle_t handle, uint16_t pan, uint16_t tilt,
+                         uint32_t duration_ms, motion_profile_t profile, int64_t *arrival_us)
+{
+    if (handle == NULL || profile > MOTION_PROFILE_EASE_IN_OUT)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return motion_start((motion_context_t *)handle, pan, tilt, NULL, duration_ms, profile, arrival_us);
+}
+
+esp_err_t motion_curve_to(motion_handle_t handle, uint16_t pan, uint16_t tilt, uint16_t via_pan, uint16_t via_tilt,
+                          uint32_t duration_ms, motion_profile_t profile, int64_t *arrival_us)
+{
+    if (handle == NULL || profile > MOTION_PROFILE_EASE_IN_OUT)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint16_t via[2] = {via_pan, via_tilt};
+    return motion_start((motion_context_t *)handle, pan, tilt, via, duration_ms, profile, arrival_us);
+}
+
+esp_err_t motion_move_at_speed(motion_handle_t handle, uint16_t pan, uint16_t tilt,
+                               uint32_t speed, motion_profile_t profile, int64_t *arrival_us)
+{
+    if (handle == NULL || speed == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t from_pan;
+    uint16_t from_tilt;
+    motion_get_position(handle, &from_pan, &from_tilt);
+
+    uint32_t pan_distance = (pan > from_pan) ? pan - from_pan : from_pan - pan;
+    uint32_t tilt_distance = (tilt > from_tilt) ? tilt - from_tilt : from_tilt - tilt;
+    uint32_t distance = (pan_distance > tilt_distance) ? pan_distance : tilt_distance;
+
+    uint32_t duration_ms = (uint32_t)(((uint64_t)distance * 1000 + speed - 1) / speed);
+
+    return motion_move_to(handle, pan, tilt, duration_ms, profile, arrival_us);
+}
+
+esp_err_t motion_stop(motion_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    motion_context_t *ctx = (motion_context_t *)handle;
+
+    portENTER_CRITICAL(&ctx->lock);
+    ctx->moving = false;
+    ctx->move_id++;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    return ESP_OK;
+}
+
+bool motion_is_moving(motion_handle_t handle)
+{
+    if (handle == NULL)
+    {
+        return false;
+    }
+
+    motion_context_t *ctx = (motion_context_t *)handle;
+
+    portENTER_CRITICAL(&ctx->lock);
+    bool moving = ctx->moving;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    return moving;
+}
+
+esp_err_t motion_get_position(motion_handle_t handle, uint16_t *pan, uint16_t *tilt)
+{
+    if (handle == NULL || pan == NULL || tilt == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    motion_context_t *ctx = (motion_context_t *)handle;
+
+    portENTER_CRITICAL(&ctx->lock);
+    *pan = ctx->pan;
+    *tilt = ctx->tilt;
+    portEXIT_CRITICAL(&ctx->lock);
+
+    return ESP_OK;
+}
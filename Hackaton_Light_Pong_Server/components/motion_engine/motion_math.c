@@ -0,0 +1,72 @@
+/**
+ * @file motion_math.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Q16 trajectory maths of the motion engine
+ */
+
+#include "motion_math.h"
+
+uint32_t motion_progress(int64_t elapsed_us, uint32_t duration_us)
+{
+    if (elapsed_us >= (int64_t)duration_us)
+    {
+        return MOTION_ONE;
+    }
+    if (elapsed_us <= 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)elapsed_us << 16) / duration_us);
+}
+
+uint32_t motion_ease(motion_profile_t profile, uint32_t t)
+{
+    uint64_t x = t;
+
+    switch (profile)
+    {
+    case MOTION_PROFILE_EASE_IN:
+        return (uint32_t)((x * x) >> 16);
+    case MOTION_PROFILE_EASE_OUT:
+    {
+        uint64_t r = MOTION_ONE - x;
+        return MOTION_ONE - (uint32_t)((r * r) >> 16);
+    }
+    case MOTION_PROFILE_EASE_IN_OUT:
+        // 3t^2 - 2t^3
+        return (uint32_t)((x * x * (3 * (uint64_t)MOTION_ONE - 2 * x)) >> 32);
+    case MOTION_PROFILE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+uint16_t motion_lerp(uint16_t from, uint16_t to, uint32_t fraction)
+{
+    int32_t delta = (int32_t)to - (int32_t)from;
+    return (uint16_t)(from + (int32_t)(((int64_t)delta * fraction) / MOTION_ONE));
+}
+
+int32_t motion_curve_ctrl(uint16_t from, uint16_t via, uint16_t to)
+{
+    // B(1/2) = (from + 2 ctrl + to) / 4
+    return 2 * (int32_t)via - ((int32_t)from + to) / 2;
+}
+
+uint16_t motion_bezier(uint16_t from, int32_t ctrl, uint16_t to, uint32_t fraction)
+{
+    int64_t f = fraction;
+    int64_t u = MOTION_ONE - f;
+
+    // (1-f)^2 from + 2(1-f)f ctrl + f^2 to, weights Q32
+    int64_t sum = u * u * from + 2 * u * f * ctrl + f * f * to;
+    int64_t pos = (sum + ((int64_t)1 << 31)) >> 32;
+
+    // The curve bulges towards the control point and may leave the axis range
+    if (pos < 0)
+    {
+        return 0;
+    }
+    return (pos > UINT16_MAX) ? UINT16_MAX : (uint16_t)pos;
+}
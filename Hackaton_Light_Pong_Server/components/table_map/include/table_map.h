@@ -0,0 +1,115 @@
+/**
+ * @file table_map.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Table-plane to pan/tilt mapping
+ *
+ * Game positions are given in millimetres on the table and converted to
+ * 16-bit pan/tilt with a homography solved from four or more calibration
+ * points (table position and the pan/tilt that hits it). The solved
+ * mapping is kept as fixed-point coefficients, so converting a position
+ * costs a few integer multiplies and one division and is cheap enough to
+ * run every DMX frame. The coefficients are stored in NVS.
+ *
+ * A homography is exact for a flat table seen by an ideal pan/tilt mirror
+ * and a close fit for a moving head over the table; it absorbs mounting
+ * position, rotation and tilt of the head.
+ */
+
+#ifndef TABLE_MAP_H
+#define TABLE_MAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TABLE_MAP_MIN_POINTS 4
+#define TABLE_MAP_MAX_POINTS 16
+
+    /**
+     * @brief Calibration point: where the beam lands for a pan/tilt
+     */
+    typedef struct
+    {
+        int32_t x_mm;  ///< Table position across the table
+        int32_t y_mm;  ///< Table position along the table
+        uint16_t pan;  ///< Pan that hits the position (0-65535)
+        uint16_t tilt; ///< Tilt that hits the position (0-65535)
+    } table_map_point_t;
+
+    /**
+     * @brief Fixed-point homography
+     *
+     * pan = (pan[0]*x + pan[1]*y + pan[2]) / (den[0]*x + den[1]*y + den[2]),
+     * tilt likewise, with x/y in mm. Numerator coefficients are Q16,
+     * denominator coefficients Q30 (den[2] is 1.0).
+     */
+    typedef struct
+    {
+        int64_t pan[3];
+        int64_t tilt[3];
+        int64_t den[3];
+    } table_map_t;
+
+    /**
+     * @brief Solve the mapping from calibration points
+     *
+     * With more than four points the least-squares fit is used.
+     *
+     * @param points Calibration points
+     * @param count Number of points (TABLE_MAP_MIN_POINTS to TABLE_MAP_MAX_POINTS)
+     * @param map Pointer to store the mapping
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments, or degenerate points (three on a line)
+     */
+    esp_err_t table_map_solve(const table_map_point_t *points, size_t count, table_map_t *map);
+
+    /**
+     * @brief Convert a table position to pan/tilt
+     *
+     * Results outside 0-65535 are clamped.
+     *
+     * @param map Mapping
+     * @param x_mm Table position across the table
+     * @param y_mm Table position along the table
+     * @param pan Pointer to store pan
+     * @param tilt Pointer to store tilt
+     */
+    void table_map_to_aim(const table_map_t *map, int32_t x_mm, int32_t y_mm, uint16_t *pan, uint16_t *tilt);
+
+    /**
+     * @brief Load the stored mapping from NVS
+     *
+     * nvs_flash_init() must have been called.
+     *
+     * @param map Pointer to store the mapping
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - ESP_ERR_NOT_FOUND: No mapping stored, or stored by an incompatible version
+     *      - Others: NVS errors
+     */
+    esp_err_t table_map_load(table_map_t *map);
+
+    /**
+     * @brief Store a mapping in NVS
+     *
+     * @param map Mapping
+     * @return
+     *      - ESP_OK: Success
+     *      - ESP_ERR_INVALID_ARG: Invalid arguments
+     *      - Others: NVS errors
+     */
+    esp_err_t table_map_save(const table_map_t *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TABLE_MAP_H
@@ -0,0 +1,188 @@
+/**
+ * @file table_map.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Table-plane to pan/tilt mapping: solving and conversion, no NVS
+ */
+
+#include "table_map.h"
+#include <math.h>
+#include <string.h>
+#include "esp_log.h"
+
+static const char *TAG = "TABLE_MAP";
+
+#define TABLE_MAP_UNKNOWNS 8 // Homography with h8 fixed to 1
+#define TABLE_MAP_NUM_FRAC 16
+#define TABLE_MAP_DEN_FRAC 30
+
+/**
+ * @brief Solve a symmetric 8x8 system in place (Gaussian elimination, partial pivoting)
+ *
+ * @return false if the system is singular
+ */
+static bool table_map_gauss(double a[TABLE_MAP_UNKNOWNS][TABLE_MAP_UNKNOWNS + 1], double x[TABLE_MAP_UNKNOWNS])
+{
+    for (int col = 0; col < TABLE_MAP_UNKNOWNS; col++)
+    {
+        int pivot = col;
+        for (int row = col + 1; row < TABLE_MAP_UNKNOWNS; row++)
+        {
+            if (fabs(a[row][col]) > fabs(a[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+
+        if (fabs(a[pivot][col]) < 1e-12)
+        {
+            return false;
+        }
+
+        if (pivot != col)
+        {
+            for (int k = 0; k <= TABLE_MAP_UNKNOWNS; k++)
+            {
+                double tmp = a[col][k];
+                a[col][k] = a[pivot][k];
+                a[pivot][k] = tmp;
+            }
+        }
+
+        for (int row = col + 1; row < TABLE_MAP_UNKNOWNS; row++)
+        {
+            double f = a[row][col] / a[col][col];
+            for (int k = col; k <= TABLE_MAP_UNKNOWNS; k++)
+            {
+                a[row][k] -= f * a[col][k];
+            }
+        }
+    }
+
+    for (int row = TABLE_MAP_UNKNOWNS - 1; row >= 0; row--)
+    {
+        double sum = a[row][TABLE_MAP_UNKNOWNS];
+        for (int k = row + 1; k < TABLE_MAP_UNKNOWNS; k++)
+        {
+            sum -= a[row][k] * x[k];
+        }
+        x[row] = sum / a[row][row];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Accumulate one equation row into the normal equations
+ */
+static void table_map_accumulate(double n[TABLE_MAP_UNKNOWNS][TABLE_MAP_UNKNOWNS + 1],
+                                 const double row[TABLE_MAP_UNKNOWNS], double rhs)
+{
+    for (int i = 0; i < TABLE_MAP_UNKNOWNS; i++)
+    {
+        for (int j = 0; j < TABLE_MAP_UNKNOWNS; j++)
+        {
+            n[i][j] += row[i] * row[j];
+        }
+        n[i][TABLE_MAP_UNKNOWNS] += row[i] * rhs;
+    }
+}
+
+esp_err_t table_map_solve(const table_map_point_t *points, size_t count, table_map_t *map)
+{
+    if (points == NULL || map == NULL || count < TABLE_MAP_MIN_POINTS || count > TABLE_MAP_MAX_POINTS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Scale positions to about +-1 and pan/tilt to 0..1 so the normal
+    // equations stay well conditioned
+    double extent = 1.0;
+    for (size_t i = 0; i < count; i++)
+    {
+        extent = fmax(extent, fmax(fabs((double)points[i].x_mm), fabs((double)points[i].y_mm)));
+    }
+    double s = 1.0 / extent;
+
+    double n[TABLE_MAP_UNKNOWNS][TABLE_MAP_UNKNOWNS + 1] = {0};
+    for (size_t i = 0; i < count; i++)
+    {
+        double x = points[i].x_mm * s;
+        double y = points[i].y_mm * s;
+        double p = points[i].pan / 65536.0;
+        double t = points[i].tilt / 65536.0;
+
+        double pan_row[TABLE_MAP_UNKNOWNS] = {x, y, 1, 0, 0, 0, -p * x, -p * y};
+        double tilt_row[TABLE_MAP_UNKNOWNS] = {0, 0, 0, x, y, 1, -t * x, -t * y};
+        table_map_accumulate(n, pan_row, p);
+        table_map_accumulate(n, tilt_row, t);
+    }
+
+    double h[TABLE_MAP_UNKNOWNS];
+    if (!table_map_gauss(n, h))
+    {
+        ESP_LOGE(TAG, "Calibration points are degenerate");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The head must see every calibration point in front of it
+    for (size_t i = 0; i < count; i++)
+    {
+        if (h[6] * points[i].x_mm * s + h[7] * points[i].y_mm * s + 1.0 <= 0.0)
+        {
+            ESP_LOGE(TAG, "Calibration points are inconsistent");
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    // Undo the scaling and convert to fixed point
+    double num_scale = 65536.0 * (1 << TABLE_MAP_NUM_FRAC);
+    double den_scale = (double)(1 << TABLE_MAP_DEN_FRAC);
+
+    map->pan[0] = llround(h[0] * s * num_scale);
+    map->pan[1] = llround(h[1] * s * num_scale);
+    map->pan[2] = llround(h[2] * num_scale);
+    map->tilt[0] = llround(h[3] * s * num_scale);
+    map->tilt[1] = llround(h[4] * s * num_scale);
+    map->tilt[2] = llround(h[5] * num_scale);
+    map->den[0] = llround(h[6] * s * den_scale);
+    map->den[1] = llround(h[7] * s * den_scale);
+    map->den[2] = 1LL << TABLE_MAP_DEN_FRAC;
+
+    return ESP_OK;
+}
+
+static uint16_t table_map_axis(const int64_t num[3], int64_t den, int32_t x_mm, int32_t y_mm)
+{
+    int64_t value = num[0] * x_mm + num[1] * y_mm + num[2];
+
+    if (value < 0)
+    {
+        return 0;
+    }
+
+    // Q16 / Q30 * 2^14 = integer, rounded
+    value = (value * (1 << (TABLE_MAP_DEN_FRAC - TABLE_MAP_NUM_FRAC)) + den / 2) / den;
+
+    if (value > UINT16_MAX)
+    {
+        return UINT16_MAX;
+    }
+    return (uint16_t)value;
+}
+
+void table_map_to_aim(const table_map_t *map, int32_t x_mm, int32_t y_mm, uint16_t *pan, uint16_t *tilt)
+{
+    int64_t den = map->den[0] * x_mm + map->den[1] * y_mm + map->den[2];
+
+    // Behind the head's horizon; no sensible aim, keep to the axis start
+    if (den <= 0)
+    {
+        *pan = 0;
+        *tilt = 0;
+        return;
+    }
+
+    *pan = table_map_axis(map->pan, den, x_mm, y_mm);
+    *tilt = table_map_axis(map->tilt, den, x_mm, y_mm);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file table_map_nvs.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Table map storage in NVS
+ */
+
+#include "table_map.h"
+#include "nvs.h"
+#include "esp_log.h"
+
+static const char *TAG = "TABLE_MAP";
+
+#define TABLE_MAP_NVS_NAMESPACE "table_map"
+#define TABLE_MAP_NVS_KEY "homography"
+#define TABLE_MAP_NVS_VERSION 1 // Bump when table_map_t changes
+
+/**
+ * @brief NVS record
+ */
+typedef struct
+{
+    uint32_t version;
+    table_map_t map;
+} table_map_record_t;
+
+esp_err_t table_map_load(table_map_t *map)
+{
+    if (map == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(TABLE_MAP_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (ret == ESP_ERR_NVS_NOT_FOUND)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    table_map_record_t record;
+    size_t length = sizeof(record);
+    ret = nvs_get_blob(nvs, TABLE_MAP_NVS_KEY, &record, &length);
+    nvs_close(nvs);
+
+    if (ret == ESP_ERR_NVS_NOT_FOUND || (ret == ESP_OK && (length != sizeof(record) ||
+                                                          record.version != TABLE_MAP_NVS_VERSION)))
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    *map = record.map;
+    return ESP_OK;
+}
+
+esp_err_t table_map_save(const table_map_t *map)
+{
+    if (map == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(TABLE_MAP_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    table_map_record_t record = {
+        .version = TABLE_MAP_NVS_VERSION,
+        .map = *map};
+
+    ret = nvs_set_blob(nvs, TABLE_MAP_NVS_KEY, &record, sizeof(record));
+    if (ret == ESP_OK)
+    {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (ret == ESP_OK)
+    {
+        ESP_LOGI(TAG, "Table calibration stored");
+    }
+    return ret;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file table_calibration.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Interactive table calibration over the serial console
+ */
+
+#include "table_calibration.h"
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "calibration";
+
+#define CAL_LINE_MAX 64
+#define CAL_POLL_MS 20
+
+// Context variables
+static motion_handle_t motion_handle = NULL;
+static table_map_t *table_map = NULL;
+
+static table_map_point_t points[TABLE_MAP_MAX_POINTS];
+static size_t point_count = 0;
+static uint16_t aim_pan = 0x8000;
+static uint16_t aim_tilt = 0x8000;
+
+void table_calibration_set_context(motion_handle_t motion, table_map_t *map)
+{
+    motion_handle = motion;
+    table_map = map;
+}
+
+// Blocks until a non-empty line was typed; the console may be non-blocking
+static void read_line(char *line, size_t size)
+{
+    size_t length = 0;
+
+    while (1)
+    {
+        int c = fgetc(stdin);
+        if (c == EOF)
+        {
+            clearerr(stdin);
+            vTaskDelay(pdMS_TO_TICKS(CAL_POLL_MS));
+            continue;
+        }
+
+        if (c == '\r' || c == '\n')
+        {
+            if (length > 0)
+            {
+                line[length] = '\0';
+                return;
+            }
+            continue;
+        }
+
+        if (length < size - 1)
+        {
+            line[length++] = (char)c;
+        }
+    }
+}
+
+static void aim(int32_t pan, int32_t tilt)
+{
+    aim_pan = (pan < 0) ? 0 : (pan > UINT16_MAX) ? UINT16_MAX : pan;
+    aim_tilt = (tilt < 0) ? 0 : (tilt > UINT16_MAX) ? UINT16_MAX : tilt;
+    motion_move_to(motion_handle, aim_pan, aim_tilt, 0, MOTION_PROFILE_LINEAR, NULL);
+    ESP_LOGI(TAG, "Aim pan=%u tilt=%u", aim_pan, aim_tilt);
+}
+
+static void print_help(void)
+{
+    ESP_LOGI(TAG, "Commands:");
+    ESP_LOGI(TAG, "  j <dpan> <dtilt>  jog the beam (16-bit units, 256 = one coarse step)");
+    ESP_LOGI(TAG, "  a <pan> <tilt>    aim at an absolute pan/tilt");
+    ESP_LOGI(TAG, "  c <x_mm> <y_mm>   capture the current aim for a table position");
+    ESP_LOGI(TAG, "  list              show captured points");
+    ESP_LOGI(TAG, "  clear             drop captured points");
+    ESP_LOGI(TAG, "  solve             fit the mapping and make it active");
+    ESP_LOGI(TAG, "  t <x_mm> <y_mm>   aim at a table position with the active mapping");
+    ESP_LOGI(TAG, "  save              store the active mapping in NVS");
+}
+
+static void solve(void)
+{
+    table_map_t solved;
+    esp_err_t ret = table_map_solve(points, point_count, &solved);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Solve failed with %u points: %s", (unsigned)point_count, esp_err_to_name(ret));
+        return;
+    }
+
+    *table_map = solved;
+
+    for (size_t i = 0; i < point_count; i++)
+    {
+        uint16_t pan;
+        uint16_t tilt;
+        table_map_to_aim(table_map, points[i].x_mm, points[i].y_mm, &pan, &tilt);
+        ESP_LOGI(TAG, "Point %u (%ld, %ld) mm: error pan=%d tilt=%d", (unsigned)i,
+                 (long)points[i].x_mm, (long)points[i].y_mm,
+                 (int)pan - points[i].pan, (int)tilt - points[i].tilt);
+    }
+    ESP_LOGI(TAG, "Mapping active; check with 't', then 'save'");
+}
+
+void table_calibration_task(void *pvParameters)
+{
+    char line[CAL_LINE_MAX];
+
+    ESP_LOGI(TAG, "Table calibration mode");
+    print_help();
+    aim(aim_pan, aim_tilt);
+
+    while (1)
+    {
+        read_line(line, sizeof(line));
+
+        long a = 0;
+        long b = 0;
+
+        if (sscanf(line, "j %ld %ld", &a, &b) == 2)
+        {
+            aim(aim_pan + a, aim_tilt + b);
+        }
+        else if (sscanf(line, "a %ld %ld", &a, &b) == 2)
+        {
+            aim(a, b);
+        }
+        else if (sscanf(line, "c %ld %ld", &a, &b) == 2)
+        {
+            if (point_count >= TABLE_MAP_MAX_POINTS)
+            {
+                ESP_LOGW(TAG, "Point list full");
+                continue;
+            }
+            points[point_count++] = (table_map_point_t){
+                .x_mm = a, .y_mm = b, .pan = aim_pan, .tilt = aim_tilt};
+            ESP_LOGI(TAG, "Point %u: (%ld, %ld) mm -> pan=%u tilt=%u",
+                     (unsigned)(point_count - 1), a, b, aim_pan, aim_tilt);
+        }
+        else if (sscanf(line, "t %ld %ld", &a, &b) == 2)
+        {
+            uint16_t pan;
+            uint16_t tilt;
+            table_map_to_aim(table_map, a, b, &pan, &tilt);
+            aim(pan, tilt);
+        }
+        else if (strcmp(line, "list") == 0)
+        {
+            for (size_t i = 0; i < point_count; i++)
+            {
+                ESP_LOGI(TAG, "Point %u: (%ld, %ld) mm -> pan=%u tilt=%u", (unsigned)i,
+                         (long)points[i].x_mm, (long)points[i].y_mm, points[i].pan, points[i].tilt);
+            }
+        }
+        else if (strcmp(line, "clear") == 0)
+        {
+            point_count = 0;
+            ESP_LOGI(TAG, "Points cleared");
+        }
+        else if (strcmp(line, "solve") == 0)
+        {
+            solve();
+        }
+        else if (strcmp(line, "save") == 0)
+        {
+            esp_err_t ret = table_map_save(table_map);
+            if (ret != ESP_OK)
+            {
+                ESP_LOGW(TAG, "Save failed: %s", esp_err_to_name(ret));
+            }
+        }
+        else
+        {
+            print_help();
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/**
+ * @file table_calibration.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Interactive table calibration over the serial console
+ */
+
+#ifndef TABLE_CALIBRATION_H
+#define TABLE_CALIBRATION_H
+
+#include "motion_engine.h"
+#include "table_map.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Calibration console task
+     *
+     * Reads commands from the console: jog the beam onto a table corner,
+     * capture it with its table position, repeat for four or more points,
+     * then solve, check and save. Type "help" for the command list.
+     *
+     * @param pvParameters Task parameters (unused)
+     */
+    void table_calibration_task(void *pvParameters);
+
+    /**
+     * @brief Set calibration context
+     *
+     * @param motion Motion engine aiming the head
+     * @param map Active table mapping, replaced by "solve"
+     */
+    void table_calibration_set_context(motion_handle_t motion, table_map_t *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TABLE_CALIBRATION_H
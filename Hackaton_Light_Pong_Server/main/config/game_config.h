@@ -8,9 +8,6 @@
 #ifndef GAME_CONFIG_H
 #define GAME_CONFIG_H
 
-#include "freertos/FreeRTOS.h"
-#include "espnow_handler.h" // For PADDLE_TOP_HIT and PADDLE_BOTTOM_HIT
-
 #ifdef __cplusplus
 extern "C"
 {
@@ -27,18 +24,50 @@ extern "C"
 // Win condition
 #define WIN_SCORE 9
 
-// Timeout configuration
-#define HIT_TIMEOUT_MS 2000
-#define CELEBRATION_BLINKS 10
-#define CELEBRATION_BLINK_ON_MS 250
-#define CELEBRATION_BLINK_OFF_MS 250
+// Hit window around the predicted ball arrival, in paddle swing time
+#define HIT_EARLY_MS 200           // Swing may come this much before the ball lands
+#define HIT_LATE_MS 2000           // ... or this much after
+#define HIT_DECISION_MARGIN_MS 100 // Wait for a late swing still on the air before calling a miss
+
+// Game state machine step; deadlines are checked at this rate, hits at once
+#define GAME_TICK_MS 10
 
-// Playing field boundaries
+// Playing field in table coordinates: x across the table, y from the top end
+#define TABLE_WIDTH_MM 1525
+#define TABLE_LENGTH_MM 2740
+#define TABLE_Y_TOP 0
+#define TABLE_Y_BOTTOM TABLE_LENGTH_MM
+
+// Coarse pan/tilt of the table corners, used until a calibration is stored
 #define PAN_MIN (128 - 20)     // Left corner
 #define PAN_MAX (128 + 20)     // Right corner
 #define TILT_TOP (128 + 60)    // Top border
 #define TILT_BOTTOM (128 - 60) // Bottom border
 
+// Build with 1 to run the table calibration console instead of the game
+#define TABLE_CALIBRATION_MODE 0
+
+// Ball flight (software trajectory, see motion_engine.h)
+#define BALL_FLIGHT_SLOW_MS 1300    // Weakest swing, hit to arrival
+#define BALL_FLIGHT_FAST_MS 700     // Strongest swing
+#define BALL_FLIGHT_FIREBALL_MS 600 // Fireball shot
+#define SERVE_MOVE_MS 800           // Repositioning for a serve
+
+// Ball model (see ball_model.h): swing strength beyond gravity sets the speed
+#define BALL_SWING_MIN_MG 1000 // Swing of the slowest ball, weaker ones fly as slow
+#define BALL_SWING_MAX_MG 3000 // Swing of the fastest ball
+
+// Gyro axes of the paddle's IMU (0 = x, 1 = y, 2 = z); negate a scale to flip a direction
+#define BALL_AIM_GYRO_AXIS 2         // Wrist turn that aims across the table
+#define BALL_AIM_MM_PER_100DPS 250   // Landing spot shift per 100 deg/s
+#define BALL_SPIN_GYRO_AXIS 0        // Wrist roll that bends the path
+#define BALL_CURVE_MM_PER_100DPS 150 // Mid-flight bend per 100 deg/s
+#define BALL_CURVE_MAX_MM 400
+
+// Match recorder (see match_recorder.h): records kept between two log flushes
+#define MATCH_RECORDER_RECORDS 512 // 32 bytes each
+#define MATCH_RECORDER_LOG 1       // Log new records once a second, for tools/match_replay
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,13 @@ extern "C"
 #define DMX_RX_PIN GPIO_NUM_20
 #define DMX_ENABLE_PIN GPIO_NUM_9
 
+/* Upstream DMX input (house console) on DMX_RX_PIN through a separate
+ * receive-only RS-485 transceiver. The game's patched channels always win,
+ * the rest of the universe is merged. Set to 0 without an input transceiver.
+ */
+#define DMX_INPUT_ENABLED 0
+#define DMX_INPUT_MERGE_MODE DMX_MERGE_HTP
+
 /* MH X25 DMX Configuration */
 #define MH_X25_START_CHANNEL 1 // DMX start address (channels 1-12)
 
@@ -0,0 +1,85 @@
+/**
+ * @file ball_model.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Shot from a paddle swing
+ */
+
+#include "ball_model.h"
+#include "game_config.h"
+
+#define BALL_GRAVITY_MG 1000
+
+static uint32_t isqrt32(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static int32_t clamp(int32_t value, int32_t low, int32_t high)
+{
+    return (value < low) ? low : (value > high) ? high : value;
+}
+
+// Acceleration beyond gravity; a paddle at rest gives 0
+static uint16_t swing_strength(const ball_swing_t *swing)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        int32_t a = swing->accel_mg[i];
+        sum += (uint32_t)(a * a); // 3 * 32768^2 still fits
+    }
+
+    int32_t strength = (int32_t)isqrt32(sum) - BALL_GRAVITY_MG;
+    return (uint16_t)clamp(strength, 0, UINT16_MAX);
+}
+
+// Harder swings fly faster, linear between the configured strengths
+static uint32_t flight_time(uint16_t strength_mg)
+{
+    int32_t span = BALL_SWING_MAX_MG - BALL_SWING_MIN_MG;
+    int32_t over = clamp((int32_t)strength_mg - BALL_SWING_MIN_MG, 0, span);
+    int32_t range = BALL_FLIGHT_SLOW_MS - BALL_FLIGHT_FAST_MS;
+
+    return (uint32_t)(BALL_FLIGHT_SLOW_MS - (range * over) / span);
+}
+
+void ball_model_shot(const ball_swing_t *swing, int32_t from_x_mm, int32_t from_y_mm, int32_t to_y_mm,
+                     bool fireball, ball_shot_t *shot)
+{
+    // The players face each other, so the same wrist turn points the other way across the table
+    int32_t facing = (to_y_mm > from_y_mm) ? 1 : -1;
+
+    shot->strength_mg = swing_strength(swing);
+    shot->flight_ms = fireball ? BALL_FLIGHT_FIREBALL_MS : flight_time(shot->strength_mg);
+
+    int32_t aim_mm = facing * swing->gyro_dps[BALL_AIM_GYRO_AXIS] * BALL_AIM_MM_PER_100DPS / 100;
+    shot->x_mm = clamp(from_x_mm + aim_mm, 0, TABLE_WIDTH_MM);
+    shot->y_mm = to_y_mm;
+
+    // The bend is measured at mid-flight from the straight line; keep it over the table
+    int32_t curve_mm = facing * swing->gyro_dps[BALL_SPIN_GYRO_AXIS] * BALL_CURVE_MM_PER_100DPS / 100;
+    curve_mm = clamp(curve_mm, -BALL_CURVE_MAX_MM, BALL_CURVE_MAX_MM);
+    shot->via_x_mm = clamp((from_x_mm + shot->x_mm) / 2 + curve_mm, 0, TABLE_WIDTH_MM);
+    shot->via_y_mm = (from_y_mm + to_y_mm) / 2;
+}
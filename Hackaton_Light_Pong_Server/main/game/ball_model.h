@@ -0,0 +1,66 @@
+/**
+ * @file ball_model.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Shot from a paddle swing: speed, direction and curve, in integer math
+ *
+ * The paddle reports the IMU sample that triggered the hit. How hard it was
+ * swung (acceleration beyond gravity) sets the flight time, the rotation
+ * rate on one gyro axis aims the shot across the table and the rate on
+ * another bends its path. Axes and scales are in game_config.h.
+ *
+ * No floating point and no ESP-IDF dependencies; a shot costs a 16-step
+ * integer square root and a few multiplies.
+ */
+
+#ifndef BALL_MODEL_H
+#define BALL_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief IMU sample of a swing
+     */
+    typedef struct
+    {
+        int16_t accel_mg[3]; // Acceleration in milli-g, gravity included
+        int16_t gyro_dps[3]; // Rotation rate in deg/s
+    } ball_swing_t;
+
+    /**
+     * @brief Shot to fly, in table coordinates
+     */
+    typedef struct
+    {
+        int32_t x_mm;         // Landing spot
+        int32_t y_mm;
+        int32_t via_x_mm;     // Point the ball passes halfway along its path
+        int32_t via_y_mm;
+        uint32_t flight_ms;   // Hit to landing
+        uint16_t strength_mg; // Swing acceleration beyond gravity
+    } ball_shot_t;
+
+    /**
+     * @brief Work out the shot a swing produces
+     *
+     * @param swing IMU sample of the swing
+     * @param from_x_mm Where the ball is hit, across the table
+     * @param from_y_mm Where the ball is hit, along the table
+     * @param to_y_mm End of the table the ball flies to
+     * @param fireball Fireball shot, flies in BALL_FLIGHT_FIREBALL_MS whatever the swing
+     * @param shot Pointer to store the shot, landing and via point on the table
+     */
+    void ball_model_shot(const ball_swing_t *swing, int32_t from_x_mm, int32_t from_y_mm, int32_t to_y_mm,
+                         bool fireball, ball_shot_t *shot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BALL_MODEL_H
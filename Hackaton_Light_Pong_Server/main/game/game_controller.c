@@ -3,228 +3,309 @@
  * @author Matthias Hefel
  * @date 2026
  * @brief Main game controller implementation for Light Pong
+ *
+ * Runs the game state machine (game_logic.h) on the target: feeds it paddle
+ * hits as they arrive and a tick every GAME_TICK_MS, and carries out its
+ * operations on the light, the motion engine and the ESP-NOW link.
+ * Everything the game sees and returns is recorded (match_recorder.h).
  */
 
 #include "game_controller.h"
 #include "game_types.h"
+#include "game_logic.h"
+#include "match_recorder.h"
 #include "../config/game_config.h"
 #include "light_effects.h"
 #include "espnow_handler.h"
 #include "esp_log.h"
 #include "esp_random.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <string.h>
 
 static const char *TAG = "game_controller";
 
 // Context variables
 static mh_x25_handle_t light_handle = NULL;
-static EventGroupHandle_t paddle_events = NULL;
-static volatile uint8_t *last_btn_left_pressed = NULL;
-static volatile uint8_t *last_btn_right_pressed = NULL;
+static motion_handle_t motion_handle = NULL;
+static light_effects_handle_t effects_handle = NULL;
+static light_mixer_layer_handle_t ball_layer = NULL;
+static const table_map_t *table_map = NULL;
+static QueueHandle_t paddle_hits = NULL;
 static volatile int *current_side = NULL;
 static game_score_t *game_score = NULL;
 
-// Configuration for each player/side
-typedef struct
-{
-    int side_id;
-    int opposite_side;
-    uint8_t opposite_tilt;
-    EventBits_t event_bit;
-    volatile uint8_t *button_state;
-    uint8_t player_number;
-    uint8_t celebration_color;
-} side_config_t;
+static game_logic_t game;
+static int64_t relight_at_us = 0; // Ball kept dark until its new look has settled, 0 when lit
 
 void game_controller_set_context(mh_x25_handle_t light,
-                                 EventGroupHandle_t events,
+                                 motion_handle_t motion,
+                                 light_effects_handle_t effects,
+                                 light_mixer_layer_handle_t ball,
+                                 const table_map_t *table,
+                                 QueueHandle_t hits,
                                  volatile int *side,
-                                 volatile uint8_t *btn_left,
-                                 volatile uint8_t *btn_right,
                                  void *score)
 {
     light_handle = light;
-    paddle_events = events;
+    motion_handle = motion;
+    effects_handle = effects;
+    ball_layer = ball;
+    table_map = table;
+    paddle_hits = hits;
     current_side = side;
-    last_btn_left_pressed = btn_left;
-    last_btn_right_pressed = btn_right;
     game_score = (game_score_t *)score;
 }
 
-static uint8_t get_random_pan(uint8_t pan_min, uint8_t pan_max)
+static void set_ball_look(mh_x25_state_t *state, bool fireball)
 {
-    return pan_min + (esp_random() % (pan_max - pan_min + 1));
+    if (fireball)
+    {
+        state->color = MH_X25_COLOR_RED;
+        state->gobo = MH_X25_GOBO_4;
+        state->gobo_rotation = 200;
+        return;
+    }
+
+    state->color = MH_X25_COLOR_WHITE;
+    state->gobo = MH_X25_GOBO_OPEN;
+    state->gobo_rotation = 0;
 }
 
-static void apply_ball_effect(uint8_t button_pressed)
+// Returns when the beam is expected to land
+static int64_t move_ball(int32_t x_mm, int32_t y_mm, uint32_t duration_ms, motion_profile_t profile)
 {
-    if (button_pressed == BUTTON_FIREBALL)
-    {
-        ESP_LOGI(TAG, "Fireball activated");
-        mh_x25_set_color(light_handle, MH_X25_COLOR_RED);
-        mh_x25_set_gobo(light_handle, MH_X25_GOBO_4);
-        mh_x25_set_gobo_rotation(light_handle, 200);
-    }
-    else
-    {
-        mh_x25_set_color(light_handle, MH_X25_COLOR_WHITE);
-        mh_x25_set_gobo(light_handle, MH_X25_GOBO_OPEN);
-        mh_x25_set_gobo_rotation(light_handle, 0);
-    }
+    uint16_t pan;
+    uint16_t tilt;
+    table_map_to_aim(table_map, x_mm, y_mm, &pan, &tilt);
+
+    int64_t arrival_us = esp_timer_get_time() + (int64_t)duration_ms * 1000;
+    motion_move_to(motion_handle, pan, tilt, duration_ms, profile, &arrival_us);
+    return arrival_us;
 }
 
-static void celebration_blink(uint8_t color)
+// Ball out of play: plain look, dark so the effect layer above controls the dimmer
+static void ball_out(void)
 {
-    mh_x25_set_color(light_handle, color);
-    mh_x25_set_gobo(light_handle, MH_X25_GOBO_OPEN);
-    mh_x25_set_gobo_rotation(light_handle, 0);
+    relight_at_us = 0;
+    mh_x25_state_t ball = {.dimmer = 0};
+    set_ball_look(&ball, false);
+    light_mixer_set(ball_layer, &ball, MH_X25_APPLY_LOOK | MH_X25_APPLY_DIMMER);
+}
 
-    for (int i = 0; i < CELEBRATION_BLINKS; i++)
-    {
-        mh_x25_set_dimmer(light_handle, MH_X25_DIMMER_FULL);
-        vTaskDelay(pdMS_TO_TICKS(CELEBRATION_BLINK_ON_MS));
-        mh_x25_set_dimmer(light_handle, 0);
-        vTaskDelay(pdMS_TO_TICKS(CELEBRATION_BLINK_OFF_MS));
-    }
-    mh_x25_set_dimmer(light_handle, MH_X25_DIMMER_FULL);
+// Effect done callback, lights the ball for the serve (may run in the DMX TX task)
+static void ball_relight(bool completed, void *arg)
+{
+    mh_x25_state_t ball = {.dimmer = MH_X25_DIMMER_FULL};
+    light_mixer_set(ball_layer, &ball, MH_X25_APPLY_DIMMER);
 }
 
-static bool handle_paddle_hit(const side_config_t *cfg, uint8_t pan_min, uint8_t pan_max, TickType_t timeout)
+static int64_t op_shoot(void *ctx, const ball_shot_t *shot, bool fireball)
 {
-    if (cfg == NULL)
+    if (fireball)
     {
-        ESP_LOGE(TAG, "Invalid config pointer");
-        return false;
+        ESP_LOGI(TAG, "Fireball activated");
     }
-
-    ESP_LOGI(TAG, "Waiting for Player %d paddle hit", cfg->player_number);
-
-    xEventGroupClearBits(paddle_events, cfg->event_bit);
-    EventBits_t bits = xEventGroupWaitBits(
-        paddle_events,
-        cfg->event_bit,
-        pdTRUE,
-        pdFALSE,
-        timeout);
-
-    if (bits & cfg->event_bit)
+    ESP_LOGI(TAG, "Shot to x=%ld mm via x=%ld mm in %lu ms (swing %u mg)", (long)shot->x_mm,
+             (long)shot->via_x_mm, (unsigned long)shot->flight_ms, shot->strength_mg);
+
+    // A serve cuts a celebration short. New look and the first step of the
+    // flight go out in the next frame. Wheels that have to move do so with
+    // the ball dark, the tick lights it once they have settled
+    light_effects_stop(effects_handle);
+    mh_x25_state_t ball = {0};
+    set_ball_look(&ball, fireball);
+    uint32_t settle_ms = 0;
+    mh_x25_plan_look(light_handle, &ball, MH_X25_APPLY_LOOK, &settle_ms);
+    ball.dimmer = (settle_ms > 0) ? 0 : MH_X25_DIMMER_FULL;
+    light_mixer_set(ball_layer, &ball, MH_X25_APPLY_LOOK | MH_X25_APPLY_DIMMER);
+    light_mixer_flush(light_mixer_get_mixer(ball_layer));
+    uint16_t pan;
+    uint16_t tilt;
+    uint16_t via_pan;
+    uint16_t via_tilt;
+    table_map_to_aim(table_map, shot->x_mm, shot->y_mm, &pan, &tilt);
+    table_map_to_aim(table_map, shot->via_x_mm, shot->via_y_mm, &via_pan, &via_tilt);
+
+    int64_t arrival_us = esp_timer_get_time() + (int64_t)shot->flight_ms * 1000;
+    motion_curve_to(motion_handle, pan, tilt, via_pan, via_tilt, shot->flight_ms, MOTION_PROFILE_LINEAR,
+                    &arrival_us);
+    mh_x25_request_frame(light_handle);
+
+    // The next hit counts once the ball has landed with its final look
+    int64_t look_ready_us;
+    mh_x25_get_look_ready(light_handle, &look_ready_us);
+    relight_at_us = (settle_ms > 0) ? look_ready_us : 0;
+    if (look_ready_us > arrival_us)
     {
-        ESP_LOGI(TAG, "Player %d hit detected", cfg->player_number);
-        apply_ball_effect(*cfg->button_state);
-
-        uint8_t pan_position = get_random_pan(pan_min, pan_max);
-        mh_x25_set_position_16bit(light_handle, pan_position << 8, cfg->opposite_tilt << 8);
-        *current_side = cfg->opposite_side;
-
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        return true;
+        ESP_LOGD(TAG, "Look settles %lld ms after landing", (long long)(look_ready_us - arrival_us) / 1000);
+        arrival_us = look_ready_us;
     }
 
-    return false;
+    match_recorder_shot(shot, fireball, arrival_us);
+    return arrival_us;
 }
 
-static bool handle_timeout(const side_config_t *cfg, uint8_t pan_min, uint8_t pan_max)
+static int64_t op_place(void *ctx, int32_t x_mm, int32_t y_mm)
 {
-    if (cfg == NULL)
-    {
-        ESP_LOGE(TAG, "Invalid config pointer");
-        return false;
-    }
-
-    if (cfg->player_number == 1)
-        game_score->score_2++;
-    else
-        game_score->score_1++;
+    ESP_LOGI(TAG, "Ball to serve position (x=%ld mm)", (long)x_mm);
+    int64_t arrival_us = move_ball(x_mm, y_mm, SERVE_MOVE_MS, MOTION_PROFILE_EASE_IN_OUT);
+    match_recorder_place(x_mm, y_mm, arrival_us);
+    return arrival_us;
+}
 
+// Effects play from the DMX frame clock; the serve is taken while they run
+static void op_point(void *ctx, uint8_t missed_player)
+{
     ESP_LOGI(TAG, "Timeout: Player %d missed - Score P1=%d P2=%d",
-             cfg->player_number, game_score->score_1, game_score->score_2);
+             missed_player, game.score.score_1, game.score.score_2);
 
+    ball_out();
+    const light_effect_t *celebration = (missed_player == 1) ? &light_effect_celebrate_blue
+                                                             : &light_effect_celebrate_green;
+    light_effects_play(effects_handle, celebration, ball_relight, NULL);
+}
+
+static void op_win(void *ctx, uint8_t winner)
+{
+    ESP_LOGI(TAG, "Player %d wins - starting victory animation", winner);
+    ball_out();
+    light_effects_play(effects_handle, light_effects_victory(winner), ball_relight, NULL);
+}
+
+static void op_score(void *ctx, const game_score_t *score)
+{
+    *game_score = *score;
     esp_err_t ret = espnow_broadcast_score(game_score, sizeof(game_score_t));
     if (ret != ESP_OK)
     {
         ESP_LOGW(TAG, "Failed to send score update: %s", esp_err_to_name(ret));
     }
+}
 
-    uint8_t winner = (game_score->score_1 >= WIN_SCORE) ? 1 : (game_score->score_2 >= WIN_SCORE) ? 2
-                                                                                                 : 0;
+static const game_ops_t game_ops = {
+    .shoot = op_shoot,
+    .place = op_place,
+    .point = op_point,
+    .win = op_win,
+    .score = op_score,
+};
 
-    if (winner > 0)
+static void handle_hit(const paddle_hit_t *paddle_hit)
+{
+    game_hit_t hit = {
+        .at_us = paddle_hit->rx_us,
+        .swing_us = paddle_hit->swing_us,
+        .player = paddle_hit->player,
+        .button = paddle_hit->button};
+    memcpy(hit.swing.accel_mg, paddle_hit->accel_mg, sizeof(hit.swing.accel_mg));
+    memcpy(hit.swing.gyro_dps, paddle_hit->gyro_dps, sizeof(hit.swing.gyro_dps));
+
+    // Judged against the arrival the player was waiting for, before the hit changes it
+    int64_t arrival_us = game.arrival_us;
+    bool return_shot = (game.state == GAME_STATE_IN_FLIGHT || game.state == GAME_STATE_HIT_WINDOW);
+    bool awaited = (hit.player == game.player);
+
+    int64_t now_us = esp_timer_get_time();
+    match_recorder_hit(&hit, now_us);
+    game_hit_result_t result = game_logic_hit(&game, &hit, now_us);
+    match_recorder_state(&game);
+
+    if (!awaited)
     {
-        play_winning_animation(winner, light_handle);
-        game_score->score_1 = 0;
-        game_score->score_2 = 0;
-        ret = espnow_broadcast_score(game_score, sizeof(game_score_t));
-        if (ret != ESP_OK)
-        {
-            ESP_LOGW(TAG, "Failed to send reset score: %s", esp_err_to_name(ret));
-        }
-
-        uint8_t pan_position = get_random_pan(pan_min, pan_max);
-        mh_x25_set_position_16bit(light_handle, pan_position << 8, TILT_TOP << 8);
-        *current_side = SIDE_TOP;
-        vTaskDelay(pdMS_TO_TICKS(2000));
-        return true;
+        ESP_LOGD(TAG, "Ignoring Player %d hit %lu (%s)", hit.player, (unsigned long)paddle_hit->seq,
+                 game_logic_hit_result_name(result));
+        return;
     }
 
-    celebration_blink(cfg->celebration_color);
-    mh_x25_set_color(light_handle, MH_X25_COLOR_WHITE);
-    vTaskDelay(pdMS_TO_TICKS(500));
-
-    handle_paddle_hit(cfg, pan_min, pan_max, portMAX_DELAY);
-    return false;
+    // Timing error of every swing at a ball, for tuning HIT_EARLY_MS/HIT_LATE_MS
+    if (return_shot)
+    {
+        ESP_LOGI(TAG, "Player %d swing %+ld ms from arrival (latency %ld us%s): %s",
+                 hit.player, (long)((hit.swing_us - arrival_us) / 1000), (long)paddle_hit->latency_us,
+                 (paddle_hit->latency_us > 0) ? "" : ", not synced", game_logic_hit_result_name(result));
+    }
+    else if (result == GAME_HIT_PLAYED)
+    {
+        ESP_LOGI(TAG, "Player %d serves (%lld us after receive)", hit.player, (long long)(now_us - hit.at_us));
+    }
+    else
+    {
+        ESP_LOGD(TAG, "Ignoring Player %d serve (%s)", hit.player, game_logic_hit_result_name(result));
+    }
 }
 
 void dmx_controller_task(void *pvParameters)
 {
-    const uint8_t pan_min = PAN_MIN;
-    const uint8_t pan_max = PAN_MAX;
-    const TickType_t timeout_ticks = pdMS_TO_TICKS(HIT_TIMEOUT_MS);
-
-    mh_x25_set_color(light_handle, MH_X25_COLOR_WHITE);
-    mh_x25_set_shutter(light_handle, MH_X25_SHUTTER_OPEN);
-    mh_x25_set_dimmer(light_handle, MH_X25_DIMMER_FULL);
-    mh_x25_set_gobo(light_handle, MH_X25_GOBO_OPEN);
-    mh_x25_set_gobo_rotation(light_handle, 0);
-    mh_x25_set_speed(light_handle, MH_X25_SPEED_FAST);
-    mh_x25_set_special(light_handle, MH_X25_SPECIAL_NO_BLACKOUT_PAN_TILT);
-
+    mh_x25_state_t initial = {
+        .color = MH_X25_COLOR_WHITE,
+        .shutter = MH_X25_SHUTTER_OPEN,
+        .dimmer = MH_X25_DIMMER_FULL,
+        .gobo = MH_X25_GOBO_OPEN,
+        .gobo_rotation = 0,
+        .speed = MH_X25_SPEED_FAST,
+        .special = MH_X25_SPECIAL_NO_BLACKOUT_PAN_TILT};
+    light_mixer_set(ball_layer, &initial,
+                    MH_X25_APPLY_LOOK | MH_X25_APPLY_SHUTTER | MH_X25_APPLY_DIMMER |
+                        MH_X25_APPLY_SPEED | MH_X25_APPLY_SPECIAL);
+
+    // Fixture warm-up, before the game starts
     vTaskDelay(pdMS_TO_TICKS(500));
 
-    *current_side = SIDE_TOP;
-    uint8_t pan_position = get_random_pan(pan_min, pan_max);
-    ESP_LOGI(TAG, "Game started: ball at TOP (pan=%d, tilt=%d)", pan_position, TILT_TOP);
-    mh_x25_set_position_16bit(light_handle, pan_position << 8, TILT_TOP << 8);
-    vTaskDelay(pdMS_TO_TICKS(1000));
-
-    side_config_t player1_config = {
-        .side_id = SIDE_TOP,
-        .opposite_side = SIDE_BOTTOM,
-        .opposite_tilt = TILT_BOTTOM,
-        .event_bit = PADDLE_TOP_HIT,
-        .button_state = last_btn_left_pressed,
-        .player_number = 1,
-        .celebration_color = MH_X25_COLOR_DARK_BLUE};
-
-    side_config_t player2_config = {
-        .side_id = SIDE_BOTTOM,
-        .opposite_side = SIDE_TOP,
-        .opposite_tilt = TILT_TOP,
-        .event_bit = PADDLE_BOTTOM_HIT,
-        .button_state = last_btn_right_pressed,
-        .player_number = 2,
-        .celebration_color = MH_X25_COLOR_GREEN};
+    uint32_t seed = esp_random();
+    game_logic_init(&game, &game_ops, NULL, seed);
+    game_logic_start(&game);
+    match_recorder_state(&game);
+    ESP_LOGI(TAG, "Game started: ball at TOP (seed %08lx)", (unsigned long)seed);
+
+    // Hits are applied as soon as they arrive, the tick runs between them
+    const TickType_t tick_period = (pdMS_TO_TICKS(GAME_TICK_MS) > 0) ? pdMS_TO_TICKS(GAME_TICK_MS) : 1;
+    TickType_t last_tick = xTaskGetTickCount();
+    game_state_t last_state = game.state;
 
     while (1)
     {
-        side_config_t *current_player = (*current_side == SIDE_TOP) ? &player1_config : &player2_config;
+        TickType_t since_tick = xTaskGetTickCount() - last_tick;
+        TickType_t wait = (since_tick < tick_period) ? tick_period - since_tick : 0;
+
+        paddle_hit_t paddle_hit;
+        if (xQueueReceive(paddle_hits, &paddle_hit, wait) == pdTRUE)
+        {
+            handle_hit(&paddle_hit);
+        }
 
-        if (!handle_paddle_hit(current_player, pan_min, pan_max, timeout_ticks))
+        // Also checked after a hit, so a stream of hits cannot hold off a deadline
+        if (xTaskGetTickCount() - last_tick >= tick_period)
         {
-            if (handle_timeout(current_player, pan_min, pan_max))
+            last_tick = xTaskGetTickCount();
+            int64_t now_us = esp_timer_get_time();
+
+            // Ticks that change nothing are left out of the record
+            bool due = (now_us >= game_logic_next_due_us(&game));
+            if (due)
             {
-                continue;
+                match_recorder_tick(now_us);
             }
+            game_logic_tick(&game, now_us);
+            if (due)
+            {
+                match_recorder_state(&game);
+            }
+
+            if (relight_at_us != 0 && now_us >= relight_at_us)
+            {
+                relight_at_us = 0;
+                ball_relight(true, NULL);
+            }
+        }
+
+        if (game.state != last_state)
+        {
+            ESP_LOGI(TAG, "%s -> %s, waiting for Player %d", game_logic_state_name(last_state),
+                     game_logic_state_name(game.state), game.player);
+            last_state = game.state;
         }
+        *current_side = (game.player == 1) ? SIDE_TOP : SIDE_BOTTOM;
     }
 }
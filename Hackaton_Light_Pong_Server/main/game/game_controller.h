@@ -11,8 +11,12 @@
 #include <stdint.h>
 #include "dmx_driver.h"
 #include "mh_x25_driver.h"
+#include "motion_engine.h"
+#include "light_effects.h"
+#include "light_mixer.h"
+#include "table_map.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/event_groups.h"
+#include "freertos/queue.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -30,17 +34,21 @@ extern "C"
      * @brief Set game controller context
      *
      * @param light MH X25 light handle
-     * @param events Event group for paddle hits
+     * @param motion Motion engine moving the light's pan/tilt
+     * @param effects Effect player for celebrations, on a mixer layer above ball
+     * @param ball Mixer layer holding the ball's look and dimmer
+     * @param table Table mapping from game positions to pan/tilt
+     * @param hits Queue of paddle_hit_t filled by the ESP-NOW handler
      * @param side Pointer to current side state
-     * @param btn_left Pointer to left button state
-     * @param btn_right Pointer to right button state
      * @param score Pointer to game score
      */
     void game_controller_set_context(mh_x25_handle_t light,
-                                     EventGroupHandle_t events,
+                                     motion_handle_t motion,
+                                     light_effects_handle_t effects,
+                                     light_mixer_layer_handle_t ball,
+                                     const table_map_t *table,
+                                     QueueHandle_t hits,
                                      volatile int *side,
-                                     volatile uint8_t *btn_left,
-                                     volatile uint8_t *btn_right,
                                      void *score);
 
 #ifdef __cplusplus
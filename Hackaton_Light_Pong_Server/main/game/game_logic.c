@@ -0,0 +1,235 @@
+/**
+ * @file game_logic.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Light Pong rules as a state machine
+ */
+
+#include "game_logic.h"
+#include <stddef.h>
+#include "game_config.h"
+
+// End of the table a player defends
+static int32_t player_y(uint8_t player)
+{
+    return (player == 1) ? TABLE_Y_TOP : TABLE_Y_BOTTOM;
+}
+
+// xorshift32: the same sequence from the same seed on the target and a host
+static uint32_t next_random(game_logic_t *game)
+{
+    uint32_t x = game->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    game->random_state = x;
+    return x;
+}
+
+// Put the ball at a random spot of a player's end for the serve
+static int64_t place_for_serve(game_logic_t *game, uint8_t player)
+{
+    game->ball_x_mm = (int32_t)(next_random(game) % (TABLE_WIDTH_MM + 1));
+    return game->ops->place(game->ctx, game->ball_x_mm, player_y(player));
+}
+
+static void miss(game_logic_t *game, int64_t at_us)
+{
+    uint8_t missed = game->player;
+    if (missed == 1)
+        game->score.score_2++;
+    else
+        game->score.score_1++;
+    game->ops->score(game->ctx, &game->score);
+
+    uint8_t winner = (game->score.score_1 >= WIN_SCORE) ? 1 : (game->score.score_2 >= WIN_SCORE) ? 2
+                                                                                                 : 0;
+    if (winner > 0)
+    {
+        game->ops->win(game->ctx, winner);
+        game->score.score_1 = 0;
+        game->score.score_2 = 0;
+        game->ops->score(game->ctx, &game->score);
+
+        game->state = GAME_STATE_WIN;
+        game->player = 1;
+        game->arrival_us = place_for_serve(game, 1);
+        game->window_open_us = game->arrival_us;
+        return;
+    }
+
+    // Swings that came too late for the missed ball do not serve
+    game->ops->point(game->ctx, missed);
+    game->state = GAME_STATE_POINT;
+    game->arrival_us = at_us;
+    game->window_open_us = at_us;
+}
+
+static int64_t decision_time(const game_logic_t *game)
+{
+    return game->deadline_us + (int64_t)HIT_DECISION_MARGIN_MS * 1000;
+}
+
+// Apply everything that is due by now_us; a late call catches up in order
+static void advance(game_logic_t *game, int64_t now_us)
+{
+    if (game->state == GAME_STATE_IN_FLIGHT && now_us >= game->window_open_us)
+    {
+        game->state = GAME_STATE_HIT_WINDOW;
+    }
+
+    int64_t decision_us = decision_time(game);
+    if (game->state == GAME_STATE_HIT_WINDOW && now_us > decision_us)
+    {
+        miss(game, decision_us);
+    }
+}
+
+void game_logic_init(game_logic_t *game, const game_ops_t *ops, void *ctx, uint32_t seed)
+{
+    game->ops = ops;
+    game->ctx = ctx;
+    game->state = GAME_STATE_SERVE;
+    game->player = 1;
+    game->ball_x_mm = TABLE_WIDTH_MM / 2;
+    game->arrival_us = 0;
+    game->window_open_us = 0;
+    game->deadline_us = 0;
+    game->score.score_1 = 0;
+    game->score.score_2 = 0;
+    game->random_state = (seed != 0) ? seed : 0x9E3779B9; // xorshift stays at 0 from 0
+}
+
+void game_logic_start(game_logic_t *game)
+{
+    game->state = GAME_STATE_SERVE;
+    game->player = 1;
+    game->arrival_us = place_for_serve(game, 1);
+    game->window_open_us = game->arrival_us;
+}
+
+static game_hit_result_t judge(const game_logic_t *game, const game_hit_t *hit)
+{
+    if (hit->player != game->player)
+    {
+        return GAME_HIT_WRONG_PLAYER;
+    }
+    if (game->state == GAME_STATE_IN_FLIGHT || hit->swing_us < game->window_open_us)
+    {
+        return GAME_HIT_EARLY;
+    }
+    if (game->state == GAME_STATE_HIT_WINDOW && hit->swing_us > game->deadline_us)
+    {
+        return GAME_HIT_LATE;
+    }
+    return GAME_HIT_PLAYED;
+}
+
+game_hit_result_t game_logic_hit(game_logic_t *game, const game_hit_t *hit, int64_t now_us)
+{
+    advance(game, hit->at_us);
+
+    game_hit_result_t result = judge(game, hit);
+    if (result != GAME_HIT_PLAYED)
+    {
+        advance(game, now_us);
+        return result;
+    }
+
+    uint8_t receiver = (hit->player == 1) ? 2 : 1;
+    bool fireball = (hit->button == BUTTON_FIREBALL);
+
+    ball_shot_t shot;
+    ball_model_shot(&hit->swing, game->ball_x_mm, player_y(hit->player), player_y(receiver), fireball, &shot);
+
+    game->ball_x_mm = shot.x_mm;
+    game->arrival_us = game->ops->shoot(game->ctx, &shot, fireball);
+    game->window_open_us = game->arrival_us - (int64_t)HIT_EARLY_MS * 1000;
+    game->deadline_us = game->arrival_us + (int64_t)HIT_LATE_MS * 1000;
+    game->state = GAME_STATE_IN_FLIGHT;
+    game->player = receiver;
+
+    advance(game, now_us);
+    return GAME_HIT_PLAYED;
+}
+
+void game_logic_tick(game_logic_t *game, int64_t now_us)
+{
+    advance(game, now_us);
+}
+
+int64_t game_logic_next_due_us(const game_logic_t *game)
+{
+    switch (game->state)
+    {
+    case GAME_STATE_IN_FLIGHT:
+        return game->window_open_us;
+    case GAME_STATE_HIT_WINDOW:
+        return decision_time(game) + 1;
+    default:
+        return INT64_MAX;
+    }
+}
+
+bool game_logic_snapshot(const game_logic_t *game, game_snapshot_t *snapshot)
+{
+    if (game->state == GAME_STATE_IN_FLIGHT || game->state == GAME_STATE_HIT_WINDOW)
+    {
+        return false;
+    }
+
+    snapshot->state = game->state;
+    snapshot->player = game->player;
+    snapshot->ball_x_mm = game->ball_x_mm;
+    snapshot->serve_from_us = game->window_open_us;
+    snapshot->score = game->score;
+    snapshot->random_state = game->random_state;
+    return true;
+}
+
+void game_logic_resume(game_logic_t *game, const game_ops_t *ops, void *ctx, const game_snapshot_t *snapshot)
+{
+    game_logic_init(game, ops, ctx, snapshot->random_state);
+    game->state = snapshot->state;
+    game->player = snapshot->player;
+    game->ball_x_mm = snapshot->ball_x_mm;
+    game->arrival_us = snapshot->serve_from_us;
+    game->window_open_us = snapshot->serve_from_us;
+    game->score = snapshot->score;
+}
+
+const char *game_logic_state_name(game_state_t state)
+{
+    switch (state)
+    {
+    case GAME_STATE_SERVE:
+        return "SERVE";
+    case GAME_STATE_IN_FLIGHT:
+        return "IN_FLIGHT";
+    case GAME_STATE_HIT_WINDOW:
+        return "HIT_WINDOW";
+    case GAME_STATE_POINT:
+        return "POINT";
+    case GAME_STATE_WIN:
+        return "WIN";
+    default:
+        return "?";
+    }
+}
+
+const char *game_logic_hit_result_name(game_hit_result_t result)
+{
+    switch (result)
+    {
+    case GAME_HIT_PLAYED:
+        return "played";
+    case GAME_HIT_EARLY:
+        return "early";
+    case GAME_HIT_LATE:
+        return "late";
+    case GAME_HIT_WRONG_PLAYER:
+        return "not their turn";
+    default:
+        return "?";
+    }
+}
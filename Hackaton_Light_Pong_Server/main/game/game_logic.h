@@ -0,0 +1,228 @@
+/**
+ * @file game_logic.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Light Pong rules as a state machine, independent of FreeRTOS and ESP-IDF
+ *
+ * The game advances only through game_logic_hit() and game_logic_tick(),
+ * both given the current time; it never waits or reads a clock itself.
+ * Everything it does to the outside world goes through game_ops_t, so the
+ * same code runs on the target and, with stub operations, on a host.
+ * Serve positions come from a PRNG seeded at init, so a game replays
+ * exactly from its seed (or a snapshot) and its inputs.
+ *
+ * States, with the player whose hit the game waits for:
+ *
+ *   SERVE      -- serve hit -->          IN_FLIGHT (receiver)
+ *   IN_FLIGHT  -- window opens -->       HIT_WINDOW
+ *   HIT_WINDOW -- hit -->                IN_FLIGHT (other player)
+ *   HIT_WINDOW -- timeout, no winner --> POINT (player who missed serves)
+ *   HIT_WINDOW -- timeout, winner -->    WIN (player 1 serves)
+ *   POINT, WIN -- serve hit -->          IN_FLIGHT
+ *
+ * A return is judged by when the paddle was swung, not when its packet
+ * came in: it counts if the swing lies within HIT_EARLY_MS before to
+ * HIT_LATE_MS after the predicted arrival of the ball. The miss is called
+ * HIT_DECISION_MARGIN_MS after the window closed, so a swing made in time
+ * but still on its way does not lose the point.
+ */
+
+#ifndef GAME_LOGIC_H
+#define GAME_LOGIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "game_types.h"
+#include "ball_model.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Game states
+     */
+    typedef enum
+    {
+        GAME_STATE_SERVE = 0,  // Ball placed for the first serve
+        GAME_STATE_IN_FLIGHT,  // Ball travelling, swings are too early
+        GAME_STATE_HIT_WINDOW, // Ball about to land or landed, receiver has to swing before the deadline
+        GAME_STATE_POINT,      // Point scored, player who missed serves
+        GAME_STATE_WIN,        // Game won, victory playing, player 1 serves
+    } game_state_t;
+
+    /**
+     * @brief Paddle hit as seen by the game
+     */
+    typedef struct
+    {
+        int64_t at_us;      // Time the hit was received
+        int64_t swing_us;   // Time the paddle was swung, latency removed (at_us if unknown)
+        uint8_t player;     // Player ID (1 or 2)
+        uint8_t button;     // BUTTON_FIREBALL or BUTTON_NORMAL
+        ball_swing_t swing; // IMU sample of the swing, shapes the shot
+    } game_hit_t;
+
+    /**
+     * @brief What a hit did
+     */
+    typedef enum
+    {
+        GAME_HIT_PLAYED = 0,   // Served or returned the ball
+        GAME_HIT_EARLY,        // Swing before the window opened
+        GAME_HIT_LATE,         // Swing after the window closed
+        GAME_HIT_WRONG_PLAYER, // Not this player's turn
+    } game_hit_result_t;
+
+    /**
+     * @brief Operations the game uses to act on the outside world
+     *
+     * Called from within game_logic_hit() and game_logic_tick() and must
+     * not block.
+     */
+    typedef struct
+    {
+        /**
+         * @brief Shoot the ball along a shot worked out by the ball model
+         * @return Time from which the ball can be returned (landed, look settled)
+         */
+        int64_t (*shoot)(void *ctx, const ball_shot_t *shot, bool fireball);
+
+        /**
+         * @brief Move the ball to a serve position
+         * @return Time the ball gets there
+         */
+        int64_t (*place)(void *ctx, int32_t x_mm, int32_t y_mm);
+
+        /** @brief A player missed, the game goes on */
+        void (*point)(void *ctx, uint8_t missed_player);
+
+        /** @brief A player reached WIN_SCORE; the score is reset afterwards */
+        void (*win)(void *ctx, uint8_t winner);
+
+        /** @brief The score changed */
+        void (*score)(void *ctx, const game_score_t *score);
+    } game_ops_t;
+
+    /**
+     * @brief Game context
+     *
+     * Fields are readable by the caller; change them only through the
+     * game_logic_* functions.
+     */
+    typedef struct
+    {
+        const game_ops_t *ops;
+        void *ctx;              // Passed to every operation
+        game_state_t state;
+        uint8_t player;         // Player whose hit the game waits for
+        int32_t ball_x_mm;      // Where the ball is or lands, across the table
+        int64_t arrival_us;     // Predicted ball arrival, or when the serve became possible
+        int64_t window_open_us; // Earlier swings do not count
+        int64_t deadline_us;    // Later swings do not count (returns only)
+        game_score_t score;
+        uint32_t random_state;  // Serve position PRNG
+    } game_logic_t;
+
+    /**
+     * @brief Game between points (SERVE, POINT or WIN), enough to resume it
+     */
+    typedef struct
+    {
+        game_state_t state;
+        uint8_t player;        // Player to serve
+        int32_t ball_x_mm;
+        int64_t serve_from_us; // Earlier serve swings do not count
+        game_score_t score;
+        uint32_t random_state;
+    } game_snapshot_t;
+
+    /**
+     * @brief Set up a game; nothing happens before game_logic_start()
+     *
+     * @param game Game context
+     * @param ops Operations, must stay valid for the life of the game
+     * @param ctx Passed to every operation
+     * @param seed Seed for the serve positions
+     */
+    void game_logic_init(game_logic_t *game, const game_ops_t *ops, void *ctx, uint32_t seed);
+
+    /**
+     * @brief Place the ball for player 1's serve and enter SERVE
+     *
+     * @param game Game context
+     */
+    void game_logic_start(game_logic_t *game);
+
+    /**
+     * @brief Feed a paddle hit
+     *
+     * The game first advances to the hit's receive time, so a hit that came
+     * in before the hit window closed counts even if it is handled later.
+     *
+     * @param game Game context
+     * @param hit Hit to apply
+     * @param now_us Current time
+     * @return GAME_HIT_PLAYED if the hit played the ball, otherwise why it was ignored
+     */
+    game_hit_result_t game_logic_hit(game_logic_t *game, const game_hit_t *hit, int64_t now_us);
+
+    /**
+     * @brief Advance the game to the current time
+     *
+     * Call at a fixed rate (GAME_TICK_MS); landings and missed balls are
+     * detected here.
+     *
+     * @param game Game context
+     * @param now_us Current time
+     */
+    void game_logic_tick(game_logic_t *game, int64_t now_us);
+
+    /**
+     * @brief Get the time from which game_logic_tick() has something to do
+     *
+     * A tick before this time changes nothing.
+     *
+     * @param game Game context
+     * @return Time of the next landing or miss, INT64_MAX while only a hit can move the game on
+     */
+    int64_t game_logic_next_due_us(const game_logic_t *game);
+
+    /**
+     * @brief Take a snapshot of the game between points
+     *
+     * @param game Game context
+     * @param snapshot Pointer to store the snapshot
+     * @return true if taken, false while a ball is in play
+     */
+    bool game_logic_snapshot(const game_logic_t *game, game_snapshot_t *snapshot);
+
+    /**
+     * @brief Set up a game from a snapshot instead of game_logic_init()/game_logic_start()
+     *
+     * No operation is called; the game goes on as it would have from the
+     * snapshot.
+     *
+     * @param game Game context
+     * @param ops Operations, must stay valid for the life of the game
+     * @param ctx Passed to every operation
+     * @param snapshot Snapshot from game_logic_snapshot()
+     */
+    void game_logic_resume(game_logic_t *game, const game_ops_t *ops, void *ctx, const game_snapshot_t *snapshot);
+
+    /**
+     * @brief Get a state's name for logging
+     */
+    const char *game_logic_state_name(game_state_t state);
+
+    /**
+     * @brief Get a hit result's name for logging
+     */
+    const char *game_logic_hit_result_name(game_hit_result_t result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GAME_LOGIC_H
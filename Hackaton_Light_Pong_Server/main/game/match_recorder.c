@@ -0,0 +1,135 @@
+/**
+ * @file match_recorder.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Ring buffer of match records, flushed to the log
+ */
+
+#include "match_recorder.h"
+#include <string.h>
+#include "../config/game_config.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "match_rec";
+
+_Static_assert(sizeof(match_record_t) == 32, "match_record_t is part of the log format");
+
+static match_record_t records[MATCH_RECORDER_RECORDS];
+static uint32_t written = 0; // Records ever added; the next one goes to written % MATCH_RECORDER_RECORDS
+static uint32_t flushed = 0; // Records ever logged or lost, only touched by the flushing task
+static portMUX_TYPE record_lock = portMUX_INITIALIZER_UNLOCKED; // Guards records and written
+
+static void add(match_record_t *record)
+{
+    record->version = MATCH_RECORD_VERSION;
+
+    portENTER_CRITICAL(&record_lock);
+    records[written % MATCH_RECORDER_RECORDS] = *record;
+    written++;
+    portEXIT_CRITICAL(&record_lock);
+}
+
+// Hits reach the game within ESPNOW_SWING_MAX_AGE_MS of the swing and a queue wait of receiving
+void match_recorder_hit(const game_hit_t *hit, int64_t now_us)
+{
+    match_record_t record = {
+        .t_us = hit->at_us,
+        .type = MATCH_RECORD_HIT,
+        .player = hit->player,
+        .arg = hit->button};
+    record.hit.swing_dt_us = (int32_t)(hit->swing_us - hit->at_us);
+    record.hit.handled_dt_us = (int32_t)(now_us - hit->at_us);
+    memcpy(record.hit.accel_mg, hit->swing.accel_mg, sizeof(record.hit.accel_mg));
+    memcpy(record.hit.gyro_dps, hit->swing.gyro_dps, sizeof(record.hit.gyro_dps));
+    add(&record);
+}
+
+void match_recorder_tick(int64_t now_us)
+{
+    match_record_t record = {
+        .t_us = now_us,
+        .type = MATCH_RECORD_TICK};
+    add(&record);
+}
+
+void match_recorder_shot(const ball_shot_t *shot, bool fireball, int64_t ready_us)
+{
+    match_record_t record = {
+        .t_us = ready_us,
+        .type = MATCH_RECORD_SHOT,
+        .arg = fireball};
+    record.shot.x_mm = shot->x_mm;
+    record.shot.via_x_mm = shot->via_x_mm;
+    record.shot.flight_ms = shot->flight_ms;
+    add(&record);
+}
+
+void match_recorder_place(int32_t x_mm, int32_t y_mm, int64_t arrival_us)
+{
+    match_record_t record = {
+        .t_us = arrival_us,
+        .type = MATCH_RECORD_PLACE};
+    record.place.x_mm = x_mm;
+    record.place.y_mm = y_mm;
+    add(&record);
+}
+
+void match_recorder_state(const game_logic_t *game)
+{
+    match_record_t record = {
+        .t_us = game->window_open_us,
+        .type = MATCH_RECORD_STATE,
+        .player = game->player,
+        .arg = (uint8_t)game->state};
+    record.state.ball_x_mm = game->ball_x_mm;
+    record.state.random_state = game->random_state;
+    record.state.score_1 = game->score.score_1;
+    record.state.score_2 = game->score.score_2;
+    add(&record);
+}
+
+void match_recorder_flush(void)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    portENTER_CRITICAL(&record_lock);
+    uint32_t end = written;
+    portEXIT_CRITICAL(&record_lock);
+
+    if (end - flushed > MATCH_RECORDER_RECORDS)
+    {
+        ESP_LOGW(TAG, "%lu records lost before flush", (unsigned long)(end - flushed - MATCH_RECORDER_RECORDS));
+        flushed = end - MATCH_RECORDER_RECORDS;
+    }
+
+    // Each record is copied out alone, so recording goes on while the log is slow
+    while (flushed != end)
+    {
+        match_record_t record;
+        bool overwritten;
+        portENTER_CRITICAL(&record_lock);
+        overwritten = (written - flushed > MATCH_RECORDER_RECORDS);
+        record = records[flushed % MATCH_RECORDER_RECORDS];
+        portEXIT_CRITICAL(&record_lock);
+
+        if (overwritten)
+        {
+            ESP_LOGW(TAG, "Record %lu lost during flush", (unsigned long)flushed);
+            flushed++;
+            continue;
+        }
+
+        char hex[2 * sizeof(record) + 1];
+        const uint8_t *bytes = (const uint8_t *)&record;
+        for (size_t i = 0; i < sizeof(record); i++)
+        {
+            hex[2 * i] = digits[bytes[i] >> 4];
+            hex[2 * i + 1] = digits[bytes[i] & 0x0F];
+        }
+        hex[2 * sizeof(record)] = '\0';
+
+        ESP_LOGI(TAG, "REC %lu %s", (unsigned long)flushed, hex);
+        flushed++;
+    }
+}
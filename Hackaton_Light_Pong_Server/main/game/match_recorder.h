@@ -0,0 +1,146 @@
+/**
+ * @file match_recorder.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Binary record of everything the game logic saw and did
+ *
+ * The game controller records each input it feeds the game (paddle hits,
+ * ticks that change something), what the operations returned (shot and
+ * serve arrival times) and every resulting state change with the score and
+ * the serve PRNG state. That is all game_logic.c depends on, so
+ * tools/match_replay reruns a recorded match on a host and checks every
+ * step against the recording.
+ *
+ * Records are kept in a ring of MATCH_RECORDER_RECORDS and written to the
+ * log as hex by match_recorder_flush(). Recording never blocks.
+ *
+ * The record layout is shared with the host tool: fixed size, little
+ * endian, no pointers. Change it only together with MATCH_RECORD_VERSION.
+ */
+
+#ifndef MATCH_RECORDER_H
+#define MATCH_RECORDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "game_logic.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MATCH_RECORD_VERSION 1
+
+    /**
+     * @brief Record types
+     */
+    typedef enum
+    {
+        MATCH_RECORD_HIT = 1, // Paddle hit fed to the game; t_us = received
+        MATCH_RECORD_TICK,    // Tick that had something to do; t_us = tick time
+        MATCH_RECORD_SHOT,    // shoot operation; t_us = its return value
+        MATCH_RECORD_PLACE,   // place operation; t_us = its return value
+        MATCH_RECORD_STATE,   // Game after start, a hit or a tick; t_us = window_open_us
+    } match_record_type_t;
+
+    /**
+     * @brief One record, 32 bytes
+     */
+    typedef struct
+    {
+        int64_t t_us;
+        uint8_t type;   // match_record_type_t
+        uint8_t player; // HIT: who hit, STATE: whose hit the game waits for
+        uint8_t arg;    // HIT: button, SHOT: fireball, STATE: game_state_t
+        uint8_t version;
+        union
+        {
+            struct
+            {
+                int32_t swing_dt_us;   // Swing time relative to t_us
+                int32_t handled_dt_us; // Time the hit was handled, relative to t_us
+                int16_t accel_mg[3];
+                int16_t gyro_dps[3];
+            } hit;
+            struct
+            {
+                int32_t x_mm;
+                int32_t via_x_mm;
+                uint32_t flight_ms;
+            } shot;
+            struct
+            {
+                int32_t x_mm;
+                int32_t y_mm;
+            } place;
+            struct
+            {
+                int32_t ball_x_mm;
+                uint32_t random_state;
+                uint8_t score_1;
+                uint8_t score_2;
+            } state;
+        };
+    } match_record_t;
+
+    /**
+     * @brief Record a paddle hit, before it is fed to the game
+     *
+     * @param hit Hit as passed to game_logic_hit()
+     * @param now_us Time passed to game_logic_hit()
+     */
+    void match_recorder_hit(const game_hit_t *hit, int64_t now_us);
+
+    /**
+     * @brief Record a tick, before it is fed to the game
+     *
+     * Only ticks from game_logic_next_due_us() on need recording; earlier
+     * ones change nothing.
+     *
+     * @param now_us Time passed to game_logic_tick()
+     */
+    void match_recorder_tick(int64_t now_us);
+
+    /**
+     * @brief Record a shot and what the shoot operation returned
+     *
+     * @param shot Shot passed to the operation
+     * @param fireball Fireball passed to the operation
+     * @param ready_us Time the operation returned
+     */
+    void match_recorder_shot(const ball_shot_t *shot, bool fireball, int64_t ready_us);
+
+    /**
+     * @brief Record a serve position and what the place operation returned
+     *
+     * @param x_mm Position passed to the operation
+     * @param y_mm Position passed to the operation
+     * @param arrival_us Time the operation returned
+     */
+    void match_recorder_place(int32_t x_mm, int32_t y_mm, int64_t arrival_us);
+
+    /**
+     * @brief Record the game's state
+     *
+     * Call after game_logic_start() and after every recorded hit and
+     * tick. Records between points are where a replay can start.
+     *
+     * @param game Game context
+     */
+    void match_recorder_state(const game_logic_t *game);
+
+    /**
+     * @brief Write the records added since the last flush to the log
+     *
+     * One "REC <seq> <hex>" line per record. Takes a while on a slow
+     * console; call from a low priority task. Records overwritten before
+     * they were flushed are reported as lost.
+     */
+    void match_recorder_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATCH_RECORDER_H
@@ -11,37 +11,96 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/event_groups.h"
+#include "freertos/queue.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "nvs_flash.h"
 #include "dmx_driver.h"
 #include "mh_x25_driver.h"
+#include "motion_engine.h"
+#include "light_effects.h"
+#include "light_mixer.h"
+#include "table_map.h"
 #include "config/hardware_config.h"
 #include "config/game_config.h"
 #include "espnow_handler.h"
 #include "game/game_controller.h"
 #include "game/game_types.h"
+#include "game/match_recorder.h"
+#include "calibration/table_calibration.h"
 
 static const char *TAG = "main";
 
-static EventGroupHandle_t paddle_events;
+static QueueHandle_t paddle_hits;
 static volatile int current_side = SIDE_TOP;
-static volatile uint8_t last_btn_left_pressed = 0;
-static volatile uint8_t last_btn_right_pressed = 0;
 
 static dmx_handle_t dmx_handle = NULL;
 static mh_x25_handle_t light_handle = NULL;
+static motion_handle_t motion_handle = NULL;
+static light_effects_handle_t effects_handle = NULL;
+static light_mixer_handle_t mixer_handle = NULL;
+static light_mixer_layer_handle_t ball_layer = NULL;
+static light_mixer_layer_handle_t effects_layer = NULL;
+static table_map_t table_map;
+
+// Startup path storage, so init needs no heap of its own and RAM use is fixed at link time
+static StaticQueue_t paddle_hits_storage;
+static uint8_t paddle_hits_buffer[ESPNOW_HIT_QUEUE_LEN * sizeof(paddle_hit_t)];
+static dmx_static_t dmx_storage;
+static mh_x25_static_t light_storage;
+static motion_static_t motion_storage;
+static light_effects_static_t effects_storage;
+static light_mixer_static_t mixer_storage;
 
 static game_score_t game_score = {0, 0};
 
+// Falls back to the configured corner aims when no calibration is stored
+static void load_table_map(void)
+{
+    esp_err_t ret = table_map_load(&table_map);
+    if (ret == ESP_OK)
+    {
+        ESP_LOGI(TAG, "Table calibration loaded");
+        return;
+    }
+
+    ESP_LOGW(TAG, "No table calibration (%s), using default field bounds", esp_err_to_name(ret));
+    const table_map_point_t corners[] = {
+        {0, TABLE_Y_TOP, PAN_MIN << 8, TILT_TOP << 8},
+        {TABLE_WIDTH_MM, TABLE_Y_TOP, PAN_MAX << 8, TILT_TOP << 8},
+        {0, TABLE_Y_BOTTOM, PAN_MIN << 8, TILT_BOTTOM << 8},
+        {TABLE_WIDTH_MM, TABLE_Y_BOTTOM, PAN_MAX << 8, TILT_BOTTOM << 8}};
+    table_map_solve(corners, sizeof(corners) / sizeof(corners[0]), &table_map);
+}
+
 void app_main(void)
 {
     ESP_LOGI(TAG, "Initializing Light Pong Game");
 
-    // Create event group for paddle communication
-    paddle_events = xEventGroupCreate();
-    if (paddle_events == NULL)
+    // NVS holds the table calibration; the ESP-NOW task's later init is a no-op
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
     {
-        ESP_LOGE(TAG, "Failed to create event group");
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK)
+    {
+        ESP_LOGW(TAG, "NVS init failed: %s", esp_err_to_name(ret));
+    }
+    load_table_map();
+
+    // Measure the DMX bring-up alone, NVS keeps its own heap and reads flash
+    int64_t init_start_us = esp_timer_get_time();
+    uint32_t init_free_heap = esp_get_free_heap_size();
+
+    // Paddle hits travel by value from the ESP-NOW callback to the game task
+    paddle_hits = xQueueCreateStatic(ESPNOW_HIT_QUEUE_LEN, sizeof(paddle_hit_t),
+                                     paddle_hits_buffer, &paddle_hits_storage);
+    if (paddle_hits == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to create paddle hit queue");
         return;
     }
 
@@ -51,9 +110,11 @@ void app_main(void)
         .rx_pin = DMX_RX_PIN,
         .enable_pin = DMX_ENABLE_PIN,
         .uart_num = UART_NUM_1,
-        .universe_size = 512};
+        .universe_size = 512,
+        .tx_mode = DMX_TX_MODE_HW_BREAK,
+        .frame_mode = DMX_FRAME_TRUNCATED};
 
-    esp_err_t ret = dmx_init(&dmx_config, &dmx_handle);
+    ret = dmx_init_static(&dmx_config, &dmx_storage, &dmx_handle);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to initialize DMX: %s", esp_err_to_name(ret));
@@ -65,7 +126,7 @@ void app_main(void)
         .dmx_handle = dmx_handle,
         .start_channel = MH_X25_START_CHANNEL};
 
-    ret = mh_x25_init(&light_config, &light_handle);
+    ret = mh_x25_init_static(&light_config, &light_storage, &light_handle);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to initialize MH X25: %s", esp_err_to_name(ret));
@@ -74,26 +135,112 @@ void app_main(void)
     }
     ESP_LOGI(TAG, "MH X25 initialized at DMX address %d", MH_X25_START_CHANNEL);
 
+    // Ball flights are interpolated into every DMX frame instead of left to the fixture
+    motion_config_t motion_config = {
+        .dmx_handle = dmx_handle,
+        .fixture = light_handle};
+
+    ret = motion_init_static(&motion_config, &motion_storage, &motion_handle);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to initialize motion engine: %s", esp_err_to_name(ret));
+        mh_x25_deinit(light_handle);
+        dmx_deinit(dmx_handle);
+        return;
+    }
+
+    // Ball look and celebrations write separate layers, resolved once per frame
+    light_mixer_config_t mixer_config = {
+        .dmx_handle = dmx_handle,
+        .fixture = light_handle};
+
+    ret = light_mixer_init_static(&mixer_config, &mixer_storage, &mixer_handle);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to initialize light mixer: %s", esp_err_to_name(ret));
+        motion_deinit(motion_handle);
+        mh_x25_deinit(light_handle);
+        dmx_deinit(dmx_handle);
+        return;
+    }
+
+    ret = light_mixer_add_layer(mixer_handle, 0, &ball_layer);
+    if (ret == ESP_OK)
+    {
+        ret = light_mixer_add_layer(mixer_handle, 1, &effects_layer);
+    }
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to add light mixer layers: %s", esp_err_to_name(ret));
+        light_mixer_deinit(mixer_handle);
+        motion_deinit(motion_handle);
+        mh_x25_deinit(light_handle);
+        dmx_deinit(dmx_handle);
+        return;
+    }
+
+    // Celebrations play frame by frame so the game task never waits them out
+    light_effects_config_t effects_config = {
+        .dmx_handle = dmx_handle,
+        .fixture = light_handle,
+        .layer = effects_layer};
+
+    ret = light_effects_init_static(&effects_config, &effects_storage, &effects_handle);
+    if (ret == ESP_OK)
+    {
+        // After the effect player, so its keyframes are mixed into the same frame
+        ret = light_mixer_start(mixer_handle);
+    }
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to initialize effect player: %s", esp_err_to_name(ret));
+        if (effects_handle != NULL)
+        {
+            light_effects_deinit(effects_handle);
+        }
+        light_mixer_deinit(mixer_handle);
+        motion_deinit(motion_handle);
+        mh_x25_deinit(light_handle);
+        dmx_deinit(dmx_handle);
+        return;
+    }
+
     // Start continuous DMX transmission
     ret = dmx_start_transmission(dmx_handle);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to start DMX transmission: %s", esp_err_to_name(ret));
+        light_effects_deinit(effects_handle);
+        light_mixer_deinit(mixer_handle);
+        motion_deinit(motion_handle);
         mh_x25_deinit(light_handle);
         dmx_deinit(dmx_handle);
         return;
     }
 
+    // Heap still used here comes from the UART driver and esp_timer internals
+    ESP_LOGI(TAG, "DMX output ready after %lld us, %lu bytes heap used",
+             (long long)(esp_timer_get_time() - init_start_us),
+             (unsigned long)(init_free_heap - esp_get_free_heap_size()));
+
+#if DMX_INPUT_ENABLED
+    // House lights from the upstream console share the line; without input the game output is unchanged
+    ret = dmx_input_start(dmx_handle, DMX_INPUT_MERGE_MODE);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGW(TAG, "DMX input merge not available: %s", esp_err_to_name(ret));
+    }
+#endif
+
     // Wait for DMX to stabilize
     vTaskDelay(pdMS_TO_TICKS(500));
 
     // Set context for communication module (inject dependencies)
-    espnow_set_context(paddle_events, (uint8_t *)&last_btn_left_pressed, (uint8_t *)&last_btn_right_pressed);
+    espnow_set_context(paddle_hits);
 
     // Set context for game controller (inject dependencies)
-    game_controller_set_context(light_handle, paddle_events, &current_side,
-                                (uint8_t *)&last_btn_left_pressed, (uint8_t *)&last_btn_right_pressed,
-                                &game_score);
+    game_controller_set_context(light_handle, motion_handle, effects_handle, ball_layer, &table_map, paddle_hits,
+                                &current_side, &game_score);
 
     xTaskCreate(
         espnow_receiver_task,
@@ -103,6 +250,17 @@ void app_main(void)
         5,
         NULL);
 
+#if TABLE_CALIBRATION_MODE
+    table_calibration_set_context(motion_handle, &table_map);
+
+    xTaskCreate(
+        table_calibration_task,
+        "table_cal",
+        4096,
+        NULL,
+        5,
+        NULL);
+#else
     xTaskCreate(
         dmx_controller_task,
         "dmx_ctrl",
@@ -110,12 +268,48 @@ void app_main(void)
         NULL,
         5,
         NULL);
+#endif
 
     ESP_LOGI(TAG, "System initialized successfully");
 
     // Main loop - keep running
+    uint32_t seconds = 0;
     while (1)
     {
         vTaskDelay(pdMS_TO_TICKS(1000));
+
+#if MATCH_RECORDER_LOG
+        // At this task's low priority, so a slow console does not hold up the game
+        match_recorder_flush();
+#endif
+
+        if (++seconds % 30 == 0)
+        {
+            mh_x25_write_stats_t writes;
+            mh_x25_get_write_stats(light_handle, &writes);
+            ESP_LOGI(TAG, "Fixture writes: %lu issued, %lu suppressed",
+                     (unsigned long)writes.writes_issued, (unsigned long)writes.writes_suppressed);
+
+            espnow_hit_stats_t hits;
+            espnow_get_hit_stats(&hits);
+            ESP_LOGI(TAG, "Paddle hits: %lu received, %lu dropped, queue %u/%d (peak %u)",
+                     (unsigned long)hits.received, (unsigned long)hits.dropped,
+                     hits.depth, ESPNOW_HIT_QUEUE_LEN, hits.max_depth);
+
+            for (uint8_t player = 1; player <= espnow_get_num_players(); player++)
+            {
+                espnow_paddle_clock_t clock;
+                espnow_get_paddle_clock(player, &clock);
+                if (clock.synced)
+                {
+                    ESP_LOGI(TAG, "Paddle %d: latency %ld us, clock offset %lld us",
+                             player, (long)clock.latency_us, (long long)clock.offset_us);
+                }
+                else
+                {
+                    ESP_LOGI(TAG, "Paddle %d: clock not synced", player);
+                }
+            }
+        }
     }
 }
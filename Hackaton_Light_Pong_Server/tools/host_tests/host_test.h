@@ -0,0 +1,70 @@
+/**
+ * @file host_test.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Checks for the host tests
+ *
+ * Each test program is one file of test functions run by RUN_TEST(); a
+ * failed check is printed and counted, and main() returns the count.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+static int host_test_failures;
+
+static inline void host_test_fail(const char *file, int line, const char *what)
+{
+    fprintf(stderr, "%s:%d: FAIL: %s\n", file, line, what);
+    host_test_failures++;
+}
+
+static inline void host_test_run(const char *name, void (*test)(void))
+{
+    int before = host_test_failures;
+    test();
+    printf("%s: %s\n", name, (host_test_failures == before) ? "PASS" : "FAIL");
+}
+
+#define CHECK(cond)                                      \
+    do                                                   \
+    {                                                    \
+        if (!(cond))                                     \
+        {                                                \
+            host_test_fail(__FILE__, __LINE__, #cond);   \
+        }                                                \
+    } while (0)
+
+#define CHECK_EQ(expected, actual)                                                       \
+    do                                                                                   \
+    {                                                                                    \
+        long long expected_ = (long long)(expected);                                     \
+        long long actual_ = (long long)(actual);                                         \
+        if (expected_ != actual_)                                                        \
+        {                                                                                \
+            char what_[160];                                                             \
+            snprintf(what_, sizeof(what_), "%s is %lld, expected %lld", #actual, actual_, \
+                     expected_);                                                         \
+            host_test_fail(__FILE__, __LINE__, what_);                                   \
+        }                                                                                \
+    } while (0)
+
+#define CHECK_NEAR(expected, actual, tolerance)                                             \
+    do                                                                                      \
+    {                                                                                       \
+        long long expected_ = (long long)(expected);                                        \
+        long long actual_ = (long long)(actual);                                            \
+        if (actual_ < expected_ - (tolerance) || actual_ > expected_ + (tolerance))         \
+        {                                                                                   \
+            char what_[160];                                                                \
+            snprintf(what_, sizeof(what_), "%s is %lld, expected %lld +- %lld", #actual,    \
+                     actual_, expected_, (long long)(tolerance));                           \
+            host_test_fail(__FILE__, __LINE__, what_);                                      \
+        }                                                                                   \
+    } while (0)
+
+#define RUN_TEST(test) host_test_run(#test, test)
+
+#endif // HOST_TEST_H
@@ -0,0 +1,22 @@
+/**
+ * @file esp_err.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Host stand-in for the ESP-IDF error codes the tested sources use
+ */
+
+#ifndef ESP_ERR_H
+#define ESP_ERR_H
+
+// ESP-IDF's esp_err.h brings these in, the sources rely on it
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+
+#endif // ESP_ERR_H
@@ -0,0 +1,18 @@
+/**
+ * @file esp_log.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Host stand-in for ESP-IDF logging, printed to stdout like the monitor shows it
+ */
+
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+#include <stdio.h>
+
+#define ESP_LOGE(tag, format, ...) printf("E (0) %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) printf("W (0) %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) printf("I (0) %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ((void)(tag))
+
+#endif // ESP_LOG_H
@@ -0,0 +1,19 @@
+/**
+ * @file FreeRTOS.h
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Host stand-in for the FreeRTOS critical sections the tested sources use
+ *
+ * The host tests are single threaded, so critical sections are empty.
+ */
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+typedef int portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+#endif // FREERTOS_H
@@ -0,0 +1,150 @@
+/**
+ * @file test_ball_model.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Shots from paddle swings: flight time, aim and curve
+ */
+
+#include "host_test.h"
+#include "ball_model.h"
+#include "game_config.h"
+
+#define FROM_X_MM (TABLE_WIDTH_MM / 2)
+
+// A swing straight down the table with the given strength beyond gravity
+static ball_swing_t swing_of(int16_t strength_mg)
+{
+    ball_swing_t swing = {.accel_mg = {0, 0, (int16_t)(1000 + strength_mg)}};
+    return swing;
+}
+
+static void shoot_down(const ball_swing_t *swing, bool fireball, ball_shot_t *shot)
+{
+    ball_model_shot(swing, FROM_X_MM, TABLE_Y_TOP, TABLE_Y_BOTTOM, fireball, shot);
+}
+
+static void test_paddle_at_rest_plays_slow_and_straight(void)
+{
+    ball_swing_t swing = swing_of(0);
+    ball_shot_t shot;
+    shoot_down(&swing, false, &shot);
+
+    CHECK_EQ(0, shot.strength_mg);
+    CHECK_EQ(BALL_FLIGHT_SLOW_MS, shot.flight_ms);
+    CHECK_EQ(FROM_X_MM, shot.x_mm);
+    CHECK_EQ(TABLE_Y_BOTTOM, shot.y_mm);
+    CHECK_EQ(FROM_X_MM, shot.via_x_mm);
+    CHECK_EQ((TABLE_Y_TOP + TABLE_Y_BOTTOM) / 2, shot.via_y_mm);
+}
+
+static void test_flight_time_follows_swing_strength(void)
+{
+    ball_shot_t shot;
+
+    ball_swing_t weak = swing_of(BALL_SWING_MIN_MG / 2);
+    shoot_down(&weak, false, &shot);
+    CHECK_EQ(BALL_FLIGHT_SLOW_MS, shot.flight_ms);
+
+    ball_swing_t middle = swing_of((BALL_SWING_MIN_MG + BALL_SWING_MAX_MG) / 2);
+    shoot_down(&middle, false, &shot);
+    CHECK_EQ((BALL_SWING_MIN_MG + BALL_SWING_MAX_MG) / 2, shot.strength_mg);
+    CHECK_EQ((BALL_FLIGHT_SLOW_MS + BALL_FLIGHT_FAST_MS) / 2, shot.flight_ms);
+
+    ball_swing_t hard = swing_of(BALL_SWING_MAX_MG);
+    shoot_down(&hard, false, &shot);
+    CHECK_EQ(BALL_FLIGHT_FAST_MS, shot.flight_ms);
+
+    ball_swing_t harder = swing_of(2 * BALL_SWING_MAX_MG);
+    shoot_down(&harder, false, &shot);
+    CHECK_EQ(BALL_FLIGHT_FAST_MS, shot.flight_ms);
+}
+
+static void test_strength_uses_all_axes(void)
+{
+    // |(3000, 4000, 0)| = 5000 mg, 4000 mg beyond gravity
+    ball_swing_t swing = {.accel_mg = {3000, 4000, 0}};
+    ball_shot_t shot;
+    shoot_down(&swing, false, &shot);
+    CHECK_EQ(4000, shot.strength_mg);
+
+    // Full scale on every axis does not overflow
+    ball_swing_t full = {.accel_mg = {-32768, -32768, -32768}};
+    shoot_down(&full, false, &shot);
+    CHECK_EQ(56755 - 1000, shot.strength_mg);
+    CHECK_EQ(BALL_FLIGHT_FAST_MS, shot.flight_ms);
+}
+
+static void test_fireball_ignores_the_swing(void)
+{
+    ball_shot_t shot;
+
+    ball_swing_t rest = swing_of(0);
+    shoot_down(&rest, true, &shot);
+    CHECK_EQ(BALL_FLIGHT_FIREBALL_MS, shot.flight_ms);
+
+    ball_swing_t hard = swing_of(BALL_SWING_MAX_MG);
+    shoot_down(&hard, true, &shot);
+    CHECK_EQ(BALL_FLIGHT_FIREBALL_MS, shot.flight_ms);
+}
+
+static void test_aim_is_mirrored_between_the_players(void)
+{
+    ball_swing_t swing = swing_of(0);
+    swing.gyro_dps[BALL_AIM_GYRO_AXIS] = 100;
+    ball_shot_t shot;
+
+    shoot_down(&swing, false, &shot);
+    CHECK_EQ(FROM_X_MM + BALL_AIM_MM_PER_100DPS, shot.x_mm);
+
+    ball_model_shot(&swing, FROM_X_MM, TABLE_Y_BOTTOM, TABLE_Y_TOP, false, &shot);
+    CHECK_EQ(FROM_X_MM - BALL_AIM_MM_PER_100DPS, shot.x_mm);
+    CHECK_EQ(TABLE_Y_TOP, shot.y_mm);
+}
+
+static void test_aim_stays_on_the_table(void)
+{
+    ball_swing_t swing = swing_of(0);
+    ball_shot_t shot;
+
+    swing.gyro_dps[BALL_AIM_GYRO_AXIS] = 2000;
+    shoot_down(&swing, false, &shot);
+    CHECK_EQ(TABLE_WIDTH_MM, shot.x_mm);
+
+    swing.gyro_dps[BALL_AIM_GYRO_AXIS] = -2000;
+    shoot_down(&swing, false, &shot);
+    CHECK_EQ(0, shot.x_mm);
+}
+
+static void test_spin_bends_the_path_within_limits(void)
+{
+    ball_swing_t swing = swing_of(0);
+    ball_shot_t shot;
+
+    swing.gyro_dps[BALL_SPIN_GYRO_AXIS] = 100;
+    shoot_down(&swing, false, &shot);
+    CHECK_EQ(FROM_X_MM, shot.x_mm);
+    CHECK_EQ(FROM_X_MM + BALL_CURVE_MM_PER_100DPS, shot.via_x_mm);
+
+    ball_model_shot(&swing, FROM_X_MM, TABLE_Y_BOTTOM, TABLE_Y_TOP, false, &shot);
+    CHECK_EQ(FROM_X_MM - BALL_CURVE_MM_PER_100DPS, shot.via_x_mm);
+
+    swing.gyro_dps[BALL_SPIN_GYRO_AXIS] = 10000;
+    shoot_down(&swing, false, &shot);
+    CHECK_EQ(FROM_X_MM + BALL_CURVE_MAX_MM, shot.via_x_mm);
+
+    // Near the edge the bend is cut at the table
+    ball_model_shot(&swing, TABLE_WIDTH_MM, TABLE_Y_TOP, TABLE_Y_BOTTOM, false, &shot);
+    CHECK_EQ(TABLE_WIDTH_MM, shot.via_x_mm);
+}
+
+int main(void)
+{
+    RUN_TEST(test_paddle_at_rest_plays_slow_and_straight);
+    RUN_TEST(test_flight_time_follows_swing_strength);
+    RUN_TEST(test_strength_uses_all_axes);
+    RUN_TEST(test_fireball_ignores_the_swing);
+    RUN_TEST(test_aim_is_mirrored_between_the_players);
+    RUN_TEST(test_aim_stays_on_the_table);
+    RUN_TEST(test_spin_bends_the_path_within_limits);
+    return host_test_failures;
+}
@@ -0,0 +1,347 @@
+/**
+ * @file test_game_logic.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Game state machine and hit judging
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "game_logic.h"
+#include "game_config.h"
+
+#define MS 1000LL
+
+/**
+ * @brief What the game did to the outside world
+ */
+typedef struct
+{
+    int64_t now_us;    // Time the operations see
+    int shots;
+    int places;
+    int points;
+    int wins;
+    uint8_t missed;    // Player passed to the last point operation
+    uint8_t winner;    // Player passed to the last win operation
+    ball_shot_t shot;  // Last shot
+} world_t;
+
+static int64_t op_shoot(void *ctx, const ball_shot_t *shot, bool fireball)
+{
+    world_t *world = (world_t *)ctx;
+    world->shots++;
+    world->shot = *shot;
+    return world->now_us + (int64_t)shot->flight_ms * MS;
+}
+
+static int64_t op_place(void *ctx, int32_t x_mm, int32_t y_mm)
+{
+    world_t *world = (world_t *)ctx;
+    world->places++;
+    return world->now_us + SERVE_MOVE_MS * MS;
+}
+
+static void op_point(void *ctx, uint8_t missed_player)
+{
+    world_t *world = (world_t *)ctx;
+    world->points++;
+    world->missed = missed_player;
+}
+
+static void op_win(void *ctx, uint8_t winner)
+{
+    world_t *world = (world_t *)ctx;
+    world->wins++;
+    world->winner = winner;
+}
+
+static void op_score(void *ctx, const game_score_t *score)
+{
+}
+
+static const game_ops_t ops = {
+    .shoot = op_shoot,
+    .place = op_place,
+    .point = op_point,
+    .win = op_win,
+    .score = op_score,
+};
+
+static void start_game(game_logic_t *game, world_t *world, uint32_t seed)
+{
+    memset(world, 0, sizeof(*world));
+    game_logic_init(game, &ops, world, seed);
+    game_logic_start(game);
+}
+
+// A hit received right after the swing, handled when received
+static game_hit_result_t swing(game_logic_t *game, world_t *world, uint8_t player, int64_t swing_us)
+{
+    game_hit_t hit = {
+        .at_us = swing_us,
+        .swing_us = swing_us,
+        .player = player,
+        .button = BUTTON_NORMAL,
+        .swing = {.accel_mg = {0, 0, 1000}}};
+
+    world->now_us = swing_us;
+    return game_logic_hit(game, &hit, swing_us);
+}
+
+// Serve as soon as the ball is in place; the ball is then on its way to player 2
+static void serve(game_logic_t *game, world_t *world)
+{
+    CHECK_EQ(GAME_HIT_PLAYED, swing(game, world, game->player, game->window_open_us));
+}
+
+static void test_start_places_the_serve(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+
+    CHECK_EQ(GAME_STATE_SERVE, game.state);
+    CHECK_EQ(1, game.player);
+    CHECK_EQ(1, world.places);
+    CHECK(game.ball_x_mm >= 0 && game.ball_x_mm <= TABLE_WIDTH_MM);
+    CHECK_EQ(SERVE_MOVE_MS * MS, game.window_open_us);
+    CHECK_EQ(INT64_MAX, game_logic_next_due_us(&game));
+}
+
+static void test_serve_waits_for_the_ball_and_the_server(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+
+    CHECK_EQ(GAME_HIT_WRONG_PLAYER, swing(&game, &world, 2, game.window_open_us));
+    CHECK_EQ(GAME_HIT_EARLY, swing(&game, &world, 1, game.window_open_us - 1));
+    CHECK_EQ(GAME_STATE_SERVE, game.state);
+    CHECK_EQ(0, world.shots);
+
+    serve(&game, &world);
+    CHECK_EQ(GAME_STATE_IN_FLIGHT, game.state);
+    CHECK_EQ(2, game.player);
+    CHECK_EQ(1, world.shots);
+    CHECK_EQ(world.now_us + (int64_t)world.shot.flight_ms * MS, game.arrival_us);
+    CHECK_EQ(game.arrival_us - HIT_EARLY_MS * MS, game.window_open_us);
+    CHECK_EQ(game.arrival_us + HIT_LATE_MS * MS, game.deadline_us);
+}
+
+static void test_window_opens_on_tick(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+    serve(&game, &world);
+
+    CHECK_EQ(game.window_open_us, game_logic_next_due_us(&game));
+    game_logic_tick(&game, game.window_open_us - 1);
+    CHECK_EQ(GAME_STATE_IN_FLIGHT, game.state);
+    game_logic_tick(&game, game.window_open_us);
+    CHECK_EQ(GAME_STATE_HIT_WINDOW, game.state);
+    CHECK_EQ(game.deadline_us + HIT_DECISION_MARGIN_MS * MS + 1, game_logic_next_due_us(&game));
+}
+
+static void test_early_swing_is_ignored(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+    serve(&game, &world);
+
+    // While the ball is in flight, and just before the window opens
+    CHECK_EQ(GAME_HIT_EARLY, swing(&game, &world, 2, game.window_open_us - 100 * MS));
+    CHECK_EQ(GAME_HIT_EARLY, swing(&game, &world, 2, game.window_open_us - 1));
+    CHECK_EQ(GAME_STATE_IN_FLIGHT, game.state);
+    CHECK_EQ(1, world.shots);
+
+    // The first swing in the window returns the ball
+    CHECK_EQ(GAME_HIT_PLAYED, swing(&game, &world, 2, game.window_open_us));
+    CHECK_EQ(1, game.player);
+    CHECK_EQ(2, world.shots);
+}
+
+static void test_late_swing_is_ignored(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+    serve(&game, &world);
+    int64_t deadline_us = game.deadline_us;
+
+    // Received before the miss is called, but swung after the window closed
+    CHECK_EQ(GAME_HIT_LATE, swing(&game, &world, 2, deadline_us + 1));
+    CHECK_EQ(GAME_STATE_HIT_WINDOW, game.state);
+    CHECK_EQ(1, world.shots);
+
+    CHECK_EQ(GAME_HIT_PLAYED, swing(&game, &world, 2, deadline_us));
+    CHECK_EQ(GAME_STATE_IN_FLIGHT, game.state);
+    CHECK_EQ(1, game.player);
+}
+
+static void test_swing_in_time_counts_within_the_decision_margin(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+    serve(&game, &world);
+    int64_t decision_us = game.deadline_us + HIT_DECISION_MARGIN_MS * MS;
+
+    // Ticks up to the decision time leave the ball in play
+    game_logic_tick(&game, decision_us);
+    CHECK_EQ(GAME_STATE_HIT_WINDOW, game.state);
+
+    // Swung at the deadline, received and handled at the end of the margin
+    game_hit_t hit = {
+        .at_us = decision_us,
+        .swing_us = game.deadline_us,
+        .player = 2,
+        .button = BUTTON_NORMAL,
+        .swing = {.accel_mg = {0, 0, 1000}}};
+    world.now_us = decision_us + 5 * MS;
+    CHECK_EQ(GAME_HIT_PLAYED, game_logic_hit(&game, &hit, world.now_us));
+    CHECK_EQ(0, world.points);
+    CHECK_EQ(1, game.player);
+}
+
+static void test_swing_received_after_the_decision_loses(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+    serve(&game, &world);
+    int64_t decision_us = game.deadline_us + HIT_DECISION_MARGIN_MS * MS;
+
+    // Swung in time, but the packet only came in once the miss was due
+    game_hit_t hit = {
+        .at_us = decision_us + 1,
+        .swing_us = game.deadline_us,
+        .player = 2,
+        .button = BUTTON_NORMAL,
+        .swing = {.accel_mg = {0, 0, 1000}}};
+    world.now_us = hit.at_us;
+    CHECK(game_logic_hit(&game, &hit, world.now_us) != GAME_HIT_PLAYED);
+    CHECK_EQ(1, world.points);
+    CHECK_EQ(2, world.missed);
+    CHECK_EQ(1, game.score.score_1);
+    CHECK_EQ(0, game.score.score_2);
+}
+
+static void test_miss_scores_and_the_loser_serves(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+    serve(&game, &world);
+    int64_t decision_us = game.deadline_us + HIT_DECISION_MARGIN_MS * MS;
+
+    game_logic_tick(&game, decision_us + 1);
+    CHECK_EQ(GAME_STATE_POINT, game.state);
+    CHECK_EQ(2, game.player);
+    CHECK_EQ(1, world.points);
+    CHECK_EQ(1, game.score.score_1);
+    CHECK_EQ(decision_us, game.window_open_us);
+
+    // Player 2 serves from where the ball is
+    int32_t ball_x_mm = game.ball_x_mm;
+    CHECK_EQ(GAME_HIT_WRONG_PLAYER, swing(&game, &world, 1, decision_us + 10 * MS));
+    CHECK_EQ(GAME_HIT_PLAYED, swing(&game, &world, 2, decision_us + 10 * MS));
+    CHECK_EQ(ball_x_mm, world.shot.x_mm);
+    CHECK_EQ(TABLE_Y_TOP, world.shot.y_mm);
+    CHECK_EQ(1, game.player);
+}
+
+static void test_win_resets_the_score(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1);
+
+    // Player 2 never returns a ball; player 1 returns player 2's serves
+    for (int rally = 0; rally < WIN_SCORE && world.wins == 0; rally++)
+    {
+        uint8_t server = game.player;
+        CHECK_EQ(GAME_HIT_PLAYED, swing(&game, &world, server, game.window_open_us + 10 * MS));
+        if (server == 2)
+        {
+            CHECK_EQ(GAME_HIT_PLAYED, swing(&game, &world, 1, game.window_open_us));
+        }
+        world.now_us = game.deadline_us + HIT_DECISION_MARGIN_MS * MS + 1;
+        game_logic_tick(&game, world.now_us);
+    }
+
+    CHECK_EQ(1, world.wins);
+    CHECK_EQ(1, world.winner);
+    CHECK_EQ(WIN_SCORE - 1, world.points);
+    CHECK_EQ(GAME_STATE_WIN, game.state);
+    CHECK_EQ(1, game.player);
+    CHECK_EQ(0, game.score.score_1);
+    CHECK_EQ(0, game.score.score_2);
+    CHECK_EQ(world.now_us + SERVE_MOVE_MS * MS, game.window_open_us);
+}
+
+static void test_snapshot_resumes_the_same_game(void)
+{
+    game_logic_t game;
+    world_t world;
+    start_game(&game, &world, 1234);
+
+    game_snapshot_t snapshot;
+    CHECK(game_logic_snapshot(&game, &snapshot));
+    serve(&game, &world);
+    CHECK(!game_logic_snapshot(&game, &snapshot));
+
+    // Lose a point to get between points with some PRNG use behind it
+    game_logic_tick(&game, game.deadline_us + HIT_DECISION_MARGIN_MS * MS + 1);
+    CHECK(game_logic_snapshot(&game, &snapshot));
+
+    game_logic_t resumed;
+    world_t resumed_world = world;
+    game_logic_resume(&resumed, &ops, &resumed_world, &snapshot);
+    CHECK_EQ(game.state, resumed.state);
+    CHECK_EQ(game.player, resumed.player);
+    CHECK_EQ(game.window_open_us, resumed.window_open_us);
+
+    // Both play the next point the same way
+    int64_t serve_us = game.window_open_us + 50 * MS;
+    swing(&game, &world, 2, serve_us);
+    swing(&resumed, &resumed_world, 2, serve_us);
+    CHECK_EQ(game.arrival_us, resumed.arrival_us);
+    CHECK_EQ(game.ball_x_mm, resumed.ball_x_mm);
+    CHECK_EQ(game.random_state, resumed.random_state);
+}
+
+static void test_same_seed_same_serves(void)
+{
+    game_logic_t a, b, c;
+    world_t world_a, world_b, world_c;
+    start_game(&a, &world_a, 42);
+    start_game(&b, &world_b, 42);
+    start_game(&c, &world_c, 43);
+
+    CHECK_EQ(a.ball_x_mm, b.ball_x_mm);
+    CHECK_EQ(a.random_state, b.random_state);
+    CHECK(a.random_state != c.random_state);
+
+    // Seed 0 would stall the xorshift
+    start_game(&c, &world_c, 0);
+    CHECK(c.random_state != 0);
+}
+
+int main(void)
+{
+    RUN_TEST(test_start_places_the_serve);
+    RUN_TEST(test_serve_waits_for_the_ball_and_the_server);
+    RUN_TEST(test_window_opens_on_tick);
+    RUN_TEST(test_early_swing_is_ignored);
+    RUN_TEST(test_late_swing_is_ignored);
+    RUN_TEST(test_swing_in_time_counts_within_the_decision_margin);
+    RUN_TEST(test_swing_received_after_the_decision_loses);
+    RUN_TEST(test_miss_scores_and_the_loser_serves);
+    RUN_TEST(test_win_resets_the_score);
+    RUN_TEST(test_snapshot_resumes_the_same_game);
+    RUN_TEST(test_same_seed_same_serves);
+    return host_test_failures;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file test_match_record.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Record a simulated match the way the game controller does
+ *
+ * Two scripted players play a match to the end through game_logic.c while
+ * match_recorder.c records it, with hits, ticks and operations in the
+ * game controller's order. The flushed records are written as a monitor
+ * log, and a copy with one recorded score altered:
+ *
+ *     test_match_record match.log match_altered.log
+ *
+ * ctest then replays both with tools/match_replay.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "match_recorder.h"
+#include "game_config.h"
+
+#define MS 1000LL
+#define LATENCY_US (30 * MS)       // Swing to hit received
+#define MATCH_LIMIT_US (1800000 * MS)
+
+#define REC_TYPE_HEX 16   // Hex offset of match_record_t.type
+#define REC_SCORE_1_HEX 40 // Hex offset of match_record_t.state.score_1
+
+/**
+ * @brief How a player answers a ball
+ */
+typedef enum
+{
+    PLAY_IN_TIME = 0,
+    PLAY_EARLY,
+    PLAY_LATE,
+    PLAY_MISS,
+} play_t;
+
+static int64_t now_us;
+static uint32_t script = 0x2545F491; // Players' own PRNG, apart from the game's
+static int wins;
+static int results[GAME_HIT_WRONG_PLAYER + 1];
+
+static uint32_t script_next(void)
+{
+    script ^= script << 13;
+    script ^= script >> 17;
+    script ^= script << 5;
+    return script;
+}
+
+static int64_t op_shoot(void *ctx, const ball_shot_t *shot, bool fireball)
+{
+    int64_t arrival_us = now_us + (int64_t)shot->flight_ms * MS;
+    match_recorder_shot(shot, fireball, arrival_us);
+    return arrival_us;
+}
+
+static int64_t op_place(void *ctx, int32_t x_mm, int32_t y_mm)
+{
+    int64_t arrival_us = now_us + SERVE_MOVE_MS * MS;
+    match_recorder_place(x_mm, y_mm, arrival_us);
+    return arrival_us;
+}
+
+static void op_point(void *ctx, uint8_t missed_player)
+{
+}
+
+static void op_win(void *ctx, uint8_t winner)
+{
+    wins++;
+}
+
+static void op_score(void *ctx, const game_score_t *score)
+{
+}
+
+static const game_ops_t ops = {
+    .shoot = op_shoot,
+    .place = op_place,
+    .point = op_point,
+    .win = op_win,
+    .score = op_score,
+};
+
+// When the player whose turn it is swings, -1 for not at all
+static int64_t plan_swing(const game_logic_t *game)
+{
+    if (game->state == GAME_STATE_SERVE || game->state == GAME_STATE_POINT || game->state == GAME_STATE_WIN)
+    {
+        return game->window_open_us + (int64_t)(script_next() % 500) * MS;
+    }
+
+    uint32_t roll = script_next();
+    switch ((play_t)(roll % 8 < 5 ? PLAY_IN_TIME : roll % 8 - 4))
+    {
+    case PLAY_EARLY:
+        return game->window_open_us - 50 * MS;
+    case PLAY_LATE:
+        return game->deadline_us + 40 * MS;
+    case PLAY_MISS:
+        return -1;
+    case PLAY_IN_TIME:
+    default:
+        return game->window_open_us + (int64_t)(roll % (HIT_EARLY_MS + HIT_LATE_MS)) * MS;
+    }
+}
+
+static void feed_hit(game_logic_t *game, int64_t swing_us)
+{
+    game_hit_t hit = {
+        .at_us = swing_us + LATENCY_US,
+        .swing_us = swing_us,
+        .player = game->player,
+        .button = (script_next() % 6 == 0) ? BUTTON_FIREBALL : BUTTON_NORMAL};
+    for (int i = 0; i < 3; i++)
+    {
+        hit.swing.accel_mg[i] = (int16_t)(script_next() % 3000);
+        hit.swing.gyro_dps[i] = (int16_t)(script_next() % 600) - 300;
+    }
+
+    match_recorder_hit(&hit, now_us);
+    results[game_logic_hit(game, &hit, now_us)]++;
+    match_recorder_state(game);
+}
+
+static void play_match(void)
+{
+    game_logic_t game;
+    game_logic_init(&game, &ops, NULL, 0xC0FFEE);
+    game_logic_start(&game);
+    match_recorder_state(&game);
+
+    int64_t planned_for = -1; // window_open_us of the ball the swing is planned for
+    int64_t swing_us = -1;
+    int64_t next_flush_us = 1000 * MS;
+
+    while (now_us < MATCH_LIMIT_US && !(wins > 0 && game.state == GAME_STATE_WIN))
+    {
+        now_us += GAME_TICK_MS * MS;
+
+        if (game.window_open_us != planned_for)
+        {
+            planned_for = game.window_open_us;
+            swing_us = plan_swing(&game);
+        }
+        if (swing_us >= 0 && now_us >= swing_us + LATENCY_US)
+        {
+            feed_hit(&game, swing_us);
+            swing_us = -1;
+        }
+
+        // Ticks that change nothing are left out of the record
+        bool due = (now_us >= game_logic_next_due_us(&game));
+        if (due)
+        {
+            match_recorder_tick(now_us);
+        }
+        game_logic_tick(&game, now_us);
+        if (due)
+        {
+            match_recorder_state(&game);
+        }
+
+        if (now_us >= next_flush_us)
+        {
+            match_recorder_flush();
+            next_flush_us += 1000 * MS;
+        }
+    }
+    match_recorder_flush();
+}
+
+// Copy the log with score_1 of the third state record after the start changed
+static bool alter_log(const char *path, const char *altered_path)
+{
+    FILE *in = fopen(path, "r");
+    FILE *out = fopen(altered_path, "w");
+    if (in == NULL || out == NULL)
+    {
+        return false;
+    }
+
+    int states = 0;
+    bool altered = false;
+    char line[512];
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        char *rec = strstr(line, "REC ");
+        char *hex = (rec != NULL) ? strchr(rec + 4, ' ') : NULL;
+        if (hex != NULL && !altered && strncmp(hex + 1 + REC_TYPE_HEX, "05", 2) == 0 && ++states == 4)
+        {
+            char *score = hex + 1 + REC_SCORE_1_HEX;
+            score[0] = (score[0] == '7') ? '6' : '7';
+            altered = true;
+        }
+        fputs(line, out);
+    }
+
+    fclose(in);
+    fclose(out);
+    return altered;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <log> <altered log>\n", argv[0]);
+        return 2;
+    }
+
+    // The recorder logs like the firmware; its output is the monitor log
+    if (freopen(argv[1], "w", stdout) == NULL)
+    {
+        perror(argv[1]);
+        return 2;
+    }
+    play_match();
+    fclose(stdout);
+
+    fprintf(stderr, "played %d, early %d, late %d, wins %d\n", results[GAME_HIT_PLAYED],
+            results[GAME_HIT_EARLY], results[GAME_HIT_LATE], wins);
+    CHECK_EQ(1, wins);
+    CHECK(results[GAME_HIT_PLAYED] > 2 * WIN_SCORE);
+    CHECK(results[GAME_HIT_EARLY] > 0);
+    CHECK(results[GAME_HIT_LATE] > 0);
+    CHECK(alter_log(argv[1], argv[2]));
+    return host_test_failures;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file test_motion_math.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Q16 progress, easing, straight and curved paths of the motion engine
+ */
+
+#include <stdbool.h>
+#include "host_test.h"
+#include "motion_math.h"
+
+#define HALF (MOTION_ONE / 2)
+
+static const motion_profile_t profiles[] = {
+    MOTION_PROFILE_LINEAR,
+    MOTION_PROFILE_EASE_IN,
+    MOTION_PROFILE_EASE_OUT,
+    MOTION_PROFILE_EASE_IN_OUT,
+};
+
+#define PROFILE_COUNT (sizeof(profiles) / sizeof(profiles[0]))
+
+static void test_progress_covers_the_move(void)
+{
+    CHECK_EQ(0, motion_progress(-1000, 20000));
+    CHECK_EQ(0, motion_progress(0, 20000));
+    CHECK_EQ(HALF, motion_progress(10000, 20000));
+    CHECK_EQ(MOTION_ONE, motion_progress(20000, 20000));
+    CHECK_EQ(MOTION_ONE, motion_progress(50000, 20000));
+    CHECK_EQ(MOTION_ONE, motion_progress(0, 0));
+
+    // An hour-long move still resolves its last microsecond
+    CHECK_EQ(MOTION_ONE - 1, motion_progress(3600000000LL - 1, 3600000000u));
+}
+
+static void test_every_profile_starts_and_ends_in_place(void)
+{
+    for (size_t i = 0; i < PROFILE_COUNT; i++)
+    {
+        CHECK_EQ(0, motion_ease(profiles[i], 0));
+        CHECK_EQ(MOTION_ONE, motion_ease(profiles[i], MOTION_ONE));
+    }
+}
+
+static void test_every_profile_moves_forward(void)
+{
+    for (size_t i = 0; i < PROFILE_COUNT; i++)
+    {
+        uint32_t previous = 0;
+        bool forward = true;
+        for (uint32_t t = 0; t <= MOTION_ONE; t++)
+        {
+            uint32_t eased = motion_ease(profiles[i], t);
+            forward = forward && (eased >= previous) && (eased <= MOTION_ONE);
+            previous = eased;
+        }
+        CHECK(forward);
+    }
+}
+
+static void test_profiles_at_half_time(void)
+{
+    CHECK_EQ(HALF, motion_ease(MOTION_PROFILE_LINEAR, HALF));
+    CHECK_EQ(MOTION_ONE / 4, motion_ease(MOTION_PROFILE_EASE_IN, HALF));
+    CHECK_EQ(MOTION_ONE * 3 / 4, motion_ease(MOTION_PROFILE_EASE_OUT, HALF));
+    CHECK_EQ(HALF, motion_ease(MOTION_PROFILE_EASE_IN_OUT, HALF));
+
+    // Smoothstep is symmetric about the middle
+    uint32_t quarter = MOTION_ONE / 4;
+    CHECK_EQ(MOTION_ONE, motion_ease(MOTION_PROFILE_EASE_IN_OUT, quarter) +
+                             motion_ease(MOTION_PROFILE_EASE_IN_OUT, MOTION_ONE - quarter));
+}
+
+static void test_lerp_hits_both_ends(void)
+{
+    CHECK_EQ(1000, motion_lerp(1000, 60000, 0));
+    CHECK_EQ(60000, motion_lerp(1000, 60000, MOTION_ONE));
+    CHECK_EQ(30500, motion_lerp(1000, 60000, HALF));
+
+    CHECK_EQ(60000, motion_lerp(60000, 1000, 0));
+    CHECK_EQ(1000, motion_lerp(60000, 1000, MOTION_ONE));
+    CHECK_EQ(30500, motion_lerp(60000, 1000, HALF));
+
+    CHECK_EQ(UINT16_MAX, motion_lerp(0, UINT16_MAX, MOTION_ONE));
+    CHECK_EQ(0, motion_lerp(UINT16_MAX, 0, MOTION_ONE));
+}
+
+static void test_curve_passes_through_via_halfway(void)
+{
+    static const uint16_t cases[][3] = {
+        {1000, 30000, 60000},
+        {60000, 20000, 1000},
+        {10000, 50000, 10000},
+        {32768, 0, 40000},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        uint16_t from = cases[i][0];
+        uint16_t via = cases[i][1];
+        uint16_t to = cases[i][2];
+        int32_t ctrl = motion_curve_ctrl(from, via, to);
+
+        CHECK_EQ(from, motion_bezier(from, ctrl, to, 0));
+        CHECK_NEAR(via, motion_bezier(from, ctrl, to, HALF), 1);
+        CHECK_EQ(to, motion_bezier(from, ctrl, to, MOTION_ONE));
+    }
+}
+
+static void test_curve_is_clamped_to_the_axis(void)
+{
+    // The control point lies far outside the range, the curve is cut at its ends
+    int32_t high = motion_curve_ctrl(40000, UINT16_MAX, 40000);
+    CHECK(high > UINT16_MAX);
+    CHECK_EQ(UINT16_MAX, motion_bezier(40000, high, 40000, HALF));
+
+    int32_t low = motion_curve_ctrl(20000, 0, 20000);
+    CHECK(low < 0);
+    CHECK_EQ(0, motion_bezier(20000, low, 20000, HALF));
+    CHECK_EQ(20000, motion_bezier(20000, low, 20000, MOTION_ONE));
+}
+
+static void test_straight_curve_matches_lerp(void)
+{
+    // A control point on the line gives the straight path, evenly paced when centred
+    for (uint32_t f = 0; f <= MOTION_ONE; f += MOTION_ONE / 64)
+    {
+        CHECK_NEAR(motion_lerp(2000, 62000, f), motion_bezier(2000, 32000, 62000, f), 1);
+    }
+}
+
+int main(void)
+{
+    RUN_TEST(test_progress_covers_the_move);
+    RUN_TEST(test_every_profile_starts_and_ends_in_place);
+    RUN_TEST(test_every_profile_moves_forward);
+    RUN_TEST(test_profiles_at_half_time);
+    RUN_TEST(test_lerp_hits_both_ends);
+    RUN_TEST(test_curve_passes_through_via_halfway);
+    RUN_TEST(test_curve_is_clamped_to_the_axis);
+    RUN_TEST(test_straight_curve_matches_lerp);
+    return host_test_failures;
+}
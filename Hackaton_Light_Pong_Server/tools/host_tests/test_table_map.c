@@ -0,0 +1,173 @@
+/**
+ * @file test_table_map.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Solving the table homography and aiming with it
+ */
+
+#include <math.h>
+#include "host_test.h"
+#include "table_map.h"
+#include "game_config.h"
+
+/**
+ * @brief Known head over the table: pan/tilt = (a x + b y + c) / (g x + h y + 1)
+ */
+typedef struct
+{
+    double pan[3];
+    double tilt[3];
+    double den[2];
+} head_t;
+
+// Mounted square over the table, looking straight down
+static const head_t overhead = {
+    .pan = {10.0, 0.0, 20000.0},
+    .tilt = {0.0, -8.0, 50000.0},
+    .den = {0.0, 0.0},
+};
+
+// Mounted at the side, rotated and tilted: the far end is foreshortened
+static const head_t side = {
+    .pan = {9.0, 2.5, 15000.0},
+    .tilt = {-1.5, 11.0, 12000.0},
+    .den = {0.00004, 0.00012},
+};
+
+static void head_aim(const head_t *head, int32_t x_mm, int32_t y_mm, double *pan, double *tilt)
+{
+    double den = head->den[0] * x_mm + head->den[1] * y_mm + 1.0;
+    *pan = (head->pan[0] * x_mm + head->pan[1] * y_mm + head->pan[2]) / den;
+    *tilt = (head->tilt[0] * x_mm + head->tilt[1] * y_mm + head->tilt[2]) / den;
+}
+
+static table_map_point_t point_of(const head_t *head, int32_t x_mm, int32_t y_mm)
+{
+    double pan, tilt;
+    head_aim(head, x_mm, y_mm, &pan, &tilt);
+    table_map_point_t point = {
+        .x_mm = x_mm,
+        .y_mm = y_mm,
+        .pan = (uint16_t)lround(pan),
+        .tilt = (uint16_t)lround(tilt)};
+    return point;
+}
+
+static size_t corners_of(const head_t *head, table_map_point_t *points)
+{
+    points[0] = point_of(head, 0, TABLE_Y_TOP);
+    points[1] = point_of(head, TABLE_WIDTH_MM, TABLE_Y_TOP);
+    points[2] = point_of(head, TABLE_WIDTH_MM, TABLE_Y_BOTTOM);
+    points[3] = point_of(head, 0, TABLE_Y_BOTTOM);
+    return 4;
+}
+
+// Aim all over the table and compare with the head, within tolerance units
+static void check_aim(const table_map_t *map, const head_t *head, int tolerance)
+{
+    for (int32_t y = TABLE_Y_TOP; y <= TABLE_Y_BOTTOM; y += TABLE_LENGTH_MM / 8)
+    {
+        for (int32_t x = 0; x <= TABLE_WIDTH_MM; x += TABLE_WIDTH_MM / 8)
+        {
+            double pan, tilt;
+            uint16_t map_pan, map_tilt;
+            head_aim(head, x, y, &pan, &tilt);
+            table_map_to_aim(map, x, y, &map_pan, &map_tilt);
+            CHECK_NEAR(lround(pan), map_pan, tolerance);
+            CHECK_NEAR(lround(tilt), map_tilt, tolerance);
+        }
+    }
+}
+
+static void test_four_corners_of_an_overhead_head(void)
+{
+    table_map_point_t points[TABLE_MAP_MAX_POINTS];
+    size_t count = corners_of(&overhead, points);
+    table_map_t map;
+
+    CHECK_EQ(ESP_OK, table_map_solve(points, count, &map));
+    check_aim(&map, &overhead, 1);
+}
+
+static void test_four_corners_in_perspective(void)
+{
+    table_map_point_t points[TABLE_MAP_MAX_POINTS];
+    size_t count = corners_of(&side, points);
+    table_map_t map;
+
+    CHECK_EQ(ESP_OK, table_map_solve(points, count, &map));
+    check_aim(&map, &side, 2);
+}
+
+static void test_more_points_are_fitted(void)
+{
+    table_map_point_t points[TABLE_MAP_MAX_POINTS];
+    size_t count = corners_of(&side, points);
+
+    // Extra points a few units off, as jogging the beam by hand gives them
+    static const int32_t extra[][2] = {{TABLE_WIDTH_MM / 2, TABLE_LENGTH_MM / 2},
+                                       {TABLE_WIDTH_MM / 4, TABLE_LENGTH_MM / 3},
+                                       {TABLE_WIDTH_MM * 3 / 4, TABLE_LENGTH_MM * 3 / 4},
+                                       {TABLE_WIDTH_MM / 2, TABLE_Y_BOTTOM}};
+    for (size_t i = 0; i < sizeof(extra) / sizeof(extra[0]); i++)
+    {
+        table_map_point_t point = point_of(&side, extra[i][0], extra[i][1]);
+        point.pan += (i % 2) ? 3 : -3;
+        point.tilt += (i % 2) ? -3 : 3;
+        points[count++] = point;
+    }
+
+    table_map_t map;
+    CHECK_EQ(ESP_OK, table_map_solve(points, count, &map));
+    check_aim(&map, &side, 6);
+}
+
+static void test_aim_is_clamped_to_the_axes(void)
+{
+    table_map_point_t points[TABLE_MAP_MAX_POINTS];
+    size_t count = corners_of(&overhead, points);
+    table_map_t map;
+    CHECK_EQ(ESP_OK, table_map_solve(points, count, &map));
+
+    uint16_t pan, tilt;
+    table_map_to_aim(&map, 10 * TABLE_WIDTH_MM, -10 * TABLE_LENGTH_MM, &pan, &tilt);
+    CHECK_EQ(UINT16_MAX, pan);
+    CHECK_EQ(UINT16_MAX, tilt);
+
+    table_map_to_aim(&map, -10 * TABLE_WIDTH_MM, 10 * TABLE_LENGTH_MM, &pan, &tilt);
+    CHECK_EQ(0, pan);
+    CHECK_EQ(0, tilt);
+}
+
+static void test_bad_points_are_refused(void)
+{
+    table_map_point_t points[TABLE_MAP_MAX_POINTS + 1];
+    size_t count = corners_of(&overhead, points);
+    table_map_t map;
+
+    CHECK_EQ(ESP_ERR_INVALID_ARG, table_map_solve(NULL, count, &map));
+    CHECK_EQ(ESP_ERR_INVALID_ARG, table_map_solve(points, count, NULL));
+    CHECK_EQ(ESP_ERR_INVALID_ARG, table_map_solve(points, TABLE_MAP_MIN_POINTS - 1, &map));
+    for (size_t i = count; i <= TABLE_MAP_MAX_POINTS; i++)
+    {
+        points[i] = points[i % 4];
+    }
+    CHECK_EQ(ESP_ERR_INVALID_ARG, table_map_solve(points, TABLE_MAP_MAX_POINTS + 1, &map));
+
+    // All on one line across the table
+    for (size_t i = 0; i < 4; i++)
+    {
+        points[i] = point_of(&overhead, (int32_t)(i * TABLE_WIDTH_MM / 3), TABLE_LENGTH_MM / 2);
+    }
+    CHECK_EQ(ESP_ERR_INVALID_ARG, table_map_solve(points, 4, &map));
+}
+
+int main(void)
+{
+    RUN_TEST(test_four_corners_of_an_overhead_head);
+    RUN_TEST(test_four_corners_in_perspective);
+    RUN_TEST(test_more_points_are_fitted);
+    RUN_TEST(test_aim_is_clamped_to_the_axes);
+    RUN_TEST(test_bad_points_are_refused);
+    return host_test_failures;
+}
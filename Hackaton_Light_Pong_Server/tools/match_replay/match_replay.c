@@ -0,0 +1,396 @@
+/**
+ * @file match_replay.c
+ * @author Matthias Hefel
+ * @date 2026
+ * @brief Replay a recorded match on a host and check it against the recording
+ *
+ * Reads a monitor log, collects the "REC <seq> <hex>" lines written by
+ * match_recorder_flush() and runs them through the game's own game_logic.c
+ * and ball_model.c. The shoot and place operations return the recorded
+ * times, everything else the game decides is compared with the recording:
+ * each shot, serve position, state, score and PRNG state.
+ *
+ * A replay starts at the first record between points and starts over after
+ * a gap in the sequence (lost records, a reboot).
+ *
+ *     match_replay monitor.log
+ *
+ * Exits with 0 if the whole recording replayed identically, 1 on the first
+ * difference, 2 if there was nothing to replay. Both ends must be little
+ * endian, like the ESP32-C3.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "match_recorder.h"
+#include "game_config.h"
+
+_Static_assert(sizeof(match_record_t) == 32, "match_record_t must match the target's layout");
+
+#define LINE_MAX_LENGTH 512
+
+typedef struct
+{
+    uint32_t seq;
+    match_record_t record;
+} entry_t;
+
+typedef struct
+{
+    const entry_t *entries;
+    size_t count;
+    size_t next;    // Next record an operation expects
+    int64_t origin; // Printed times are relative to this
+    bool diverged;
+} replay_t;
+
+static void diverge(replay_t *replay, size_t index, const char *what)
+{
+    if (replay->diverged)
+    {
+        return;
+    }
+    replay->diverged = true;
+
+    if (index < replay->count)
+    {
+        printf("DIVERGED at record %" PRIu32 ": %s\n", replay->entries[index].seq, what);
+    }
+    else
+    {
+        printf("DIVERGED at end of recording: %s\n", what);
+    }
+}
+
+// Next record for an operation, NULL if it is not of the expected type
+static const match_record_t *expect(replay_t *replay, match_record_type_t type, const char *what)
+{
+    if (replay->diverged)
+    {
+        return NULL;
+    }
+    if (replay->next >= replay->count || replay->entries[replay->next].record.type != type)
+    {
+        diverge(replay, replay->next, what);
+        return NULL;
+    }
+    return &replay->entries[replay->next++].record;
+}
+
+static double seconds(const replay_t *replay, int64_t t_us)
+{
+    return (double)(t_us - replay->origin) / 1e6;
+}
+
+static int64_t op_shoot(void *ctx, const ball_shot_t *shot, bool fireball)
+{
+    replay_t *replay = ctx;
+    const match_record_t *record = expect(replay, MATCH_RECORD_SHOT, "game shot, recording did not");
+    if (record == NULL)
+    {
+        return 0;
+    }
+
+    if (record->shot.x_mm != shot->x_mm || record->shot.via_x_mm != shot->via_x_mm ||
+        record->shot.flight_ms != shot->flight_ms || record->arg != fireball)
+    {
+        char what[160];
+        snprintf(what, sizeof(what), "shot to x=%" PRId32 " via %" PRId32 " in %" PRIu32 " ms%s, recorded x=%" PRId32
+                 " via %" PRId32 " in %" PRIu32 " ms%s",
+                 shot->x_mm, shot->via_x_mm, shot->flight_ms, fireball ? " (fireball)" : "",
+                 record->shot.x_mm, record->shot.via_x_mm, record->shot.flight_ms, record->arg ? " (fireball)" : "");
+        diverge(replay, replay->next - 1, what);
+        return 0;
+    }
+
+    printf("%10.3f  shot to x=%" PRId32 " mm via x=%" PRId32 " mm in %" PRIu32 " ms%s\n",
+           seconds(replay, record->t_us), shot->x_mm, shot->via_x_mm, shot->flight_ms,
+           fireball ? ", fireball" : "");
+    return record->t_us;
+}
+
+static int64_t op_place(void *ctx, int32_t x_mm, int32_t y_mm)
+{
+    replay_t *replay = ctx;
+    const match_record_t *record = expect(replay, MATCH_RECORD_PLACE, "game placed the ball, recording did not");
+    if (record == NULL)
+    {
+        return 0;
+    }
+
+    if (record->place.x_mm != x_mm || record->place.y_mm != y_mm)
+    {
+        char what[128];
+        snprintf(what, sizeof(what), "serve at x=%" PRId32 " y=%" PRId32 ", recorded x=%" PRId32 " y=%" PRId32,
+                 x_mm, y_mm, record->place.x_mm, record->place.y_mm);
+        diverge(replay, replay->next - 1, what);
+        return 0;
+    }
+
+    printf("%10.3f  serve position x=%" PRId32 " mm\n", seconds(replay, record->t_us), x_mm);
+    return record->t_us;
+}
+
+static void op_point(void *ctx, uint8_t missed_player)
+{
+    printf("            Player %u missed\n", missed_player);
+}
+
+static void op_win(void *ctx, uint8_t winner)
+{
+    printf("            Player %u wins\n", winner);
+}
+
+static void op_score(void *ctx, const game_score_t *score)
+{
+    printf("            Score %u:%u\n", score->score_1, score->score_2);
+}
+
+static const game_ops_t replay_ops = {
+    .shoot = op_shoot,
+    .place = op_place,
+    .point = op_point,
+    .win = op_win,
+    .score = op_score,
+};
+
+static bool between_points(const match_record_t *record)
+{
+    return record->type == MATCH_RECORD_STATE &&
+           (record->arg == GAME_STATE_SERVE || record->arg == GAME_STATE_POINT || record->arg == GAME_STATE_WIN);
+}
+
+// Every hit and tick is followed by the game's state after it
+static void check_state(replay_t *replay, const game_logic_t *game)
+{
+    const match_record_t *record = expect(replay, MATCH_RECORD_STATE, "recording has no state here");
+    if (record == NULL)
+    {
+        return;
+    }
+
+    if (record->arg != game->state || record->player != game->player || record->t_us != game->window_open_us ||
+        record->state.ball_x_mm != game->ball_x_mm || record->state.random_state != game->random_state ||
+        record->state.score_1 != game->score.score_1 || record->state.score_2 != game->score.score_2)
+    {
+        char what[256];
+        snprintf(what, sizeof(what),
+                 "game %s for P%u, %u:%u, ball x=%" PRId32 ", window %.3f s, prng %08" PRIx32
+                 "; recorded %s for P%u, %u:%u, ball x=%" PRId32 ", window %.3f s, prng %08" PRIx32,
+                 game_logic_state_name(game->state), game->player, game->score.score_1, game->score.score_2,
+                 game->ball_x_mm, seconds(replay, game->window_open_us), game->random_state,
+                 game_logic_state_name((game_state_t)record->arg), record->player, record->state.score_1,
+                 record->state.score_2, record->state.ball_x_mm, seconds(replay, record->t_us),
+                 record->state.random_state);
+        diverge(replay, replay->next - 1, what);
+    }
+}
+
+// Replays entries[start..end), which have consecutive sequence numbers
+static size_t replay_run(const entry_t *entries, size_t start, size_t end, bool *diverged)
+{
+    size_t first = start;
+    while (first < end && !between_points(&entries[first].record))
+    {
+        first++;
+    }
+    if (first == end)
+    {
+        printf("Records %" PRIu32 "-%" PRIu32 ": no point to start from, skipped\n",
+               entries[start].seq, entries[end - 1].seq);
+        return 0;
+    }
+
+    const match_record_t *start_state = &entries[first].record;
+    replay_t replay = {
+        .entries = entries,
+        .count = end,
+        .next = first + 1,
+        .origin = start_state->t_us};
+
+    game_snapshot_t snapshot = {
+        .state = (game_state_t)start_state->arg,
+        .player = start_state->player,
+        .ball_x_mm = start_state->state.ball_x_mm,
+        .serve_from_us = start_state->t_us,
+        .score = {start_state->state.score_1, start_state->state.score_2},
+        .random_state = start_state->state.random_state};
+    game_logic_t game;
+    game_logic_resume(&game, &replay_ops, &replay, &snapshot);
+
+    printf("Record %" PRIu32 ": %s, Player %u to serve, score %u:%u\n", entries[first].seq,
+           game_logic_state_name(game.state), game.player, game.score.score_1, game.score.score_2);
+
+    while (replay.next < end && !replay.diverged)
+    {
+        const match_record_t *record = &entries[replay.next].record;
+        replay.next++;
+        game_state_t before = game.state;
+
+        if (record->type == MATCH_RECORD_HIT)
+        {
+            game_hit_t hit = {
+                .at_us = record->t_us,
+                .swing_us = record->t_us + record->hit.swing_dt_us,
+                .player = record->player,
+                .button = record->arg};
+            memcpy(hit.swing.accel_mg, record->hit.accel_mg, sizeof(hit.swing.accel_mg));
+            memcpy(hit.swing.gyro_dps, record->hit.gyro_dps, sizeof(hit.swing.gyro_dps));
+
+            printf("%10.3f  Player %u %s", seconds(&replay, hit.at_us), hit.player,
+                   (hit.button == BUTTON_FIREBALL) ? "fireball" : "hit");
+            if (game.state == GAME_STATE_IN_FLIGHT || game.state == GAME_STATE_HIT_WINDOW)
+            {
+                printf(", swing %+.0f ms from arrival", (double)(hit.swing_us - game.arrival_us) / 1e3);
+            }
+            printf("\n");
+            game_hit_result_t result = game_logic_hit(&game, &hit, hit.at_us + record->hit.handled_dt_us);
+            printf("            %s\n", game_logic_hit_result_name(result));
+        }
+        else if (record->type == MATCH_RECORD_TICK)
+        {
+            game_logic_tick(&game, record->t_us);
+        }
+        else
+        {
+            char what[64];
+            snprintf(what, sizeof(what), "unexpected record type %u", record->type);
+            diverge(&replay, replay.next - 1, what);
+            break;
+        }
+
+        check_state(&replay, &game);
+        if (game.state != before && !replay.diverged)
+        {
+            printf("            -> %s, waiting for Player %u\n", game_logic_state_name(game.state), game.player);
+        }
+    }
+
+    *diverged = replay.diverged;
+    return replay.next - first;
+}
+
+// Parses "... REC <seq> <64 hex digits>"; other log lines are skipped
+static bool parse_line(const char *line, entry_t *entry)
+{
+    const char *rec = strstr(line, "REC ");
+    if (rec == NULL)
+    {
+        return false;
+    }
+
+    char *hex;
+    unsigned long seq = strtoul(rec + 4, &hex, 10);
+    if (hex == rec + 4 || *hex != ' ')
+    {
+        return false;
+    }
+    hex++;
+
+    uint8_t *bytes = (uint8_t *)&entry->record;
+    for (size_t i = 0; i < sizeof(entry->record); i++)
+    {
+        char pair[3] = {hex[2 * i], hex[2 * i + 1], '\0'};
+        char *pair_end;
+        if (pair[0] == '\0' || pair[1] == '\0')
+        {
+            return false;
+        }
+        bytes[i] = (uint8_t)strtoul(pair, &pair_end, 16);
+        if (pair_end != pair + 2)
+        {
+            return false;
+        }
+    }
+
+    entry->seq = (uint32_t)seq;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <monitor log>\n", argv[0]);
+        return 2;
+    }
+
+    FILE *log = fopen(argv[1], "r");
+    if (log == NULL)
+    {
+        perror(argv[1]);
+        return 2;
+    }
+
+    entry_t *entries = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    char line[LINE_MAX_LENGTH];
+    while (fgets(line, sizeof(line), log) != NULL)
+    {
+        entry_t entry;
+        if (!parse_line(line, &entry))
+        {
+            continue;
+        }
+        if (entry.record.version != MATCH_RECORD_VERSION)
+        {
+            fprintf(stderr, "Record %" PRIu32 " has version %u, this tool reads %d\n", entry.seq,
+                    entry.record.version, MATCH_RECORD_VERSION);
+            fclose(log);
+            free(entries);
+            return 2;
+        }
+
+        if (count == capacity)
+        {
+            capacity = (capacity == 0) ? 1024 : capacity * 2;
+            entry_t *grown = realloc(entries, capacity * sizeof(entry_t));
+            if (grown == NULL)
+            {
+                perror("realloc");
+                fclose(log);
+                free(entries);
+                return 2;
+            }
+            entries = grown;
+        }
+        entries[count++] = entry;
+    }
+    fclose(log);
+
+    // Runs of consecutive records are replayed one after another
+    size_t replayed = 0;
+    bool diverged = false;
+    size_t start = 0;
+    while (start < count && !diverged)
+    {
+        size_t end = start + 1;
+        while (end < count && entries[end].seq == entries[end - 1].seq + 1)
+        {
+            end++;
+        }
+        if (end < count)
+        {
+            printf("Gap after record %" PRIu32 ", next is %" PRIu32 "\n", entries[end - 1].seq, entries[end].seq);
+        }
+
+        replayed += replay_run(entries, start, end, &diverged);
+        start = end;
+    }
+    free(entries);
+
+    if (diverged)
+    {
+        return 1;
+    }
+    if (replayed == 0)
+    {
+        printf("Nothing to replay\n");
+        return 2;
+    }
+    printf("Replayed %zu records, identical to the recording\n", replayed);
+    return 0;
+}